@@ -2,6 +2,7 @@
 #include "../Core/Constants.h"
 #include "../Core/Exceptions.h"
 
+#include <algorithm>
 #include <map>
 
 using namespace std;
@@ -115,10 +116,24 @@ GLboolean BSplineCurve3::CalculateDerivatives(GLuint max_order_of_derivatives, G
         return GL_FALSE;
     }
 
+    GLuint k = _kv->GetOrder();
+
+    // the derivatives of order at least k vanish, the others are evaluated without heap allocations up to order
+    // KnotVector::MAXIMUM_FIXED_ORDER: dN[r * k + jj] = d^r/du^r N_{i - k + 1 + jj}^{k}(u)
+    GLuint           order_count = min(max_order_of_derivatives + 1, k);
+    GLdouble         fixed_storage[KnotVector::MAXIMUM_FIXED_ORDER * KnotVector::MAXIMUM_FIXED_ORDER];
+    vector<GLdouble> storage;
+    GLdouble         *dN = fixed_storage;
+
+    if (k > KnotVector::MAXIMUM_FIXED_ORDER)
+    {
+        storage.resize(order_count * k);
+        dN = storage.data();
+    }
+
     GLuint i;
-    TriangularMatrix<GLdouble> N;
 
-    if (!_kv->EvaluateNonZeroBSplineFunctions(u, i, N))
+    if (!_kv->NonZeroDerivatives(order_count - 1, u, i, dN))
     {
         d.ResizeRows(0);
         return GL_FALSE;
@@ -127,48 +142,16 @@ GLboolean BSplineCurve3::CalculateDerivatives(GLuint max_order_of_derivatives, G
     d.ResizeRows(max_order_of_derivatives + 1);
     d.LoadNullVectors();
 
-    GLuint k                    =   _kv->GetOrder();
-    GLuint offset               =   i - k + 1;
-    ColumnMatrix<DCoordinate3>      clone(k);
-
-    for (GLuint j = offset; j <= i; ++j)
-    {
-        GLuint index = j - offset;
-        GLuint cp_index = j % (_n + 1);
-
-        d[0] += _data[cp_index] * N(k - 1, index);
-
-        clone[index] = _data[cp_index];
-    }
+    GLuint offset = i - k + 1;
 
-    for (GLuint r = 1; r <= min(max_order_of_derivatives, k - 1); r++)
+    for (GLuint jj = 0; jj < k; jj++)
     {
-        ColumnMatrix<DCoordinate3> dcp(k - r);
+        const DCoordinate3 &cp = _data[(offset + jj) % (_n + 1)];
 
-        GLuint roffset = offset + r;
-
-        for (GLuint j = roffset; j <= i; j++)
+        for (GLuint r = 0; r < order_count; r++)
         {
-            GLdouble denominator = (*_kv)[j + k - r] - (*_kv)[j];
-
-            GLuint rindex = j - roffset;
-
-            if (denominator)
-            {
-                dcp[rindex]  = clone[rindex + 1];
-                dcp[rindex] -= clone[rindex];
-                dcp[rindex] /= denominator;
-                d[r] += dcp[rindex] * N(k - 1 - r, rindex);
-            }
+            d[r] += cp * dN[r * k + jj];
         }
-        clone = dcp;
-    }
-
-    GLdouble factor = 1.0;
-    for (GLuint r = 1; r < d.GetRowCount(); r++)
-    {
-        factor *= (k - r);
-        d[r] *= factor;
     }
 
     return GL_TRUE;
@@ -1,6 +1,8 @@
 #include "../B-spline/BSplinePatches3.h"
 #include "../Core/Constants.h"
 
+#include <algorithm>
+
 using namespace std;
 namespace cagd
 {
@@ -124,15 +126,35 @@ GLboolean BSplinePatch3::CalculatePartialDerivatives(
         GLuint maximum_order_of_partial_derivatives,
         GLdouble u, GLdouble v, PartialDerivatives &pd) const
 {
-    Matrix<GLdouble> u_dN, v_dN;
-    GLuint i, j;
-    if(!_u_kv->FindSpan(u, i) || !_v_kv->FindSpan(v, j))
+    GLuint k = _u_kv->GetOrder();
+    GLuint l = _v_kv->GetOrder();
+
+    // the derivatives of order at least k (or l) vanish, the others are evaluated without heap allocations up to order
+    // KnotVector::MAXIMUM_FIXED_ORDER: u_dN[r * k + p] = d^r/du^r N_{i - k + 1 + p}^{k}(u), v_dN[r * l + q] = d^r/dv^r N_{j - l + 1 + q}^{l}(v)
+    GLuint u_order_count = min(maximum_order_of_partial_derivatives + 1, k);
+    GLuint v_order_count = min(maximum_order_of_partial_derivatives + 1, l);
+
+    GLdouble         u_fixed_storage[KnotVector::MAXIMUM_FIXED_ORDER * KnotVector::MAXIMUM_FIXED_ORDER];
+    GLdouble         v_fixed_storage[KnotVector::MAXIMUM_FIXED_ORDER * KnotVector::MAXIMUM_FIXED_ORDER];
+    vector<GLdouble> u_storage, v_storage;
+    GLdouble         *u_dN = u_fixed_storage, *v_dN = v_fixed_storage;
+
+    if (k > KnotVector::MAXIMUM_FIXED_ORDER)
     {
-        pd.ResizeRows(0);
-        return GL_FALSE;
+        u_storage.resize(u_order_count * k);
+        u_dN = u_storage.data();
+    }
+
+    if (l > KnotVector::MAXIMUM_FIXED_ORDER)
+    {
+        v_storage.resize(v_order_count * l);
+        v_dN = v_storage.data();
     }
-    if (!_u_kv->ZerothAndHigherOrderDerivative(maximum_order_of_partial_derivatives, u, u_dN) ||
-            !_v_kv->ZerothAndHigherOrderDerivative(maximum_order_of_partial_derivatives, v, v_dN))
+
+    GLuint i, j;
+
+    if (!_u_kv->NonZeroDerivatives(u_order_count - 1, u, i, u_dN) ||
+            !_v_kv->NonZeroDerivatives(v_order_count - 1, v, j, v_dN))
     {
         pd.ResizeRows(0);
         return GL_FALSE;
@@ -141,23 +163,26 @@ GLboolean BSplinePatch3::CalculatePartialDerivatives(
     pd.ResizeRows(maximum_order_of_partial_derivatives + 1);
     pd.LoadNullVectors();
 
-    GLuint k = _u_kv->GetOrder();
-    GLuint l = _v_kv->GetOrder();
-    GLdouble offset_u = i - k + 1;
-    GLdouble offset_v = j - l + 1;
+    GLuint offset_u = i - k + 1;
+    GLuint offset_v = j - l + 1;
 
     for (GLuint ro = 0; ro <= maximum_order_of_partial_derivatives; ro++)
     {
         for (GLuint r = 0; r <= ro; r++)
         {
-            for (GLint p = static_cast<GLint> (offset_u); p <= static_cast<GLint> (i); p++)
+            if (r >= v_order_count || ro - r >= u_order_count)
+            {
+                continue;
+            }
+
+            for (GLuint p = 0; p < k; p++)
             {
                 DCoordinate3 aux;
-                for (GLuint q = offset_v; q <= j; q++)
+                for (GLuint q = 0; q < l; q++)
                 {
-                    aux += _data(p % (_u_n + 1), q % (_v_n + 1)) * v_dN(r, q);
+                    aux += _data((offset_u + p) % (_u_n + 1), (offset_v + q) % (_v_n + 1)) * v_dN[r * l + q];
                 }
-                pd(ro, r) += aux * u_dN(ro - r, p);
+                pd(ro, r) += aux * u_dN[(ro - r) * k + p];
             }
         }
     }
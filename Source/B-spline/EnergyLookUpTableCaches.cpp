@@ -0,0 +1,172 @@
+#include "EnergyLookUpTableCaches.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+namespace cagd
+{
+const size_t EnergyLookUpTableCache::DEFAULT_BYTE_BUDGET = 64 * 1024 * 1024;
+
+struct EnergyLookUpTableCacheEntry
+{
+    EnergyLookUpTableCache::Key                         key;
+    shared_ptr<const EnergyLookUpTableCache::Tables>    tables;
+    size_t                                              byte_count;
+};
+
+typedef list<EnergyLookUpTableCacheEntry> EnergyLookUpTableCacheList;
+
+// the front of the list is the most recently used entry
+static mutex                                                                    energy_look_up_table_cache_mutex;
+static EnergyLookUpTableCacheList                                               energy_look_up_table_cache_entries;
+static map<EnergyLookUpTableCache::Key, EnergyLookUpTableCacheList::iterator>   energy_look_up_table_cache_index;
+static size_t                                                                   energy_look_up_table_cache_byte_count = 0;
+static size_t                                                                   energy_look_up_table_cache_byte_budget = EnergyLookUpTableCache::DEFAULT_BYTE_BUDGET;
+static unsigned long long                                                       energy_look_up_table_cache_hit_count = 0;
+static unsigned long long                                                       energy_look_up_table_cache_miss_count = 0;
+
+static size_t ByteCount(const EnergyLookUpTableCache::Key& key, const EnergyLookUpTableCache::Tables& tables)
+{
+    size_t result = sizeof(EnergyLookUpTableCacheEntry) + key.size() * sizeof(GLdouble);
+
+    for (const BandedSPDMatrix& table: tables)
+    {
+        result += sizeof(BandedSPDMatrix) + static_cast<size_t>(table.GetSize()) * (table.GetHalfBandwidth() + 1) * sizeof(GLdouble);
+    }
+
+    return result;
+}
+
+// the mutex has to be locked by the caller
+static GLvoid EvictEntriesThatDoNotFitIntoTheByteBudget()
+{
+    while (energy_look_up_table_cache_byte_count > energy_look_up_table_cache_byte_budget &&
+           !energy_look_up_table_cache_entries.empty())
+    {
+        EnergyLookUpTableCacheEntry &last = energy_look_up_table_cache_entries.back();
+
+        energy_look_up_table_cache_byte_count -= last.byte_count;
+        energy_look_up_table_cache_index.erase(last.key);
+        energy_look_up_table_cache_entries.pop_back();
+    }
+}
+
+shared_ptr<const EnergyLookUpTableCache::Tables> EnergyLookUpTableCache::Find(const Key& key)
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    auto position = energy_look_up_table_cache_index.find(key);
+
+    if (position == energy_look_up_table_cache_index.end())
+    {
+        energy_look_up_table_cache_miss_count++;
+        return nullptr;
+    }
+
+    energy_look_up_table_cache_hit_count++;
+
+    // moves the entry to the front of the list, the iterators remain valid
+    energy_look_up_table_cache_entries.splice(energy_look_up_table_cache_entries.begin(),
+                                              energy_look_up_table_cache_entries, position->second);
+
+    return position->second->tables;
+}
+
+GLvoid EnergyLookUpTableCache::Insert(const Key& key, const shared_ptr<const Tables>& tables)
+{
+    if (!tables)
+        return;
+
+    size_t byte_count = ByteCount(key, *tables);
+
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    // another thread may have inserted the same tables in the meantime
+    auto position = energy_look_up_table_cache_index.find(key);
+
+    if (position != energy_look_up_table_cache_index.end())
+    {
+        energy_look_up_table_cache_byte_count -= position->second->byte_count;
+        energy_look_up_table_cache_entries.erase(position->second);
+        energy_look_up_table_cache_index.erase(position);
+    }
+
+    if (byte_count > energy_look_up_table_cache_byte_budget)
+        return;
+
+    EnergyLookUpTableCacheEntry entry;
+    entry.key        = key;
+    entry.tables     = tables;
+    entry.byte_count = byte_count;
+
+    energy_look_up_table_cache_entries.push_front(entry);
+    energy_look_up_table_cache_index[key] = energy_look_up_table_cache_entries.begin();
+    energy_look_up_table_cache_byte_count += byte_count;
+
+    EvictEntriesThatDoNotFitIntoTheByteBudget();
+}
+
+GLvoid EnergyLookUpTableCache::Clear()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    energy_look_up_table_cache_entries.clear();
+    energy_look_up_table_cache_index.clear();
+    energy_look_up_table_cache_byte_count = 0;
+}
+
+GLvoid EnergyLookUpTableCache::SetByteBudget(size_t byte_budget)
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    energy_look_up_table_cache_byte_budget = byte_budget;
+
+    EvictEntriesThatDoNotFitIntoTheByteBudget();
+}
+
+size_t EnergyLookUpTableCache::GetByteBudget()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    return energy_look_up_table_cache_byte_budget;
+}
+
+size_t EnergyLookUpTableCache::GetEntryCount()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    return energy_look_up_table_cache_entries.size();
+}
+
+size_t EnergyLookUpTableCache::GetByteCount()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    return energy_look_up_table_cache_byte_count;
+}
+
+unsigned long long EnergyLookUpTableCache::GetHitCount()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    return energy_look_up_table_cache_hit_count;
+}
+
+unsigned long long EnergyLookUpTableCache::GetMissCount()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    return energy_look_up_table_cache_miss_count;
+}
+
+GLvoid EnergyLookUpTableCache::ResetCounters()
+{
+    lock_guard<mutex> lock(energy_look_up_table_cache_mutex);
+
+    energy_look_up_table_cache_hit_count  = 0;
+    energy_look_up_table_cache_miss_count = 0;
+}
+}
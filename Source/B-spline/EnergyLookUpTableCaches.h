@@ -0,0 +1,58 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <Core/BandedSPDMatrices.h>
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // Process-wide memoisation of the unweighted energy look-up tables of knot
+    // vectors (see KnotVector::GenerateAllLookUpTablesUpToADifferentiationOrder).
+    //
+    // The tables depend only on the knot vector (type, order, definition domain
+    // and knot values) and on the numerical integration method, thus they are
+    // identified by a sequence of reals that is determined by the knot vector.
+    // The weights of the energy terms only scale the cached tables, therefore
+    // moving a weight slider does not trigger a new integration.
+    //
+    // The entries are shared, immutable objects that are evicted in least
+    // recently used order as soon as their total size exceeds the byte budget.
+    // A byte budget of zero disables the cache. All methods are thread-safe.
+    //--------------------------------------------------------------------------
+    class EnergyLookUpTableCache
+    {
+    public:
+        typedef std::vector<GLdouble>               Key;
+        typedef std::vector<BandedSPDMatrix>        Tables;
+
+        // default settings
+        static const std::size_t DEFAULT_BYTE_BUDGET;
+
+        // returns the tables that belong to the key and marks them as the most recently used ones,
+        // or a null pointer if they are not cached
+        static std::shared_ptr<const Tables> Find(const Key& key);
+
+        // stores the tables as the most recently used ones (unless they alone exceed the byte budget)
+        // and evicts the least recently used entries that do not fit into the byte budget
+        static GLvoid Insert(const Key& key, const std::shared_ptr<const Tables>& tables);
+
+        // removes all entries
+        static GLvoid Clear();
+
+        // upper bound for the total size of the cached tables
+        static GLvoid SetByteBudget(std::size_t byte_budget);
+        static std::size_t GetByteBudget();
+
+        // current number and total size of the cached entries
+        static std::size_t GetEntryCount();
+        static std::size_t GetByteCount();
+
+        // statistics of the lookups since the start or the last reset of the counters
+        static unsigned long long GetHitCount();
+        static unsigned long long GetMissCount();
+        static GLvoid ResetCounters();
+    };
+}
@@ -1,4 +1,22 @@
 #include "KnotVectors.h"
+#include "../Core/Constants.h"
+#include "../Core/MatrixProducts.h"
+#include "../Core/ParallelExecutionPolicies.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CAGD_X86_BASIS_KERNELS
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CAGD_TARGET(instruction_sets) __attribute__((target(instruction_sets)))
+#else
+#define CAGD_TARGET(instruction_sets)
+#endif
 
 using namespace std;
 using namespace cagd;
@@ -7,6 +25,9 @@ using namespace cagd;
 // implementation of class KnotVector
 //--------------------------------------
 
+const GLuint KnotVector::MAXIMUM_FIXED_ORDER;
+const GLuint KnotVector::INVALID_SPAN = numeric_limits<GLuint>::max();
+
 // special constructor
 KnotVector::KnotVector(Type type, GLuint k, GLuint n, GLdouble u_min, GLdouble u_max)
 {
@@ -65,6 +86,38 @@ KnotVector::KnotVector(Type type, GLuint k, GLuint n, GLdouble u_min, GLdouble u
 
         break;
     }
+
+    _DetectUniformSpacing();
+}
+
+GLvoid KnotVector::_DetectUniformSpacing()
+{
+    _uniform_step = _inverse_uniform_step = _uniform_tolerance = 0.0;
+
+    GLuint first = _order - 1, last = _control_point_count;
+
+    if (_control_point_count <= 1 || _knots.GetColumnCount() < _control_point_count + _order || _knots[last] <= _knots[first])
+    {
+        return;
+    }
+
+    GLdouble step = (_knots[last] - _knots[first]) / (last - first);
+
+    // the knots have been generated by the expressions u_min + (r - offset) * step
+    GLdouble tolerance = 16.0 * numeric_limits<GLdouble>::epsilon() *
+            (max(fabs(_knots[0]), fabs(_knots[_knots.GetColumnCount() - 1])) + (_knots[last] - _knots[first]));
+
+    for (GLuint r = first + 1; r < last; r++)
+    {
+        if (fabs(_knots[r] - _knots[first] - (r - first) * step) > tolerance)
+        {
+            return;
+        }
+    }
+
+    _uniform_step         = step;
+    _inverse_uniform_step = 1.0 / step;
+    _uniform_tolerance    = tolerance;
 }
 
 // get knot value by value
@@ -87,12 +140,42 @@ GLboolean KnotVector::FindSpan(GLdouble u, GLuint& i) const
         return GL_FALSE;
     }
 
-    if (u == _knots[_control_point_count])
+    // due to rounding errors the knots u_{k-1} and u_{n+1} (u_{n+k} in the periodic case) may slightly differ
+    // from the ends of the definition domain, the values outside [u_{k-1}, u_{n+1}) belong to the first or last span
+    if (u >= _knots[_control_point_count])
     {
         i = _control_point_count - 1;
         return GL_TRUE;
     }
 
+    if (u < _knots[_order - 1])
+    {
+        i = _order - 1;
+        return GL_TRUE;
+    }
+
+    // in the uniform case the rounding errors of the quotient may only shift the span by one
+    if (_uniform_step > 0.0)
+    {
+        GLdouble position = floor((u - _knots[_order - 1]) * _inverse_uniform_step);
+
+        i = _order - 1 + static_cast<GLuint>(min(max(position, 0.0), static_cast<GLdouble>(_control_point_count - _order)));
+
+        if (u < _knots[i] && i > _order - 1)
+        {
+            i--;
+        }
+        else if (u >= _knots[i + 1] && i + 1 < _control_point_count)
+        {
+            i++;
+        }
+
+        if (_knots[i] <= u && u < _knots[i + 1])
+        {
+            return GL_TRUE;
+        }
+    }
+
     GLuint left  = _order - 1;
     GLuint right = _control_point_count;
 
@@ -112,290 +195,1628 @@ GLboolean KnotVector::FindSpan(GLdouble u, GLuint& i) const
 
 }
 
-// evaluates non-vanishing normalized B-spline function values in a lower triangular matrix of the form
-// N[row - 1][column] = N_{span - row + column + 1}^{row}, row = 1, ..., order, column = 0, 1, ..., row - 1
-GLboolean KnotVector::EvaluateNonZeroBSplineFunctions(GLdouble u, GLuint& i, TriangularMatrix<GLdouble>& N) const
+// the span of a parameter value that is not smaller than the one of the previous span is the last span
+// [u_{i}, u_{i + 1}) that starts at or before it, thus the walk is only a few steps long for dense sorted samples
+GLboolean KnotVector::_FindSpanStartingFrom(GLdouble u, GLuint previous_span, GLuint& i) const
 {
-    if (!FindSpan(u, i))
+    if (u < _u_min || u > _u_max || previous_span < _order - 1 || previous_span >= _control_point_count)
     {
         return GL_FALSE;
     }
 
-    N.ResizeRows(_order);
+    i = previous_span;
 
-    N(0, 0) = 1.0; // N_{i}^{1}(u)
+    while (i + 1 < _control_point_count && u >= _knots[i + 1])
+    {
+        i++;
+    }
 
-    GLdouble left, right;
-    // k >= 2
-    // N_{i}^{k}(u) = \frac{u - u_{i}}{u_{i+k-1} - u_{i}}N_{i}^{k-1}(u) + \frac{u_{i+k} - u}{u_{i+k} - u_{i+1}}N_{i+1}^{k-1}(u)
-    // N_{j}^{k}(u), j = i-k+1, i-k+2, ..., i
-    for (GLuint k = 2; k <= _order; ++k)
+    return GL_TRUE;
+}
+
+// Cox-de Boor recursion of a fixed order K over the non-empty span [u_{i}, u_{i+1}), the values are stored in
+// the packed triangular array N[(r - 1) * r / 2 + c] = N_{i - r + c + 1}^{r}, r = 1, ..., K, c = 0, ..., r - 1.
+// The differences left[j] = u - u_{i+1-j} and right[j] = u_{i+j} - u are shared by the consecutive orders, so that
+// the order r + 1 requires only r divisions. Each denominator right[c + 1] + left[r - c] = u_{i+c+1} - u_{i+1-r+c}
+// is the length of an interval that contains the span, i.e., none of them vanishes, while the loops of
+// compile-time length are completely unrolled.
+template <GLuint K>
+static inline GLvoid EvaluateNonZeroBSplineFunctionsOfFixedOrder(const GLdouble *knots, GLuint i, GLdouble u, GLdouble *N)
+{
+    GLdouble left[K], right[K];
+
+    N[0] = 1.0;
+
+    for (GLuint r = 1; r < K; r++)
     {
-        // j = i - k + 1
-        right = _knots[i + 1] - _knots[i - k + 2];
-        N(k - 1, 0) = (right > 0.0) ? N(k - 2, 0) * (_knots[i + 1] - u) / right : 0.0;
+        left[r]  = u - knots[i + 1 - r];
+        right[r] = knots[i + r] - u;
 
-        // j = i
-        left = _knots[i + k - 1] - _knots[i];
-        N(k - 1, k - 1) = (left > 0.0) ? N(k - 2, k - 2) * (u - _knots[i]) / left : 0.0;
+        const GLdouble *previous = N + (r - 1) * r / 2;     // order r
+        GLdouble       *current  = N + r * (r + 1) / 2;     // order r + 1
 
-        // j = i - k + 2, ..., i - 1
-        GLuint offset = i - k + 1;
+        GLdouble saved = 0.0;
 
-        for (GLuint j = i - k + 2; j <= i - 1; j++)
+        for (GLuint c = 0; c < r; c++)
         {
-            left  = _knots[j + k - 1] - _knots[j];
-            right = _knots[j + k] - _knots[j + 1];
+            GLdouble temp = previous[c] / (right[c + 1] + left[r - c]);
 
-            N(k - 1, j - offset) =
-                    ((left  > 0.0) ? N(k - 2, j - offset - 1) * (u - _knots[j]) / left : 0.0) +
-                    ((right > 0.0) ? N(k - 2, j - offset) * (_knots[j + k] - u) / right : 0.0);
+            current[c] = saved + right[c + 1] * temp;
+            saved      = left[r - c] * temp;
         }
-    }
 
-    return GL_TRUE;
+        current[r] = saved;
+    }
 }
 
-// getters
-KnotVector::Type KnotVector::GetType() const
+// Cox-de Boor recursion of an arbitrary order k, zero denominators belong to vanishing terms
+static GLvoid EvaluateNonZeroBSplineFunctionsOfArbitraryOrder(const GLdouble *knots, GLuint k, GLuint i, GLdouble u, GLdouble *N)
 {
-    return _type;
-}
+    N[0] = 1.0; // N_{i}^{1}(u)
 
-GLuint KnotVector::GetOrder() const
-{
-    return _order;
-}
+    GLdouble left, right;
+    // r >= 2
+    // N_{j}^{r}(u) = \frac{u - u_{j}}{u_{j+r-1} - u_{j}}N_{j}^{r-1}(u) + \frac{u_{j+r} - u}{u_{j+r} - u_{j+1}}N_{j+1}^{r-1}(u)
+    // N_{j}^{r}(u), j = i-r+1, i-r+2, ..., i
+    for (GLuint r = 2; r <= k; r++)
+    {
+        const GLdouble *previous = N + (r - 2) * (r - 1) / 2;
+        GLdouble       *current  = N + (r - 1) * r / 2;
 
-GLuint KnotVector::GetControlPointCount() const
-{
-    return _control_point_count;
-}
+        // j = i - r + 1
+        right = knots[i + 1] - knots[i - r + 2];
+        current[0] = (right > 0.0) ? previous[0] * (knots[i + 1] - u) / right : 0.0;
 
-GLdouble KnotVector::GetMin() const
-{
-    return _u_min;
-}
+        // j = i
+        left = knots[i + r - 1] - knots[i];
+        current[r - 1] = (left > 0.0) ? previous[r - 2] * (u - knots[i]) / left : 0.0;
 
-GLdouble KnotVector::GetMax() const
-{
-    return _u_max;
+        // j = i - r + 2, ..., i - 1
+        GLuint offset = i - r + 1;
+
+        for (GLuint j = i - r + 2; j <= i - 1; j++)
+        {
+            left  = knots[j + r - 1] - knots[j];
+            right = knots[j + r] - knots[j + 1];
+
+            current[j - offset] =
+                    ((left  > 0.0) ? previous[j - offset - 1] * (u - knots[j]) / left : 0.0) +
+                    ((right > 0.0) ? previous[j - offset] * (knots[j + r] - u) / right : 0.0);
+        }
+    }
 }
 
-GLuint KnotVector::GetN() const
+// Over a span [u_{i}, u_{i} + h) of equally spaced knots u_{i+j} = u_{i} + j * h, the non-vanishing B-spline functions of order K
+// are the polynomials N_{i-K+1+jj}^{K}(u_{i} + t * h) = sum_{m = 0}^{K - 1} M(jj, m) * t^m, t in [0, 1), of a constant basis matrix M
+// that does not depend on the span. The r-th derivatives are the polynomials h^{-r} * sum_{m} D_{r}(jj, m) * t^m, where
+// D_{r}(jj, m) = (m + r)! / m! * M(jj, m + r). The matrices are determined once by the Cox-de Boor recursion of polynomials
+// over the local knots -(K - 1), ..., K, where the denominators are the orders of the previous functions.
+class UniformBasisMatrices
 {
-    return _type == KnotVector::PERIODIC ? _control_point_count - _order : _control_point_count - 1;
-}
+public:
+    static const GLuint MAXIMUM_ORDER = KnotVector::MAXIMUM_FIXED_ORDER;
 
-std::ostream& cagd::operator << (std::ostream& lhs, const KnotVector& rhs)
+private:
+    // _D[K][r][m][jj] = D_{r}(jj, m) of order K, i.e., the coefficients of t^m are contiguous, so that the Horner schemes
+    // of the K functions advance simultaneously
+    GLdouble _D[MAXIMUM_ORDER + 1][MAXIMUM_ORDER][MAXIMUM_ORDER][MAXIMUM_ORDER];
+
+public:
+    UniformBasisMatrices()
+    {
+        fill(&_D[0][0][0][0], &_D[0][0][0][0] + sizeof(_D) / sizeof(GLdouble), 0.0);
+
+        for (GLuint K = 1; K <= MAXIMUM_ORDER; K++)
+        {
+            // N[c][m] is the coefficient of t^m of the c-th function of the current order
+            GLdouble N[MAXIMUM_ORDER][MAXIMUM_ORDER] = {{0.0}};
+
+            N[0][0] = 1.0;
+
+            for (GLuint r = 1; r < K; r++)
+            {
+                // left[j] = t + j - 1, right[j] = j - t
+                GLdouble saved[MAXIMUM_ORDER] = {0.0};
+
+                for (GLuint c = 0; c < r; c++)
+                {
+                    GLdouble temp[MAXIMUM_ORDER], current[MAXIMUM_ORDER] = {0.0}, next_saved[MAXIMUM_ORDER] = {0.0};
+
+                    for (GLuint m = 0; m < r; m++)
+                    {
+                        temp[m] = N[c][m] / r;
+                    }
+
+                    for (GLuint m = 0; m < r; m++)
+                    {
+                        current[m]        += (c + 1.0) * temp[m];
+                        current[m + 1]    -= temp[m];
+                        next_saved[m]     += (r - c - 1.0) * temp[m];
+                        next_saved[m + 1] += temp[m];
+                    }
+
+                    for (GLuint m = 0; m <= r; m++)
+                    {
+                        N[c][m]  = saved[m] + current[m];
+                        saved[m] = next_saved[m];
+                    }
+                }
+
+                copy(saved, saved + r + 1, N[r]);
+            }
+
+            for (GLuint r = 0; r < K; r++)
+            {
+                for (GLuint jj = 0; jj < K; jj++)
+                {
+                    for (GLuint m = 0; m + r < K; m++)
+                    {
+                        GLdouble factor = 1.0;
+
+                        for (GLuint l = m + 1; l <= m + r; l++)
+                        {
+                            factor *= l;
+                        }
+
+                        _D[K][r][m][jj] = factor * N[jj][m + r];
+                    }
+                }
+            }
+        }
+    }
+
+    // D_{r}(0, m), ..., D_{r}(K - 1, m) of order K
+    const GLdouble* operator ()(GLuint K, GLuint r, GLuint m) const
+    {
+        return _D[K][r][m];
+    }
+};
+
+static const UniformBasisMatrices& UniformBasis()
 {
-    lhs << rhs._knots;
-    return lhs;
+    static const UniformBasisMatrices matrices;
+    return matrices;
 }
 
-GLboolean KnotVector::ZerothAndHigherOrderDerivative(GLuint maximum_order_of_derivatives, GLdouble u, Matrix<GLdouble> &dN) const
+GLboolean KnotVector::_IsUniformSpan(GLuint i) const
 {
-    GLuint k = _order;              // order
-    GLuint i;                       // span: [u_{i}, u_{i+1})
-    TriangularMatrix<GLdouble> N;   // non-vanishing normalized B-spline basis functions of order 1,...,k
+    GLuint k = _order;
 
-    if (!EvaluateNonZeroBSplineFunctions(u, i, N))
+    if (_uniform_step <= 0.0 || k > MAXIMUM_FIXED_ORDER || i + 1 < k || i + k >= _knots.GetColumnCount())
     {
-        dN.ResizeColumns(0);
-        dN.ResizeRows(0);
         return GL_FALSE;
     }
 
-    // resizing the output matrix dN
-    dN.ResizeRows(maximum_order_of_derivatives + 1);
-    dN.ResizeColumns(_control_point_count);
+    const GLdouble *knots = _knots.GetRowPointer(0) + i;
 
-    // storing initial zeros
-    for(GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+    for (GLint j = 1 - static_cast<GLint>(k); j <= static_cast<GLint>(k); j++)
     {
-        for(GLuint j = 0; j < _control_point_count; j++)
+        if (fabs(knots[j] - knots[0] - j * _uniform_step) > _uniform_tolerance)
         {
-            dN(r, j) = 0.0;
+            return GL_FALSE;
         }
     }
-    // storing the zeroth order derivatives of the non-vanishing B-spline basis functions
-    GLuint offset_0 = i - k + 1;
-    for (GLuint j = offset_0; j <= i; j++)
-    {
-        dN(0, j) = N(k - 1, j - offset_0);
-    }
 
-    // the triangular matrix a[j] is associated with the non-vanishing B-spline function N_{j}^{k}
-    vector< TriangularMatrix<GLdouble> > a(k, TriangularMatrix<GLdouble>(maximum_order_of_derivatives + 1));
-
-    for (GLuint j = offset_0; j <= i; j++)
-    {
-        a[j - offset_0](0, 0) = 1.0;
-    }
+    return GL_TRUE;
+}
 
-    // the variable factor will store the value (k-1)! / (k - 1 -r)! = (k-1)(k-2)...(k-r)
-    // for each differentiation order r = 0,...,maximum_order_of_derivatives
+// Horner schemes of the polynomials of the uniform basis matrices of order K at t, where scale = h^{-1}
+template <GLuint K>
+static inline GLvoid UniformNonZeroDerivativesOfFixedOrder(const UniformBasisMatrices &D, GLdouble t, GLdouble scale, GLuint n, GLdouble *dN)
+{
     GLdouble factor = 1.0;
 
-    // if the differentiation order r is bigger than k - 1, then d^r/du^r N_{j}^{k}(u) = 0 for all u
-    for (GLuint r = 1; r <= min(maximum_order_of_derivatives, k - 1); r++)
+    for (GLuint r = 0; r <= n; r++)
     {
-        // updating the value of the variable factor
-        factor *= (k - r);
+        GLuint   degree = K - 1 - r;
+        GLdouble value[K];
 
-        // offset parameter associated with the differentiation order r: (i - k + 1) + r
-        GLuint offset_r = offset_0 + r;
+        const GLdouble *leading = D(K, r, degree);
 
-        // we only evaluate the derivatives of the non-vanishing normalized B-spline Basis functions
-        for (GLuint j = offset_0; j <= i; j++)
+        for (GLuint jj = 0; jj < K; jj++)
         {
-            // we determine the r-th row of the triangular matrix a[jj], where jj = j - offset_0
-            GLuint jj = j - offset_0;
-            for (GLuint l = 0; l <= r; l++)
-            {
-                if (l == 0)
-                {
-                    GLdouble denominator = _knots[j + k - r] - _knots[j];
-                    a[jj](r, 0) = (denominator > 0.0) ? a[jj](r - 1, 0) / denominator : 0.0;
-                }
-
-                if (l == r)
-                {
-                    GLdouble denominator = _knots[j + k] - _knots[j + r];
-                    a[jj](r, r) = (denominator > 0.0) ? -a[jj](r - 1, r - 1) / denominator : 0.0;
-                }
+            value[jj] = leading[jj];
+        }
 
-                if (l > 0 && l < r)
-                {
-                    GLdouble denominator = _knots[j + k - r + l] - _knots[j + l];
-                    a[jj](r, l) = (denominator > 0.0) ? (a[jj](r - 1, l) - a[jj](r - 1, l - 1)) / denominator : 0.0;
-                }
+        for (GLuint m = degree; m > 0; m--)
+        {
+            const GLdouble *coefficients = D(K, r, m - 1);
 
-                // we evaluate iteratively the sum that appears in the differentiation formula;
-                // note that the normalized B-spline basis function N_{j+l}^{k-r}(u) vanishes
-                // over [u_{i}, u_{i+1}) if j+l is not in the set {i - k + 1 + r = offset_r, ..., i}
-                GLuint index = j + l;
-                if (index >= offset_r && index <= i)
-                {
-                    dN(r, j) += a[jj](r, l) * N(k - 1 - r, index - offset_r);
-                }
+            for (GLuint jj = 0; jj < K; jj++)
+            {
+                value[jj] = value[jj] * t + coefficients[jj];
             }
+        }
 
-            // multiply through by the correct factor
-            dN(r, j) *= factor;
+        for (GLuint jj = 0; jj < K; jj++)
+        {
+            dN[r * K + jj] = factor * value[jj];
         }
+
+        factor *= scale;
     }
-    return GL_TRUE;
 }
 
-RowMatrix<RealMatrix*> KnotVector::GenerateAllLookUpTablesUpToADifferentiationOrder(GLuint maximum_order_of_derivatives, GLuint division_of_integral) const
+GLboolean KnotVector::_AreUniformSpans(GLuint count, const GLuint *spans, GLuint& checked_span, GLboolean& checked_uniform) const
 {
-    GLint m = division_of_integral;
-    if (m % 2)
+    for (GLuint r = 0; r < count; r++)
     {
-        m++;
-    }
+        if (spans[r] != checked_span)
+        {
+            checked_span    = spans[r];
+            checked_uniform = _IsUniformSpan(checked_span);
+        }
 
-    GLint half_m = m / 2;
+        if (!checked_uniform)
+        {
+            return GL_FALSE;
+        }
+    }
 
-    RowMatrix<GLdouble> t(m + 1);
+    return GL_TRUE;
+}
 
+GLvoid KnotVector::_UniformNonZeroDerivatives(GLuint i, GLdouble u, GLuint maximum_order_of_derivatives, GLdouble *dN) const
+{
     GLuint k = _order;
-    GLdouble step = (_u_max - _u_min) / m;
+    GLuint n = min(maximum_order_of_derivatives, k - 1);
 
-#pragma omp parallel for
-    for (int i = 0; i < m; i++)
-    {
-        t[i] = _u_min + i * step;
-    }
-    t[m] = _u_max;
+    const UniformBasisMatrices &D = UniformBasis();
 
-    vector< Matrix<GLdouble> > dNt(m + 1);
+    GLdouble t = (u - _knots[i]) * _inverse_uniform_step;
 
-#pragma omp parallel for
-    for (int s = 0; s <= m; s++)
+    switch (k)
     {
-        ZerothAndHigherOrderDerivative(maximum_order_of_derivatives, t[s], dNt[s]);
+    case 1: UniformNonZeroDerivativesOfFixedOrder<1>(D, t, _inverse_uniform_step, n, dN); break;
+    case 2: UniformNonZeroDerivativesOfFixedOrder<2>(D, t, _inverse_uniform_step, n, dN); break;
+    case 3: UniformNonZeroDerivativesOfFixedOrder<3>(D, t, _inverse_uniform_step, n, dN); break;
+    case 4: UniformNonZeroDerivativesOfFixedOrder<4>(D, t, _inverse_uniform_step, n, dN); break;
+    case 5: UniformNonZeroDerivativesOfFixedOrder<5>(D, t, _inverse_uniform_step, n, dN); break;
+    case 6: UniformNonZeroDerivativesOfFixedOrder<6>(D, t, _inverse_uniform_step, n, dN); break;
+    default: break;
     }
 
-    GLuint n = GetN();
+    fill(dN + (n + 1) * k, dN + (maximum_order_of_derivatives + 1) * k, 0.0);
+}
 
-    RowMatrix<RealMatrix*> result(maximum_order_of_derivatives + 1);
+// number of consecutive parameter values that are evaluated together by the vectorised kernels below
+static const GLuint BASIS_LANE_GROUP = 8;
+
+// the vectorised kernels evaluate a group of BASIS_LANE_GROUP parameter values u[lane] the (non-empty or empty) spans of
+// which are given, lane by lane they store the same values as the scalar kernels in the row-major layouts
+//  - values[lane * K + jj] = N_{spans[lane] - K + 1 + jj}^{K}(u[lane]);
+//  - derivatives[(lane * (maximum_order_of_derivatives + 1) + r) * K + jj] = d^r/du^r N_{spans[lane] - K + 1 + jj}^{K}(u[lane]);
+// the knots are gathered lane by lane and the quotients of vanishing denominators are replaced by zeros without branches
+typedef GLvoid (*BasisGroupKernel)(const GLdouble *knots, const GLuint *spans, const GLdouble *u, GLdouble *values);
+typedef GLvoid (*DerivativeGroupKernel)(const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                        GLuint maximum_order_of_derivatives, GLdouble *derivatives);
+
+#ifdef CAGD_X86_BASIS_KERNELS
+CAGD_TARGET("avx2,fma")
+static inline __m256d GatherKnotsAVX2(const GLdouble *knots, __m128i spans, GLint shift)
+{
+    // the masked form with a zeroed source avoids the undefined source operand of the unmasked gather
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), knots, _mm_add_epi32(spans, _mm_set1_epi32(shift)),
+                                    _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
 
-    for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+// numerator / denominator if denominator > 0, otherwise 0
+CAGD_TARGET("avx2,fma")
+static inline __m256d DivideOrZeroAVX2(__m256d numerator, __m256d denominator)
+{
+    return _mm256_and_pd(_mm256_cmp_pd(denominator, _mm256_setzero_pd(), _CMP_GT_OQ), _mm256_div_pd(numerator, denominator));
+}
+
+// stores the lanes of value at the positions destination[lane * stride]
+CAGD_TARGET("avx2,fma")
+static inline GLvoid ScatterLanesAVX2(__m256d value, GLdouble *destination, size_t stride)
+{
+    GLdouble lanes[4];
+    _mm256_storeu_pd(lanes, value);
+
+    for (GLuint lane = 0; lane < 4; lane++)
     {
-        result[r] = new RealMatrix(n + 1, n + 1);
+        destination[lane * stride] = lanes[lane];
     }
+}
 
-    if (_type == PERIODIC)
+template <GLuint K>
+CAGD_TARGET("avx2,fma")
+static GLvoid EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2(const GLdouble *knots, const GLuint *spans, const GLdouble *u, GLdouble *values)
+{
+    for (GLuint half = 0; half < BASIS_LANE_GROUP; half += 4)
     {
-        // d^r/du^r f_{n, j} (u) =  d^r/du^r [ N_{j}^{k}(u) + N_{n+1+j}^{k}(u) ], j = 0,1, ..., k-2,
-        for (GLuint s = 0; s <=  static_cast<GLuint>(m); s++)
+        __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(spans + half));
+        __m256d x = _mm256_loadu_pd(u + half);
+
+        __m256d left[K], right[K], N[K];
+
+        N[0] = _mm256_set1_pd(1.0);
+
+        for (GLuint r = 1; r < K; r++)
         {
-            for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+            left[r]  = _mm256_sub_pd(x, GatherKnotsAVX2(knots, i, 1 - static_cast<GLint>(r)));
+            right[r] = _mm256_sub_pd(GatherKnotsAVX2(knots, i, r), x);
+
+            __m256d saved = _mm256_setzero_pd();
+
+            for (GLuint c = 0; c < r; c++)
             {
-                for (GLuint j = 0; j <= k - 2; j++)
-                {
-                    dNt[s](r, j) += dNt[s](r, j + n + 1);
-                }
+                __m256d temp = DivideOrZeroAVX2(N[c], _mm256_add_pd(right[c + 1], left[r - c]));
+
+                N[c]  = _mm256_fmadd_pd(right[c + 1], temp, saved);
+                saved = _mm256_mul_pd(left[r - c], temp);
             }
 
-            dNt[s].ResizeColumns(n + 1);
+            N[r] = saved;
+        }
+
+        for (GLuint jj = 0; jj < K; jj++)
+        {
+            ScatterLanesAVX2(N[jj], values + half * K + jj, K);
         }
     }
+}
 
-    for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+// the differences ndu(j, c) = u_{i+c+1} - u_{i+1-j+c} (c < j) of the knots and the functions ndu(c, j) = N_{i-j+c}^{j+1} (c <= j)
+// of lower orders share a square array, the derivatives are the sums of the latter weighted by the recursively divided
+// differences a(r, l) of the differentiation formula
+template <GLuint K>
+CAGD_TARGET("avx2,fma")
+static GLvoid NonZeroDerivativesOfFixedOrderAVX2(const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                                 GLuint maximum_order_of_derivatives, GLdouble *derivatives)
+{
+    const GLint p         = static_cast<GLint>(K) - 1;
+    const GLint n         = min(static_cast<GLint>(maximum_order_of_derivatives), p);
+    const GLuint row_count = maximum_order_of_derivatives + 1;
+
+    for (GLuint half = 0; half < BASIS_LANE_GROUP; half += 4)
     {
-        for (GLuint i = 0; i <= n; i++)
+        __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(spans + half));
+        __m256d x = _mm256_loadu_pd(u + half);
+
+        __m256d left[K], right[K], ndu[K][K], a[2][K], d[K][K];
+
+        ndu[0][0] = _mm256_set1_pd(1.0);
+
+        for (GLint j = 1; j <= p; j++)
+        {
+            left[j]  = _mm256_sub_pd(x, GatherKnotsAVX2(knots, i, 1 - j));
+            right[j] = _mm256_sub_pd(GatherKnotsAVX2(knots, i, j), x);
+
+            __m256d saved = _mm256_setzero_pd();
+
+            for (GLint c = 0; c < j; c++)
+            {
+                ndu[j][c] = _mm256_add_pd(right[c + 1], left[j - c]);
+
+                __m256d temp = DivideOrZeroAVX2(ndu[c][j - 1], ndu[j][c]);
+
+                ndu[c][j] = _mm256_fmadd_pd(right[c + 1], temp, saved);
+                saved     = _mm256_mul_pd(left[j - c], temp);
+            }
+
+            ndu[j][j] = saved;
+        }
+
+        for (GLint c = 0; c <= p; c++)
+        {
+            d[0][c] = ndu[c][p];
+        }
+
+        for (GLint c = 0; c <= p; c++)
         {
-            for (GLuint j = 0; j <= i; j++)
+            GLint s_1 = 0, s_2 = 1;
+
+            a[0][0] = _mm256_set1_pd(1.0);
+
+            for (GLint r = 1; r <= n; r++)
             {
-                double even = 0.0;
-                for (GLuint s = 0; s <=  static_cast<GLuint>(half_m - 1); s++)
+                __m256d sum = _mm256_setzero_pd();
+                GLint   c_r = c - r, p_r = p - r;
+
+                if (c >= r)
+                {
+                    a[s_2][0] = DivideOrZeroAVX2(a[s_1][0], ndu[p_r + 1][c_r]);
+                    sum       = _mm256_mul_pd(a[s_2][0], ndu[c_r][p_r]);
+                }
+
+                GLint l_1 = (c_r >= -1) ? 1 : -c_r;
+                GLint l_2 = (c - 1 <= p_r) ? r - 1 : p - c;
+
+                for (GLint l = l_1; l <= l_2; l++)
                 {
-                    even += dNt[2*s](r, i) * dNt[2*s](r, j);
+                    a[s_2][l] = DivideOrZeroAVX2(_mm256_sub_pd(a[s_1][l], a[s_1][l - 1]), ndu[p_r + 1][c_r + l]);
+                    sum       = _mm256_fmadd_pd(a[s_2][l], ndu[c_r + l][p_r], sum);
                 }
-                even *= 2.0;
 
-                double odd = 0.0;
-                for (GLuint s = 1; s <=  static_cast<GLuint>(half_m); s++)
+                if (c <= p_r)
                 {
-                    odd += dNt[2*s-1](r, i) * dNt[2*s-1](r, j);
+                    a[s_2][r] = DivideOrZeroAVX2(_mm256_sub_pd(_mm256_setzero_pd(), a[s_1][r - 1]), ndu[p_r + 1][c]);
+                    sum       = _mm256_fmadd_pd(a[s_2][r], ndu[c][p_r], sum);
                 }
-                odd *= 4.0;
 
-                GLdouble &integral = (*result[r])(i, j);
-                integral += even + odd;
-                integral += dNt[0](r, i) * dNt[0](r, j);
-                integral += dNt[m](r, i) * dNt[m](r, j);
-                integral *= step;
-                integral /= 3.0;
+                d[r][c] = sum;
+                swap(s_1, s_2);
+            }
+        }
+
+        // multiplication by (k - 1)! / (k - 1 - r)!, while the derivatives of order at least k vanish
+        GLdouble factor = 1.0;
 
-                (*result[r])(j, i) = (*result[r])(i, j);
+        for (GLuint r = 0; r < row_count; r++)
+        {
+            if (r > 0)
+            {
+                factor *= static_cast<GLint>(r) <= n ? static_cast<GLdouble>(p - static_cast<GLint>(r) + 1) : 0.0;
+            }
+
+            __m256d multiplier = _mm256_set1_pd(factor);
+
+            for (GLint c = 0; c <= p; c++)
+            {
+                __m256d value = (static_cast<GLint>(r) <= n) ? _mm256_mul_pd(multiplier, d[r][c]) : _mm256_setzero_pd();
+
+                ScatterLanesAVX2(value, derivatives + (half * row_count + r) * K + c, row_count * K);
             }
         }
     }
+}
 
-    return result;
+CAGD_TARGET("avx512f")
+static inline __m512d GatherKnotsAVX512(const GLdouble *knots, __m256i spans, GLint shift)
+{
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm256_add_epi32(spans, _mm256_set1_epi32(shift)), knots, 8);
+}
+
+CAGD_TARGET("avx512f")
+static inline __m512d DivideOrZeroAVX512(__m512d numerator, __m512d denominator)
+{
+    return _mm512_maskz_div_pd(_mm512_cmp_pd_mask(denominator, _mm512_setzero_pd(), _CMP_GT_OQ), numerator, denominator);
+}
+
+CAGD_TARGET("avx512f")
+static inline GLvoid ScatterLanesAVX512(__m512d value, GLdouble *destination, size_t stride)
+{
+    GLdouble lanes[8];
+    _mm512_storeu_pd(lanes, value);
 
+    for (GLuint lane = 0; lane < 8; lane++)
+    {
+        destination[lane * stride] = lanes[lane];
+    }
 }
 
-RealMatrix KnotVector::LookUpTableForCurveOptimizatioin(const RowMatrix<GLdouble> &weight, GLuint division_of_integral) const
+template <GLuint K>
+CAGD_TARGET("avx512f")
+static GLvoid EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512(const GLdouble *knots, const GLuint *spans, const GLdouble *u, GLdouble *values)
 {
-    GLuint n = GetN();
-    RealMatrix result(n + 1, n + 1);
+    __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(spans));
+    __m512d x = _mm512_loadu_pd(u);
+
+    __m512d left[K], right[K], N[K];
+
+    N[0] = _mm512_set1_pd(1.0);
+
+    for (GLuint r = 1; r < K; r++)
+    {
+        left[r]  = _mm512_sub_pd(x, GatherKnotsAVX512(knots, i, 1 - static_cast<GLint>(r)));
+        right[r] = _mm512_sub_pd(GatherKnotsAVX512(knots, i, r), x);
+
+        __m512d saved = _mm512_setzero_pd();
+
+        for (GLuint c = 0; c < r; c++)
+        {
+            __m512d temp = DivideOrZeroAVX512(N[c], _mm512_add_pd(right[c + 1], left[r - c]));
+
+            N[c]  = _mm512_fmadd_pd(right[c + 1], temp, saved);
+            saved = _mm512_mul_pd(left[r - c], temp);
+        }
+
+        N[r] = saved;
+    }
 
-    RowMatrix<RealMatrix*> allMatrix = GenerateAllLookUpTablesUpToADifferentiationOrder(weight.GetColumnCount(), division_of_integral);
-    for (GLuint r = 1; r <= weight.GetColumnCount(); r++)
+    for (GLuint jj = 0; jj < K; jj++)
     {
-        result = result + (*allMatrix[r]) * weight[r - 1];
-        delete allMatrix[r];
-        allMatrix[r] = nullptr;
+        ScatterLanesAVX512(N[jj], values + jj, K);
     }
+}
+
+template <GLuint K>
+CAGD_TARGET("avx512f")
+static GLvoid NonZeroDerivativesOfFixedOrderAVX512(const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                                   GLuint maximum_order_of_derivatives, GLdouble *derivatives)
+{
+    const GLint p         = static_cast<GLint>(K) - 1;
+    const GLint n         = min(static_cast<GLint>(maximum_order_of_derivatives), p);
+    const GLuint row_count = maximum_order_of_derivatives + 1;
+
+    __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(spans));
+    __m512d x = _mm512_loadu_pd(u);
+
+    __m512d left[K], right[K], ndu[K][K], a[2][K], d[K][K];
+
+    ndu[0][0] = _mm512_set1_pd(1.0);
+
+    for (GLint j = 1; j <= p; j++)
+    {
+        left[j]  = _mm512_sub_pd(x, GatherKnotsAVX512(knots, i, 1 - j));
+        right[j] = _mm512_sub_pd(GatherKnotsAVX512(knots, i, j), x);
+
+        __m512d saved = _mm512_setzero_pd();
+
+        for (GLint c = 0; c < j; c++)
+        {
+            ndu[j][c] = _mm512_add_pd(right[c + 1], left[j - c]);
+
+            __m512d temp = DivideOrZeroAVX512(ndu[c][j - 1], ndu[j][c]);
+
+            ndu[c][j] = _mm512_fmadd_pd(right[c + 1], temp, saved);
+            saved     = _mm512_mul_pd(left[j - c], temp);
+        }
+
+        ndu[j][j] = saved;
+    }
+
+    for (GLint c = 0; c <= p; c++)
+    {
+        d[0][c] = ndu[c][p];
+    }
+
+    for (GLint c = 0; c <= p; c++)
+    {
+        GLint s_1 = 0, s_2 = 1;
+
+        a[0][0] = _mm512_set1_pd(1.0);
+
+        for (GLint r = 1; r <= n; r++)
+        {
+            __m512d sum = _mm512_setzero_pd();
+            GLint   c_r = c - r, p_r = p - r;
+
+            if (c >= r)
+            {
+                a[s_2][0] = DivideOrZeroAVX512(a[s_1][0], ndu[p_r + 1][c_r]);
+                sum       = _mm512_mul_pd(a[s_2][0], ndu[c_r][p_r]);
+            }
+
+            GLint l_1 = (c_r >= -1) ? 1 : -c_r;
+            GLint l_2 = (c - 1 <= p_r) ? r - 1 : p - c;
+
+            for (GLint l = l_1; l <= l_2; l++)
+            {
+                a[s_2][l] = DivideOrZeroAVX512(_mm512_sub_pd(a[s_1][l], a[s_1][l - 1]), ndu[p_r + 1][c_r + l]);
+                sum       = _mm512_fmadd_pd(a[s_2][l], ndu[c_r + l][p_r], sum);
+            }
+
+            if (c <= p_r)
+            {
+                a[s_2][r] = DivideOrZeroAVX512(_mm512_sub_pd(_mm512_setzero_pd(), a[s_1][r - 1]), ndu[p_r + 1][c]);
+                sum       = _mm512_fmadd_pd(a[s_2][r], ndu[c][p_r], sum);
+            }
+
+            d[r][c] = sum;
+            swap(s_1, s_2);
+        }
+    }
+
+    GLdouble factor = 1.0;
+
+    for (GLuint r = 0; r < row_count; r++)
+    {
+        if (r > 0)
+        {
+            factor *= static_cast<GLint>(r) <= n ? static_cast<GLdouble>(p - static_cast<GLint>(r) + 1) : 0.0;
+        }
+
+        __m512d multiplier = _mm512_set1_pd(factor);
+
+        for (GLint c = 0; c <= p; c++)
+        {
+            __m512d value = (static_cast<GLint>(r) <= n) ? _mm512_mul_pd(multiplier, d[r][c]) : _mm512_setzero_pd();
+
+            ScatterLanesAVX512(value, derivatives + r * K + c, row_count * K);
+        }
+    }
+}
+#endif
+
+// the vectorised kernel of the given order on the current processor, or a null pointer
+static BasisGroupKernel VectorisedBasisKernel(GLuint order)
+{
+#ifdef CAGD_X86_BASIS_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512<2>;
+        case 3: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512<3>;
+        case 4: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512<4>;
+        case 5: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512<5>;
+        case 6: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX512<6>;
+        default: return nullptr;
+        }
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2<2>;
+        case 3: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2<3>;
+        case 4: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2<4>;
+        case 5: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2<5>;
+        case 6: return EvaluateNonZeroBSplineFunctionsOfFixedOrderAVX2<6>;
+        default: return nullptr;
+        }
+    default:
+        return nullptr;
+    }
+#else
+    (GLvoid)order;
+    return nullptr;
+#endif
+}
+
+static DerivativeGroupKernel VectorisedDerivativeKernel(GLuint order)
+{
+#ifdef CAGD_X86_BASIS_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return NonZeroDerivativesOfFixedOrderAVX512<2>;
+        case 3: return NonZeroDerivativesOfFixedOrderAVX512<3>;
+        case 4: return NonZeroDerivativesOfFixedOrderAVX512<4>;
+        case 5: return NonZeroDerivativesOfFixedOrderAVX512<5>;
+        case 6: return NonZeroDerivativesOfFixedOrderAVX512<6>;
+        default: return nullptr;
+        }
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return NonZeroDerivativesOfFixedOrderAVX2<2>;
+        case 3: return NonZeroDerivativesOfFixedOrderAVX2<3>;
+        case 4: return NonZeroDerivativesOfFixedOrderAVX2<4>;
+        case 5: return NonZeroDerivativesOfFixedOrderAVX2<5>;
+        case 6: return NonZeroDerivativesOfFixedOrderAVX2<6>;
+        default: return nullptr;
+        }
+    default:
+        return nullptr;
+    }
+#else
+    (GLvoid)order;
+    return nullptr;
+#endif
+}
+
+// the uniform counterparts of the vectorised kernels, where the spans of all lanes are uniform (see KnotVector::_IsUniformSpan),
+// only the knots u_{i} are gathered and the Horner schemes of the constant uniform basis matrices do not require divisions
+typedef GLvoid (*UniformDerivativeGroupKernel)(const UniformBasisMatrices &D, const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                               GLdouble inverse_step, GLuint maximum_order_of_derivatives, GLdouble *derivatives);
+
+#ifdef CAGD_X86_BASIS_KERNELS
+template <GLuint K>
+CAGD_TARGET("avx2,fma")
+static GLvoid UniformNonZeroDerivativesOfFixedOrderAVX2(const UniformBasisMatrices &D, const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                                        GLdouble inverse_step, GLuint maximum_order_of_derivatives, GLdouble *derivatives)
+{
+    const GLuint n         = min(maximum_order_of_derivatives, K - 1);
+    const GLuint row_count = maximum_order_of_derivatives + 1;
+
+    for (GLuint half = 0; half < BASIS_LANE_GROUP; half += 4)
+    {
+        __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(spans + half));
+        __m256d t = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(u + half), GatherKnotsAVX2(knots, i, 0)), _mm256_set1_pd(inverse_step));
+
+        GLdouble factor = 1.0;
+
+        for (GLuint r = 0; r < row_count; r++)
+        {
+            if (r > n)
+            {
+                for (GLuint jj = 0; jj < K; jj++)
+                {
+                    ScatterLanesAVX2(_mm256_setzero_pd(), derivatives + (half * row_count + r) * K + jj, row_count * K);
+                }
+                continue;
+            }
+
+            GLuint  degree = K - 1 - r;
+            __m256d value[K];
+
+            for (GLuint jj = 0; jj < K; jj++)
+            {
+                value[jj] = _mm256_set1_pd(D(K, r, degree)[jj]);
+            }
+
+            for (GLuint m = degree; m > 0; m--)
+            {
+                const GLdouble *coefficients = D(K, r, m - 1);
+
+                for (GLuint jj = 0; jj < K; jj++)
+                {
+                    value[jj] = _mm256_fmadd_pd(value[jj], t, _mm256_set1_pd(coefficients[jj]));
+                }
+            }
+
+            __m256d multiplier = _mm256_set1_pd(factor);
+
+            for (GLuint jj = 0; jj < K; jj++)
+            {
+                ScatterLanesAVX2(_mm256_mul_pd(multiplier, value[jj]), derivatives + (half * row_count + r) * K + jj, row_count * K);
+            }
+
+            factor *= inverse_step;
+        }
+    }
+}
+
+template <GLuint K>
+CAGD_TARGET("avx512f")
+static GLvoid UniformNonZeroDerivativesOfFixedOrderAVX512(const UniformBasisMatrices &D, const GLdouble *knots, const GLuint *spans, const GLdouble *u,
+                                                          GLdouble inverse_step, GLuint maximum_order_of_derivatives, GLdouble *derivatives)
+{
+    const GLuint n         = min(maximum_order_of_derivatives, K - 1);
+    const GLuint row_count = maximum_order_of_derivatives + 1;
+
+    __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(spans));
+    __m512d t = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(u), GatherKnotsAVX512(knots, i, 0)), _mm512_set1_pd(inverse_step));
+
+    GLdouble factor = 1.0;
+
+    for (GLuint r = 0; r < row_count; r++)
+    {
+        if (r > n)
+        {
+            for (GLuint jj = 0; jj < K; jj++)
+            {
+                ScatterLanesAVX512(_mm512_setzero_pd(), derivatives + r * K + jj, row_count * K);
+            }
+            continue;
+        }
+
+        GLuint  degree = K - 1 - r;
+        __m512d value[K];
+
+        for (GLuint jj = 0; jj < K; jj++)
+        {
+            value[jj] = _mm512_set1_pd(D(K, r, degree)[jj]);
+        }
+
+        for (GLuint m = degree; m > 0; m--)
+        {
+            const GLdouble *coefficients = D(K, r, m - 1);
+
+            for (GLuint jj = 0; jj < K; jj++)
+            {
+                value[jj] = _mm512_fmadd_pd(value[jj], t, _mm512_set1_pd(coefficients[jj]));
+            }
+        }
+
+        __m512d multiplier = _mm512_set1_pd(factor);
+
+        for (GLuint jj = 0; jj < K; jj++)
+        {
+            ScatterLanesAVX512(_mm512_mul_pd(multiplier, value[jj]), derivatives + r * K + jj, row_count * K);
+        }
+
+        factor *= inverse_step;
+    }
+}
+#endif
+
+static UniformDerivativeGroupKernel VectorisedUniformDerivativeKernel(GLuint order)
+{
+#ifdef CAGD_X86_BASIS_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return UniformNonZeroDerivativesOfFixedOrderAVX512<2>;
+        case 3: return UniformNonZeroDerivativesOfFixedOrderAVX512<3>;
+        case 4: return UniformNonZeroDerivativesOfFixedOrderAVX512<4>;
+        case 5: return UniformNonZeroDerivativesOfFixedOrderAVX512<5>;
+        case 6: return UniformNonZeroDerivativesOfFixedOrderAVX512<6>;
+        default: return nullptr;
+        }
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        switch (order)
+        {
+        case 2: return UniformNonZeroDerivativesOfFixedOrderAVX2<2>;
+        case 3: return UniformNonZeroDerivativesOfFixedOrderAVX2<3>;
+        case 4: return UniformNonZeroDerivativesOfFixedOrderAVX2<4>;
+        case 5: return UniformNonZeroDerivativesOfFixedOrderAVX2<5>;
+        case 6: return UniformNonZeroDerivativesOfFixedOrderAVX2<6>;
+        default: return nullptr;
+        }
+    default:
+        return nullptr;
+    }
+#else
+    (GLvoid)order;
+    return nullptr;
+#endif
+}
+
+GLvoid KnotVector::_EvaluateNonZeroBSplineFunctions(GLuint i, GLdouble u, GLdouble *N) const
+{
+    const GLdouble *knots = _knots.GetRowPointer(0);
+
+    // the fixed-order kernels require a non-empty span
+    if (knots[i] < knots[i + 1])
+    {
+        switch (_order)
+        {
+        case 2: EvaluateNonZeroBSplineFunctionsOfFixedOrder<2>(knots, i, u, N); return;
+        case 3: EvaluateNonZeroBSplineFunctionsOfFixedOrder<3>(knots, i, u, N); return;
+        case 4: EvaluateNonZeroBSplineFunctionsOfFixedOrder<4>(knots, i, u, N); return;
+        case 5: EvaluateNonZeroBSplineFunctionsOfFixedOrder<5>(knots, i, u, N); return;
+        case 6: EvaluateNonZeroBSplineFunctionsOfFixedOrder<6>(knots, i, u, N); return;
+        default: break;
+        }
+    }
+
+    EvaluateNonZeroBSplineFunctionsOfArbitraryOrder(knots, _order, i, u, N);
+}
+
+GLboolean KnotVector::EvaluateNonZeroBSplineFunctions(GLdouble u, GLuint& i, GLdouble *N) const
+{
+    if (!FindSpan(u, i))
+    {
+        return GL_FALSE;
+    }
+
+    _EvaluateNonZeroBSplineFunctions(i, u, N);
+
+    return GL_TRUE;
+}
+
+// evaluates non-vanishing normalized B-spline function values in a lower triangular matrix of the form
+// N[row - 1][column] = N_{span - row + column + 1}^{row}, row = 1, ..., order, column = 0, 1, ..., row - 1
+GLboolean KnotVector::EvaluateNonZeroBSplineFunctions(GLdouble u, GLuint& i, TriangularMatrix<GLdouble>& N) const
+{
+    if (!FindSpan(u, i))
+    {
+        return GL_FALSE;
+    }
+
+    // the packed values are kept on the stack up to order MAXIMUM_FIXED_ORDER
+    GLdouble         fixed_storage[MAXIMUM_FIXED_ORDER * (MAXIMUM_FIXED_ORDER + 1) / 2];
+    vector<GLdouble> storage;
+    GLdouble         *packed_N = fixed_storage;
+
+    if (_order > MAXIMUM_FIXED_ORDER)
+    {
+        storage.resize(_order * (_order + 1) / 2);
+        packed_N = storage.data();
+    }
+
+    _EvaluateNonZeroBSplineFunctions(i, u, packed_N);
+
+    if (N.GetRowCount() != _order)
+    {
+        N.ResizeRows(_order);
+    }
+
+    for (GLuint r = 0; r < _order; r++)
+    {
+        const GLdouble *values = packed_N + r * (r + 1) / 2;
+
+        copy(values, values + r + 1, &N(r, 0));
+    }
+
+    return GL_TRUE;
+}
+
+GLuint KnotVector::_FindSpans(GLuint count, const GLdouble *u, GLboolean sorted, GLuint& previous_span, GLdouble& previous_u, GLuint *spans) const
+{
+    GLuint failure_count = 0;
+
+    for (GLuint r = 0; r < count; r++)
+    {
+        GLuint &i = spans[r];
+
+        GLboolean found = (sorted && previous_span != INVALID_SPAN && u[r] >= previous_u) ?
+                    _FindSpanStartingFrom(u[r], previous_span, i) : FindSpan(u[r], i);
+
+        if (found)
+        {
+            previous_span = i;
+            previous_u    = u[r];
+        }
+        else
+        {
+            i = INVALID_SPAN;
+            failure_count++;
+        }
+    }
+
+    return failure_count;
+}
+
+// batch evaluation of the non-vanishing normalized B-spline functions of order k
+GLboolean KnotVector::EvaluateNonZeroBSplineFunctions(GLuint count, const GLdouble *u, GLuint *spans, GLdouble *values,
+                                                      GLboolean sorted) const
+{
+    GLint failure_count = 0;
+    GLint group_count   = static_cast<GLint>((count + BASIS_LANE_GROUP - 1) / BASIS_LANE_GROUP);
+
+    const GLdouble               *knots         = _knots.GetRowPointer(0);
+    BasisGroupKernel             kernel         = VectorisedBasisKernel(_order);
+    UniformDerivativeGroupKernel uniform_kernel = (_uniform_step > 0.0) ? VectorisedUniformDerivativeKernel(_order) : nullptr;
+    const UniformBasisMatrices   &D             = UniformBasis();
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(count) * _order * _order, group_count);
+
+#pragma omp parallel reduction(+:failure_count) if (thread_count > 1) num_threads(thread_count)
+    {
+        // packed triangular array of the non-vanishing B-spline function values, the last k ones are of order k,
+        // that is kept on the stack up to order MAXIMUM_FIXED_ORDER
+        GLdouble         fixed_storage[MAXIMUM_FIXED_ORDER * (MAXIMUM_FIXED_ORDER + 1) / 2];
+        vector<GLdouble> storage;
+        GLdouble         *N = fixed_storage;
+
+        if (_order > MAXIMUM_FIXED_ORDER)
+        {
+            storage.resize(_order * (_order + 1) / 2);
+            N = storage.data();
+        }
+
+        const GLdouble *N_k = N + (_order - 1) * _order / 2;
+
+        // the static schedule assigns a contiguous block of groups to each thread, thus in the sorted case
+        // only the first parameter value of the block requires a binary search
+        GLuint   previous_span = INVALID_SPAN;
+        GLdouble previous_u    = 0.0;
+
+        // the spacing of the knots is verified only once for consecutive parameter values of the same span
+        GLuint    checked_span    = INVALID_SPAN;
+        GLboolean checked_uniform = GL_FALSE;
+
+#pragma omp for schedule(static)
+        for (GLint g = 0; g < group_count; g++)
+        {
+            GLuint begin = static_cast<GLuint>(g) * BASIS_LANE_GROUP;
+            GLuint end   = min(begin + BASIS_LANE_GROUP, count);
+
+            GLuint group_failure_count = _FindSpans(end - begin, u + begin, sorted, previous_span, previous_u, spans + begin);
+
+            failure_count += group_failure_count;
+
+            // complete groups of valid parameter values are evaluated lane by lane
+            if (!group_failure_count && end - begin == BASIS_LANE_GROUP)
+            {
+                if (uniform_kernel && _AreUniformSpans(BASIS_LANE_GROUP, spans + begin, checked_span, checked_uniform))
+                {
+                    uniform_kernel(D, knots, spans + begin, u + begin, _inverse_uniform_step, 0, values + static_cast<size_t>(begin) * _order);
+                    continue;
+                }
+
+                if (kernel)
+                {
+                    kernel(knots, spans + begin, u + begin, values + static_cast<size_t>(begin) * _order);
+                    continue;
+                }
+            }
+
+            for (GLuint r = begin; r < end; r++)
+            {
+                GLdouble *values_r = values + static_cast<size_t>(r) * _order;
+
+                if (spans[r] == INVALID_SPAN)
+                {
+                    fill(values_r, values_r + _order, 0.0);
+                }
+                else if (_AreUniformSpans(1, spans + r, checked_span, checked_uniform))
+                {
+                    _UniformNonZeroDerivatives(spans[r], u[r], 0, values_r);
+                }
+                else
+                {
+                    _EvaluateNonZeroBSplineFunctions(spans[r], u[r], N);
+                    copy(N_k, N_k + _order, values_r);
+                }
+            }
+        }
+    }
+
+    return failure_count == 0;
+}
+
+// batch evaluation of the derivatives of the non-vanishing normalized B-spline functions of order k
+GLboolean KnotVector::NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLuint count, const GLdouble *u, GLuint *spans,
+                                         GLdouble *derivatives, GLboolean sorted) const
+{
+    GLint  failure_count = 0;
+    GLint  group_count   = static_cast<GLint>((count + BASIS_LANE_GROUP - 1) / BASIS_LANE_GROUP);
+    size_t block_size    = static_cast<size_t>(maximum_order_of_derivatives + 1) * _order;
+
+    const GLdouble               *knots         = _knots.GetRowPointer(0);
+    DerivativeGroupKernel        kernel         = VectorisedDerivativeKernel(_order);
+    UniformDerivativeGroupKernel uniform_kernel = (_uniform_step > 0.0) ? VectorisedUniformDerivativeKernel(_order) : nullptr;
+    const UniformBasisMatrices   &D             = UniformBasis();
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(count) * _order * _order * _order, group_count);
+
+#pragma omp parallel reduction(+:failure_count) if (thread_count > 1) num_threads(thread_count)
+    {
+        GLuint   previous_span = INVALID_SPAN;
+        GLdouble previous_u    = 0.0;
+
+        GLuint    checked_span    = INVALID_SPAN;
+        GLboolean checked_uniform = GL_FALSE;
+
+#pragma omp for schedule(static)
+        for (GLint g = 0; g < group_count; g++)
+        {
+            GLuint begin = static_cast<GLuint>(g) * BASIS_LANE_GROUP;
+            GLuint end   = min(begin + BASIS_LANE_GROUP, count);
+
+            GLuint group_failure_count = _FindSpans(end - begin, u + begin, sorted, previous_span, previous_u, spans + begin);
+
+            failure_count += group_failure_count;
+
+            if (!group_failure_count && end - begin == BASIS_LANE_GROUP)
+            {
+                if (uniform_kernel && _AreUniformSpans(BASIS_LANE_GROUP, spans + begin, checked_span, checked_uniform))
+                {
+                    uniform_kernel(D, knots, spans + begin, u + begin, _inverse_uniform_step, maximum_order_of_derivatives,
+                                   derivatives + begin * block_size);
+                    continue;
+                }
+
+                if (kernel)
+                {
+                    kernel(knots, spans + begin, u + begin, maximum_order_of_derivatives, derivatives + begin * block_size);
+                    continue;
+                }
+            }
+
+            for (GLuint r = begin; r < end; r++)
+            {
+                GLdouble *derivatives_r = derivatives + r * block_size;
+
+                if (spans[r] == INVALID_SPAN)
+                {
+                    fill(derivatives_r, derivatives_r + block_size, 0.0);
+                }
+                else if (_AreUniformSpans(1, spans + r, checked_span, checked_uniform))
+                {
+                    _UniformNonZeroDerivatives(spans[r], u[r], maximum_order_of_derivatives, derivatives_r);
+                }
+                else
+                {
+                    _NonZeroDerivatives(spans[r], u[r], maximum_order_of_derivatives, derivatives_r);
+                }
+            }
+        }
+    }
+
+    return failure_count == 0;
+}
+
+// evaluates the sparse collocation matrix of the regression problems
+GLboolean KnotVector::GenerateCollocationMatrix(const RowMatrix<GLdouble>& parameter_values, CollocationMatrix& F) const
+{
+    GLuint row_count = parameter_values.GetColumnCount();
+
+    F = CollocationMatrix(row_count, GetN() + 1, _order, _type == PERIODIC);
+
+    if (!row_count)
+    {
+        return GL_TRUE;
+    }
+
+    // e.g., the parameter values of the image generation or of curve-like point clouds are usually sorted
+    const GLdouble *u      = parameter_values.GetRowPointer(0);
+    GLboolean      sorted = is_sorted(u, u + row_count);
+
+    vector<GLuint>   spans(row_count);
+    vector<GLdouble> values(static_cast<size_t>(row_count) * _order);
+
+    GLboolean result = EvaluateNonZeroBSplineFunctions(row_count, u, spans.data(), values.data(), sorted);
+
+    for (GLuint r = 0; r < row_count; r++)
+    {
+        if (spans[r] != INVALID_SPAN)
+        {
+            F.SetRow(r, spans[r] - _order + 1, values.data() + static_cast<size_t>(r) * _order);
+        }
+    }
+
+    return result;
+}
+
+// getters
+KnotVector::Type KnotVector::GetType() const
+{
+    return _type;
+}
+
+GLuint KnotVector::GetOrder() const
+{
+    return _order;
+}
+
+GLuint KnotVector::GetControlPointCount() const
+{
+    return _control_point_count;
+}
+
+GLdouble KnotVector::GetMin() const
+{
+    return _u_min;
+}
+
+GLdouble KnotVector::GetMax() const
+{
+    return _u_max;
+}
+
+GLuint KnotVector::GetN() const
+{
+    return _type == KnotVector::PERIODIC ? _control_point_count - _order : _control_point_count - 1;
+}
+
+std::ostream& cagd::operator << (std::ostream& lhs, const KnotVector& rhs)
+{
+    lhs << rhs._knots;
+    return lhs;
+}
+
+// The differences ndu[j * k + c] = u_{i+c+1} - u_{i+1-j+c} (c < j) of the knots and the functions ndu[c * k + j] = N_{i-j+c}^{j+1}(u)
+// (c <= j) of lower orders share a square array, the derivatives are the sums of the latter weighted by the recursively divided
+// differences a[l] of the differentiation formula (two rows of k elements), zero denominators belong to vanishing terms.
+// The rows r = 0, 1, ..., maximum_order_of_derivatives of the (maximum_order_of_derivatives + 1) x k array dN are stored, the rows
+// r >= k vanish.
+static GLvoid NonZeroDerivativesOfArbitraryOrder(const GLdouble *knots, GLuint k, GLuint i, GLdouble u, GLuint maximum_order_of_derivatives,
+                                                 GLdouble *left, GLdouble *right, GLdouble *ndu, GLdouble *a, GLdouble *dN)
+{
+    const GLint p = static_cast<GLint>(k) - 1;
+    const GLint n = min(static_cast<GLint>(maximum_order_of_derivatives), p);
+
+    ndu[0] = 1.0;
+
+    for (GLint j = 1; j <= p; j++)
+    {
+        left[j]  = u - knots[i + 1 - j];
+        right[j] = knots[i + j] - u;
+
+        GLdouble saved = 0.0;
+
+        for (GLint c = 0; c < j; c++)
+        {
+            ndu[j * k + c] = right[c + 1] + left[j - c];
+
+            GLdouble temp = (ndu[j * k + c] > 0.0) ? ndu[c * k + j - 1] / ndu[j * k + c] : 0.0;
+
+            ndu[c * k + j] = saved + right[c + 1] * temp;
+            saved          = left[j - c] * temp;
+        }
+
+        ndu[j * k + j] = saved;
+    }
+
+    fill(dN, dN + (maximum_order_of_derivatives + 1) * k, 0.0);
+
+    for (GLint c = 0; c <= p; c++)
+    {
+        dN[c] = ndu[c * k + p];
+    }
+
+    for (GLint c = 0; c <= p; c++)
+    {
+        GLdouble *a_1 = a, *a_2 = a + k;
+
+        a_1[0] = 1.0;
+
+        for (GLint r = 1; r <= n; r++)
+        {
+            GLdouble sum = 0.0;
+            GLint    c_r = c - r, p_r = p - r;
+
+            // the denominators ndu[(p_r + 1) * k + l] are the lengths of the supports of the functions of order k - r
+            const GLdouble *differences = ndu + (p_r + 1) * k;
+
+            if (c >= r)
+            {
+                a_2[0] = (differences[c_r] > 0.0) ? a_1[0] / differences[c_r] : 0.0;
+                sum    = a_2[0] * ndu[c_r * k + p_r];
+            }
+
+            GLint l_1 = (c_r >= -1) ? 1 : -c_r;
+            GLint l_2 = (c - 1 <= p_r) ? r - 1 : p - c;
+
+            for (GLint l = l_1; l <= l_2; l++)
+            {
+                a_2[l] = (differences[c_r + l] > 0.0) ? (a_1[l] - a_1[l - 1]) / differences[c_r + l] : 0.0;
+                sum   += a_2[l] * ndu[(c_r + l) * k + p_r];
+            }
+
+            if (c <= p_r)
+            {
+                a_2[r] = (differences[c] > 0.0) ? -a_1[r - 1] / differences[c] : 0.0;
+                sum   += a_2[r] * ndu[c * k + p_r];
+            }
+
+            dN[r * k + c] = sum;
+            swap(a_1, a_2);
+        }
+    }
+
+    // multiplication by (k - 1)! / (k - 1 - r)!
+    GLdouble factor = 1.0;
+
+    for (GLint r = 1; r <= n; r++)
+    {
+        factor *= (p - r + 1);
+
+        for (GLint c = 0; c <= p; c++)
+        {
+            dN[r * k + c] *= factor;
+        }
+    }
+}
+
+GLvoid KnotVector::_NonZeroDerivatives(GLuint i, GLdouble u, GLuint maximum_order_of_derivatives, GLdouble *dN) const
+{
+    if (_IsUniformSpan(i))
+    {
+        _UniformNonZeroDerivatives(i, u, maximum_order_of_derivatives, dN);
+        return;
+    }
+
+    GLuint k = _order;
+
+    // the work arrays are kept on the stack up to order MAXIMUM_FIXED_ORDER
+    GLdouble         fixed_storage[MAXIMUM_FIXED_ORDER * (MAXIMUM_FIXED_ORDER + 4)];
+    vector<GLdouble> storage;
+    GLdouble         *work = fixed_storage;
+
+    if (k > MAXIMUM_FIXED_ORDER)
+    {
+        storage.resize(k * (k + 4));
+        work = storage.data();
+    }
+
+    NonZeroDerivativesOfArbitraryOrder(_knots.GetRowPointer(0), k, i, u, maximum_order_of_derivatives,
+                                       work, work + k, work + 2 * k, work + k * (k + 2), dN);
+}
+
+GLboolean KnotVector::NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLdouble u, GLuint& i, GLdouble *dN) const
+{
+    if (!FindSpan(u, i))
+    {
+        return GL_FALSE;
+    }
+
+    _NonZeroDerivatives(i, u, maximum_order_of_derivatives, dN);
+
+    return GL_TRUE;
+}
+
+GLboolean KnotVector::NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLdouble u, GLuint& i, Matrix<GLdouble> &dN) const
+{
+    GLuint k = _order;
+
+    vector<GLdouble> compact_dN((maximum_order_of_derivatives + 1) * k);
+
+    if (!NonZeroDerivatives(maximum_order_of_derivatives, u, i, compact_dN.data()))
+    {
+        dN.ResizeColumns(0);
+        dN.ResizeRows(0);
+        return GL_FALSE;
+    }
+
+    // resizing the output matrix dN, the column jj corresponds to the B-spline function N_{i - k + 1 + jj}^{k}
+    dN.ResizeRows(maximum_order_of_derivatives + 1);
+    dN.ResizeColumns(k);
+
+    for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+    {
+        copy(compact_dN.data() + r * k, compact_dN.data() + (r + 1) * k, dN.GetRowPointer(r));
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean KnotVector::ZerothAndHigherOrderDerivative(GLuint maximum_order_of_derivatives, GLdouble u, Matrix<GLdouble> &dN) const
+{
+    GLuint           i;                                                         // span: [u_{i}, u_{i+1})
+    vector<GLdouble> local_dN((maximum_order_of_derivatives + 1) * _order);     // derivatives of the non-vanishing B-spline functions
+
+    if (!NonZeroDerivatives(maximum_order_of_derivatives, u, i, local_dN.data()))
+    {
+        dN.ResizeColumns(0);
+        dN.ResizeRows(0);
+        return GL_FALSE;
+    }
+
+    // resizing the output matrix dN
+    dN.ResizeRows(maximum_order_of_derivatives + 1);
+    dN.ResizeColumns(_control_point_count);
+
+    GLuint offset_0 = i - _order + 1;
+
+    for(GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+    {
+        for(GLuint j = 0; j < _control_point_count; j++)
+        {
+            dN(r, j) = (j >= offset_0 && j <= i) ? local_dN[r * _order + j - offset_0] : 0.0;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+// nodes and weights of the point_count-point Gauss-Legendre quadrature rule on [-1, 1],
+// the nodes are the roots of the Legendre polynomial P_{point_count} that are determined by Newton's method
+static GLvoid GaussLegendreRule(GLuint point_count, vector<GLdouble>& nodes, vector<GLdouble>& weights)
+{
+    nodes.resize(point_count);
+    weights.resize(point_count);
+
+    // the roots are symmetric with respect to the origin
+    for (GLuint i = 0; i < (point_count + 1) / 2; i++)
+    {
+        GLdouble x = cos(PI * (i + 0.75) / (point_count + 0.5));
+        GLdouble derivative = 1.0;
+
+        for (GLuint iteration = 0; iteration < 100; iteration++)
+        {
+            // P_{point_count}(x) by means of the three-term recurrence (j + 1) P_{j+1} = (2j + 1) x P_{j} - j P_{j-1}
+            GLdouble p_0 = 1.0, p_1 = 0.0;
+
+            for (GLuint j = 0; j < point_count; j++)
+            {
+                GLdouble p_2 = p_1;
+                p_1 = p_0;
+                p_0 = ((2.0 * j + 1.0) * x * p_1 - j * p_2) / (j + 1.0);
+            }
+
+            // P'_{n}(x) = n (x P_{n}(x) - P_{n-1}(x)) / (x^2 - 1)
+            derivative = point_count * (x * p_0 - p_1) / (x * x - 1.0);
+
+            GLdouble delta = p_0 / derivative;
+            x -= delta;
+
+            if (fabs(delta) <= 1.0e-15)
+            {
+                break;
+            }
+        }
+
+        nodes[i] = -x;
+        nodes[point_count - 1 - i] = x;
+
+        weights[i] = weights[point_count - 1 - i] = 2.0 / ((1.0 - x * x) * derivative * derivative);
+    }
+}
+
+RowMatrix<BandedSPDMatrix*> KnotVector::GenerateAllLookUpTablesUpToADifferentiationOrder(GLuint maximum_order_of_derivatives, GLuint division_of_integral,
+                                                                                         IntegrationMethod integration_method) const
+{
+    shared_ptr<const EnergyLookUpTableCache::Tables> tables = _LookUpTables(division_of_integral, integration_method);
+
+    RowMatrix<BandedSPDMatrix*> result(maximum_order_of_derivatives + 1);
+
+    for (GLuint r = 0; r <= maximum_order_of_derivatives; r++)
+    {
+        result[r] = (r < tables->size()) ? new BandedSPDMatrix((*tables)[r]) : new BandedSPDMatrix(_ZeroLookUpTable());
+    }
+
+    return result;
+}
+
+shared_ptr<const EnergyLookUpTableCache::Tables> KnotVector::_LookUpTables(GLuint division_of_integral, IntegrationMethod integration_method) const
+{
+    // the Gauss-Legendre rule does not depend on the division of the integral,
+    // while Simpson's rule rounds it up to the next even number
+    GLuint division = 0;
+
+    if (integration_method == COMPOSITE_SIMPSON)
+    {
+        division = division_of_integral + division_of_integral % 2;
+    }
+
+    EnergyLookUpTableCache::Key key;
+    key.reserve(_knots.GetColumnCount() + 6);
+
+    key.push_back(_type);
+    key.push_back(_order);
+    key.push_back(integration_method);
+    key.push_back(division);
+    key.push_back(_u_min);
+    key.push_back(_u_max);
+
+    for (GLuint i = 0; i < _knots.GetColumnCount(); i++)
+    {
+        key.push_back(_knots[i]);
+    }
+
+    shared_ptr<const EnergyLookUpTableCache::Tables> tables = EnergyLookUpTableCache::Find(key);
+
+    if (!tables)
+    {
+        shared_ptr<EnergyLookUpTableCache::Tables> new_tables = make_shared<EnergyLookUpTableCache::Tables>();
+
+        if (integration_method == COMPOSITE_SIMPSON)
+        {
+            _GenerateLookUpTablesBySimpsonsRule(division, *new_tables);
+        }
+        else
+        {
+            _GenerateLookUpTablesByGaussLegendreRule(*new_tables);
+        }
+
+        tables = new_tables;
+
+        EnergyLookUpTableCache::Insert(key, tables);
+    }
+
+    return tables;
+}
+
+BandedSPDMatrix KnotVector::_ZeroLookUpTable() const
+{
+    // in case of periodic knot vectors the folded basis functions also couple the first and last k - 1 ones
+    return BandedSPDMatrix(GetN() + 1, _order - 1, _type == PERIODIC);
+}
+
+GLvoid KnotVector::_AccumulateIntoLookUpTable(GLdouble weight, GLuint span, const GLdouble *d, BandedSPDMatrix &table) const
+{
+    GLuint k      = _order;
+    GLuint size   = GetN() + 1;
+    GLuint offset = span - k + 1;
+
+    for (GLuint p = 0; p < k; p++)
+    {
+        // in case of periodic knot vectors the last k - 1 basis functions are folded onto the first ones
+        GLuint   row          = (offset + p) % size;
+        GLdouble weighted_d_p = weight * d[p];
+
+        // the symmetric entries (row, column) and (column, row) share their place in the band,
+        // i.e., only the lower triangle of the k x k block is visited
+        for (GLuint q = 0; q <= p; q++)
+        {
+            GLuint   column = (offset + q) % size;
+            GLdouble value  = weighted_d_p * d[q];
+
+            table(row, column) += (q < p && row == column) ? 2.0 * value : value;
+        }
+    }
+}
+
+GLvoid KnotVector::_AccumulateQuadratureIntoLookUpTables(GLuint count, const GLdouble *u, const GLdouble *w,
+                                                         EnergyLookUpTableCache::Tables &tables) const
+{
+    GLuint k = _order;
+
+    // the derivatives of the k basis functions that do not vanish at the increasing quadrature points are evaluated
+    // chunk by chunk, i.e., the memory usage does not depend on the number of points
+    const GLuint chunk_size = 4096;
+
+    vector<GLuint>   spans(min(count, chunk_size));
+    vector<GLdouble> dN(spans.size() * k * k);
+
+    for (GLuint begin = 0; begin < count; begin += chunk_size)
+    {
+        GLuint end = min(begin + chunk_size, count);
+
+        NonZeroDerivatives(k - 1, end - begin, u + begin, spans.data(), dN.data(), GL_TRUE);
+
+        for (GLuint s = begin; s < end; s++)
+        {
+            GLuint span = spans[s - begin];
+
+            if (span == INVALID_SPAN)
+            {
+                continue;
+            }
+
+            for (GLuint r = 0; r < k; r++)
+            {
+                _AccumulateIntoLookUpTable(w[s], span, dN.data() + (static_cast<size_t>(s - begin) * k + r) * k, tables[r]);
+            }
+        }
+    }
+}
+
+GLvoid KnotVector::_GenerateLookUpTablesByGaussLegendreRule(EnergyLookUpTableCache::Tables &tables) const
+{
+    GLuint k = _order;
+
+    tables.assign(k, _ZeroLookUpTable());
+
+    // The integrand d^r/du^r N_{i}^{k}(u) * d^r/du^r N_{j}^{k}(u) is a polynomial of degree at most 2(k - 1 - r) over each
+    // knot span, thus the k-point Gauss-Legendre rule (exact up to degree 2k - 1) integrates it exactly span by span.
+    // Over a span only k basis functions are non-vanishing, i.e., a quadrature node updates a k x k block of the tables.
+    vector<GLdouble> nodes, weights;
+    GaussLegendreRule(k, nodes, weights);
+
+    // the increasing quadrature points of the spans of the definition domain and their weights
+    vector<GLdouble> u, w;
+    u.reserve(static_cast<size_t>(_control_point_count - k + 1) * k);
+    w.reserve(u.capacity());
+
+    for (GLuint i = k - 1; i < _control_point_count; i++)
+    {
+        GLdouble a = max(_knots[i], _u_min);
+        GLdouble b = min(_knots[i + 1], _u_max);
+
+        if (b <= a)
+        {
+            continue;
+        }
+
+        GLdouble half_length = 0.5 * (b - a);
+        GLdouble midpoint    = 0.5 * (a + b);
+
+        for (GLuint g = 0; g < k; g++)
+        {
+            u.push_back(midpoint + half_length * nodes[g]);
+            w.push_back(half_length * weights[g]);
+        }
+    }
+
+    _AccumulateQuadratureIntoLookUpTables(static_cast<GLuint>(u.size()), u.data(), w.data(), tables);
+}
+
+GLvoid KnotVector::_GenerateLookUpTablesBySimpsonsRule(GLuint division_of_integral, EnergyLookUpTableCache::Tables &tables) const
+{
+    GLint m = division_of_integral;
+    if (m % 2)
+    {
+        m++;
+    }
+
+    RowMatrix<GLdouble> t(m + 1);
+
+    GLuint   k = _order;
+    GLdouble step = (_u_max - _u_min) / m;
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(m, m);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (int i = 0; i < m; i++)
+    {
+        t[i] = _u_min + i * step;
+    }
+    t[m] = _u_max;
+
+    // Simpson weights: 1, 4, 2, 4, ..., 2, 4, 1
+    RowMatrix<GLdouble> w(m + 1);
+
+    for (GLint s = 0; s <= m; s++)
+    {
+        w[s] = ((s == 0 || s == m) ? 1.0 : ((s % 2) ? 4.0 : 2.0)) * step / 3.0;
+    }
+
+    tables.assign(k, _ZeroLookUpTable());
+
+    _AccumulateQuadratureIntoLookUpTables(m + 1, t.GetRowPointer(0), w.GetRowPointer(0), tables);
+}
+
+BandedSPDMatrix KnotVector::LookUpTableForCurveOptimizatioin(const RowMatrix<GLdouble> &weight, GLuint division_of_integral,
+                                                             IntegrationMethod integration_method) const
+{
+    BandedSPDMatrix result(_ZeroLookUpTable());
+
+    // the cached tables are only combined, derivatives of order at least k vanish
+    shared_ptr<const EnergyLookUpTableCache::Tables> tables = _LookUpTables(division_of_integral, integration_method);
+
+    for (GLuint r = 1; r <= weight.GetColumnCount() && r < tables->size(); r++)
+    {
+        result.AddScaled(weight[r - 1], (*tables)[r]);
+    }
+
     return result;
 }
 
-RowMatrix<RealMatrix*> KnotVector::LookUpTablesForSurfaceOptimizatioin(GLdouble weight, GLuint r, GLuint division_of_integral) const
+RowMatrix<BandedSPDMatrix*> KnotVector::LookUpTablesForSurfaceOptimizatioin(GLdouble weight, GLuint r, GLuint division_of_integral,
+                                                                            IntegrationMethod integration_method) const
 {
     TriangularMatrix<GLuint> binomialCoefficients(r + 1);
     for (GLuint i = 0; i <= r; i++)
@@ -414,11 +1835,12 @@ RowMatrix<RealMatrix*> KnotVector::LookUpTablesForSurfaceOptimizatioin(GLdouble
         binomialCoefficients(i, i) = 1.0;
     }
 
-    RowMatrix<RealMatrix*> result = GenerateAllLookUpTablesUpToADifferentiationOrder(r + 1, division_of_integral);
+    // only the copies of the cached tables are scaled
+    RowMatrix<BandedSPDMatrix*> result = GenerateAllLookUpTablesUpToADifferentiationOrder(r, division_of_integral, integration_method);
     for (GLuint i = 0; i <= r; i++)
     {
         GLdouble multiplier = sqrt(weight * binomialCoefficients(r, i));
-        (*result[i]) = (*result[i]) * multiplier;
+        result[i]->Scale(multiplier);
     }
     return result;
 }
@@ -2,7 +2,11 @@
 
 #include "../Core/Matrices.h"
 #include <Core/RealMatrices.h>
+#include <Core/CollocationMatrices.h>
+#include <Core/BandedSPDMatrices.h>
+#include "EnergyLookUpTableCaches.h"
 #include <GL/glew.h>
+#include <memory>
 
 namespace cagd
 {
@@ -30,6 +34,18 @@ namespace cagd
     public:
         enum Type{ CLAMPED, UNCLAMPED, PERIODIC };
 
+        // numerical integration methods of the energy look-up tables:
+        //  - GAUSS_LEGENDRE: k-point Gauss-Legendre rule over each knot span, which is exact for the
+        //    piecewise polynomial integrands (the division of the integral is ignored);
+        //  - COMPOSITE_SIMPSON: composite Simpson rule over a uniform division of the definition domain.
+        enum IntegrationMethod{ GAUSS_LEGENDRE, COMPOSITE_SIMPSON };
+
+        // the highest order that is evaluated by a fixed-order basis kernel
+        static const GLuint MAXIMUM_FIXED_ORDER = 6;
+
+        // span index of the parameter values that lie outside the definition domain
+        static const GLuint INVALID_SPAN;
+
     protected:
         Type                _type;
         GLuint              _order;                 // k
@@ -38,6 +54,59 @@ namespace cagd
         RowMatrix<GLdouble> _knots;                 // monotone increasing knot values:
                                                     //   u_{0}, u_{1}, ..., u_{n+k}    (unclamped/clamped)
                                                     //   u_{0}, u_{1}, ..., u_{n+2k-1} (periodic)
+
+        // the knots u_{k-1}, ..., u_{n+1} (u_{n+k} in the periodic case) of the definition domain are equally spaced
+        // by _uniform_step (up to the tolerance _uniform_tolerance of the rounding errors), otherwise _uniform_step = 0;
+        // the step only guides the span lookup, since the knots can be modified by means of the subscript operator,
+        // the uniform evaluation verifies the spacing of the knots that belong to the span
+        GLdouble            _uniform_step, _inverse_uniform_step, _uniform_tolerance;
+
+        GLvoid _DetectUniformSpacing();
+
+        // the knots u_{i - k + 1}, ..., u_{i + k} that determine the non-vanishing B-spline functions over the span [u_{i}, u_{i+1})
+        // are equally spaced and the order is at most MAXIMUM_FIXED_ORDER, i.e., the uniform basis matrices can be used
+        GLboolean _IsUniformSpan(GLuint i) const;
+
+        // whether all spans are uniform, where the result of the last verified span is remembered
+        GLboolean _AreUniformSpans(GLuint count, const GLuint *spans, GLuint& checked_span, GLboolean& checked_uniform) const;
+
+        // evaluates the compact array of the derivatives of the non-vanishing B-spline functions over a uniform span
+        // by means of the Horner scheme of the constant uniform basis matrices (see _IsUniformSpan)
+        GLvoid _UniformNonZeroDerivatives(GLuint i, GLdouble u, GLuint maximum_order_of_derivatives, GLdouble *dN) const;
+
+        // evaluates the packed triangular array of the non-vanishing B-spline function values over the span [u_{i}, u_{i+1})
+        // (see the public method EvaluateNonZeroBSplineFunctions), orders 2, ..., MAXIMUM_FIXED_ORDER are evaluated
+        // by fixed-order kernels
+        GLvoid _EvaluateNonZeroBSplineFunctions(GLuint i, GLdouble u, GLdouble *N) const;
+
+        // evaluates the compact array of the derivatives of the non-vanishing B-spline functions over the span [u_{i}, u_{i+1})
+        // (see the public method NonZeroDerivatives), the work arrays are kept on the stack up to order MAXIMUM_FIXED_ORDER
+        GLvoid _NonZeroDerivatives(GLuint i, GLdouble u, GLuint maximum_order_of_derivatives, GLdouble *dN) const;
+
+        // determines the span of u by walking along the knot vector from the span of a smaller parameter value
+        GLboolean _FindSpanStartingFrom(GLdouble u, GLuint previous_span, GLuint& i) const;
+
+        // determines the spans of count parameter values (INVALID_SPAN outside the definition domain) by walking along
+        // the knot vector from the previous span in the sorted case, returns the number of invalid spans
+        GLuint _FindSpans(GLuint count, const GLdouble *u, GLboolean sorted, GLuint& previous_span, GLdouble& previous_u, GLuint *spans) const;
+
+        // unweighted look-up tables of the derivatives of order 0, 1, ..., k - 1 (the higher order ones vanish),
+        // that are shared by means of the process-wide energy look-up table cache
+        std::shared_ptr<const EnergyLookUpTableCache::Tables> _LookUpTables(GLuint division_of_integral, IntegrationMethod integration_method) const;
+
+        GLvoid _GenerateLookUpTablesByGaussLegendreRule(EnergyLookUpTableCache::Tables &tables) const;
+        GLvoid _GenerateLookUpTablesBySimpsonsRule(GLuint division_of_integral, EnergyLookUpTableCache::Tables &tables) const;
+
+        // tables[r] += sum_s w[s] * (d^r/du^r N(u[s])) (d^r/du^r N(u[s]))', r = 0, 1, ..., k - 1, where u is sorted in increasing order
+        GLvoid _AccumulateQuadratureIntoLookUpTables(GLuint count, const GLdouble *u, const GLdouble *w, EnergyLookUpTableCache::Tables &tables) const;
+
+        // an (n + 1) x (n + 1) zero look-up table with half-bandwidth k - 1 (cyclic in case of periodic knot vectors)
+        BandedSPDMatrix _ZeroLookUpTable() const;
+
+        // table(i, j) += weight * d[p] * d[q], where i and j are the (folded) indices of the p-th and q-th
+        // non-vanishing basis functions over [u_{span}, u_{span + 1})
+        GLvoid _AccumulateIntoLookUpTable(GLdouble weight, GLuint span, const GLdouble *d, BandedSPDMatrix &table) const;
+
     public:
         // special constructor
         KnotVector(Type type, GLuint k, GLuint n, GLdouble u_min = 0.0, GLdouble u_max = 1.0);
@@ -48,21 +117,63 @@ namespace cagd
         // get knot value by reference
         GLdouble& operator [](GLuint index);
 
-        // determines an index stored in variable i for which u is in [u_{i}, u_{i + 1})
+        // determines an index stored in variable i for which u is in [u_{i}, u_{i + 1}),
+        // in case of uniform knot vectors the span is computed directly from the step of the knots
         GLboolean FindSpan(GLdouble u, GLuint& i) const;
 
         // evaluates non-vanishing normalized B-spline function values in a lower triangular matrix of the form
         // N[row - 1][column] = N_{span - row + column + 1}^{row}, row = 1, ..., order, column = 0, 1, ..., row - 1
         GLboolean EvaluateNonZeroBSplineFunctions(GLdouble u, GLuint& i, TriangularMatrix<GLdouble>& N) const;
 
+        // the same values without heap allocations in a packed array of k(k + 1) / 2 elements, where
+        // N[(row - 1) * row / 2 + column] = N_{span - row + column + 1}^{row}, row = 1, ..., order, column = 0, 1, ..., row - 1
+        GLboolean EvaluateNonZeroBSplineFunctions(GLdouble u, GLuint& i, GLdouble *N) const;
+
+        // evaluates the non-vanishing normalized B-spline functions of order k at count parameter values u[r] in a compact
+        // count x k row-major array, where values[r * k + jj] = N_{spans[r] - k + 1 + jj}^{k}(u[r]), jj = 0, 1, ..., k - 1;
+        // if the parameter values are sorted in increasing order, their spans are determined by walking along the knot
+        // vector instead of binary searches; parameter values outside the definition domain obtain the span INVALID_SPAN
+        // and zero values, in which case the method returns GL_FALSE;
+        // in case of orders 2, ..., MAXIMUM_FIXED_ORDER groups of consecutive parameter values are evaluated simultaneously
+        // by AVX2 or AVX-512 kernels, if the processor supports them
+        GLboolean EvaluateNonZeroBSplineFunctions(GLuint count, const GLdouble *u, GLuint *spans, GLdouble *values,
+                                                  GLboolean sorted = GL_FALSE) const;
+
+        // evaluates the sparse collocation matrix F(r, j) = N_{j}^{k}(parameter_values[r]) of the regression problems,
+        // in case of periodic knot vectors the last k - 1 basis functions are folded onto the first ones, i.e.,
+        // F has n + 1 cyclic columns; rows of parameter values that lie outside the definition domain are zeros
+        GLboolean GenerateCollocationMatrix(const RowMatrix<GLdouble>& parameter_values, CollocationMatrix& F) const;
+
+        // derivatives of the non-vanishing B-spline functions, where [u_{i}, u_{i+1}) is the span of u:
+        // dN(r, jj) = d^r/du^r N_{i - k + 1 + jj}^{k}(u), r = 0, 1, ..., maximum_order_of_derivatives, jj = 0, 1, ..., k - 1
+        GLboolean NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLdouble u, GLuint& i, Matrix<GLdouble> &dN) const;
+
+        // the same derivatives without heap allocations in a caller-provided compact (maximum_order_of_derivatives + 1) x k
+        // row-major array, i.e., dN[r * k + jj] = d^r/du^r N_{i - k + 1 + jj}^{k}(u), where the derivatives of order at least k vanish
+        GLboolean NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLdouble u, GLuint& i, GLdouble *dN) const;
+
+        // the vectorised batch counterpart of the previous method, the derivatives are stored in a compact array of
+        // count blocks of size (maximum_order_of_derivatives + 1) x k, i.e.,
+        // derivatives[(r * (maximum_order_of_derivatives + 1) + d) * k + jj] = d^d/du^d N_{spans[r] - k + 1 + jj}^{k}(u[r]),
+        // where the spans and invalid parameter values are handled as in case of the batch basis function evaluation
+        GLboolean NonZeroDerivatives(GLuint maximum_order_of_derivatives, GLuint count, const GLdouble *u, GLuint *spans,
+                                     GLdouble *derivatives, GLboolean sorted = GL_FALSE) const;
+
         // derivatives
         GLboolean ZerothAndHigherOrderDerivative(GLuint maximum_order_of_derivatives, GLdouble u, Matrix<GLdouble> &dN) const;
 
-        RowMatrix<RealMatrix*> GenerateAllLookUpTablesUpToADifferentiationOrder(GLuint maximum_order_of_derivatives, GLuint division_of_integral) const;
+        // the r-th table stores the integrals of d^r/du^r N_{i}^{k}(u) * d^r/du^r N_{j}^{k}(u) over the definition domain,
+        // the tables vanish outside the band |i - j| <= k - 1 (understood cyclically in case of periodic knot vectors),
+        // therefore they are stored and evaluated in banded form
+        RowMatrix<BandedSPDMatrix*> GenerateAllLookUpTablesUpToADifferentiationOrder(GLuint maximum_order_of_derivatives, GLuint division_of_integral,
+                                                                                     IntegrationMethod integration_method = GAUSS_LEGENDRE) const;
 
-        RealMatrix LookUpTableForCurveOptimizatioin(const RowMatrix<GLdouble> &weight, GLuint division_of_integral) const;
+        BandedSPDMatrix LookUpTableForCurveOptimizatioin(const RowMatrix<GLdouble> &weight, GLuint division_of_integral,
+                                                         IntegrationMethod integration_method = GAUSS_LEGENDRE) const;
 
-        RowMatrix<RealMatrix*> LookUpTablesForSurfaceOptimizatioin(GLdouble weight, GLuint r, GLuint division_of_integral) const;
+        // the r + 1 tables of the r-th order energy term of regression surfaces
+        RowMatrix<BandedSPDMatrix*> LookUpTablesForSurfaceOptimizatioin(GLdouble weight, GLuint r, GLuint division_of_integral,
+                                                                        IntegrationMethod integration_method = GAUSS_LEGENDRE) const;
 
         // getters
         Type GetType() const;
@@ -0,0 +1,495 @@
+#include "BandedSPDMatrices.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace cagd
+{
+BandedSPDMatrix::BandedSPDMatrix(GLuint size, GLuint half_bandwidth, GLboolean cyclic):
+    _size(size),
+    _half_bandwidth(size ? min(half_bandwidth, cyclic ? size / 2 : size - 1) : 0),
+    _cyclic(cyclic && _half_bandwidth > 0),
+    _band(size, _half_bandwidth + 1),
+    _cholesky_decomposition_is_done(GL_FALSE),
+    _single_precision_cholesky_decomposition_is_done(GL_FALSE),
+    _single_precision_band(0, 0),
+    _single_precision_border_coupling(0, 0),
+    _single_precision_border_factor(0, 0)
+{
+}
+
+BandedSPDMatrix::BandedSPDMatrix(const RealMatrix& m, GLuint half_bandwidth, GLboolean cyclic):
+    _size(m.GetRowCount()),
+    _half_bandwidth(_size ? min(half_bandwidth, cyclic ? _size / 2 : _size - 1) : 0),
+    _cyclic(cyclic && _half_bandwidth > 0),
+    _band(_size, _half_bandwidth + 1),
+    _cholesky_decomposition_is_done(GL_FALSE),
+    _single_precision_cholesky_decomposition_is_done(GL_FALSE),
+    _single_precision_band(0, 0),
+    _single_precision_border_coupling(0, 0),
+    _single_precision_border_factor(0, 0)
+{
+    if (m.GetRowCount() != m.GetColumnCount())
+    {
+        throw Exception("The matrix is not a square one.");
+    }
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_size) * (_half_bandwidth + 1), _size);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(_size); i++)
+    {
+        for (GLuint d = 0; d <= _half_bandwidth; d++)
+        {
+            if (!_cyclic && static_cast<GLuint>(i) < d)
+                break;
+
+            GLuint j = (i + _size - d) % _size;
+
+            // in the cyclic case the same symmetric entry may be reachable from two rows,
+            // it is copied only by the row that owns its place in the band
+            GLuint band_row, band_column;
+            if (_Position(i, j, band_row, band_column) &&
+                band_row == static_cast<GLuint>(i) && band_column == _half_bandwidth - d)
+            {
+                _band(band_row, band_column) = m(i, j);
+            }
+        }
+    }
+}
+
+GLuint BandedSPDMatrix::_InteriorSize() const
+{
+    return _cyclic ? _size - _half_bandwidth : _size;
+}
+
+GLboolean BandedSPDMatrix::_Position(GLuint row, GLuint column, GLuint& band_row, GLuint& band_column) const
+{
+    if (row >= _size || column >= _size)
+        return GL_FALSE;
+
+    if (!_cyclic)
+    {
+        if (row < column)
+        {
+            swap(row, column);
+        }
+
+        if (row - column > _half_bandwidth)
+            return GL_FALSE;
+
+        band_row    = row;
+        band_column = _half_bandwidth - (row - column);
+
+        return GL_TRUE;
+    }
+
+    // lower cyclic offsets of the positions (row, column) and (column, row)
+    GLuint d = (row + _size - column) % _size;
+    GLuint e = (_size - d) % _size;
+
+    // the smaller offset determines the place, ties are owned by the larger row index
+    if (d < e || (d == e && row >= column))
+    {
+        band_row = row;
+    }
+    else
+    {
+        band_row = column;
+        d        = e;
+    }
+
+    if (d > _half_bandwidth)
+        return GL_FALSE;
+
+    band_column = _half_bandwidth - d;
+
+    return GL_TRUE;
+}
+
+GLdouble& BandedSPDMatrix::operator ()(GLuint row, GLuint column)
+{
+    GLuint band_row, band_column;
+    if (!_Position(row, column, band_row, band_column))
+    {
+        throw Exception("The position lies outside the band of the matrix.");
+    }
+
+    return _band(band_row, band_column);
+}
+
+GLdouble BandedSPDMatrix::operator ()(GLuint row, GLuint column) const
+{
+    GLuint band_row, band_column;
+    if (!_Position(row, column, band_row, band_column))
+    {
+        return 0.0;
+    }
+
+    return _band(band_row, band_column);
+}
+
+GLboolean BandedSPDMatrix::IsInBand(GLuint row, GLuint column) const
+{
+    GLuint band_row, band_column;
+    return _Position(row, column, band_row, band_column);
+}
+
+GLuint BandedSPDMatrix::GetSize() const
+{
+    return _size;
+}
+
+GLuint BandedSPDMatrix::GetHalfBandwidth() const
+{
+    return _half_bandwidth;
+}
+
+GLboolean BandedSPDMatrix::IsCyclic() const
+{
+    return _cyclic;
+}
+
+GLvoid BandedSPDMatrix::_CheckThatTheBandIsNotFactorized() const
+{
+    if (_cholesky_decomposition_is_done)
+    {
+        throw Exception("The band has been overwritten by the Cholesky factor.");
+    }
+}
+
+BandedSPDMatrix& BandedSPDMatrix::operator +=(const BandedSPDMatrix& rhs)
+{
+    return AddScaled(1.0, rhs);
+}
+
+BandedSPDMatrix& BandedSPDMatrix::AddScaled(GLdouble alpha, const BandedSPDMatrix& X)
+{
+    _CheckThatTheBandIsNotFactorized();
+    X._CheckThatTheBandIsNotFactorized();
+
+    if (_size != X._size || _half_bandwidth != X._half_bandwidth || _cyclic != X._cyclic)
+    {
+        throw Exception("The size of the two matrices does not match.");
+    }
+
+    _band.AddScaled(alpha, X._band);
+
+    return *this;
+}
+
+BandedSPDMatrix& BandedSPDMatrix::Scale(GLdouble alpha)
+{
+    _CheckThatTheBandIsNotFactorized();
+
+    _band.Scale(alpha);
+
+    return *this;
+}
+
+RealMatrix BandedSPDMatrix::ToRealMatrix() const
+{
+    _CheckThatTheBandIsNotFactorized();
+
+    RealMatrix result(_size, _size);
+
+    // every symmetric pair of entries is stored once, the other places of the band are zeros
+    for (GLuint i = 0; i < _size; i++)
+    {
+        const GLdouble *a = _band.GetRowPointer(i);
+
+        result(i, i) = a[_half_bandwidth];
+
+        for (GLuint d = 1; d <= _half_bandwidth; d++)
+        {
+            if (!_cyclic && i < d)
+                break;
+
+            GLdouble a_ij = a[_half_bandwidth - d];
+
+            if (a_ij != 0.0)
+            {
+                GLuint j = (i + _size - d) % _size;
+
+                result(i, j) = result(j, i) = a_ij;
+            }
+        }
+    }
+
+    return result;
+}
+
+template <class Real>
+GLboolean BandedSPDMatrix::_FactorizeLeadingBlock(Matrix<Real>& band, GLuint row_count) const
+{
+    GLuint hbw = _half_bandwidth;
+
+    for (GLuint i = 0; i < row_count; i++)
+    {
+        Real *l_i = band.GetRowPointer(i);
+        GLuint first = (i > hbw) ? i - hbw : 0;
+
+        for (GLuint j = first; j <= i; j++)
+        {
+            const Real *l_j = band.GetRowPointer(j);
+
+            // L(i, p) and L(j, p), p = first, ..., j - 1, are stored contiguously in both rows
+            Real sum = l_i[hbw - i + j];
+            for (GLuint p = first; p < j; p++)
+            {
+                sum -= l_i[hbw - i + p] * l_j[hbw - j + p];
+            }
+
+            if (i == j)
+            {
+                if (sum <= 0)
+                {
+                    // the matrix is not positive definite
+                    return GL_FALSE;
+                }
+                l_i[hbw] = sqrt(sum);
+            }
+            else
+            {
+                l_i[hbw - i + j] = sum / l_j[hbw];
+            }
+        }
+    }
+
+    return GL_TRUE;
+}
+
+template <class Real>
+GLboolean BandedSPDMatrix::_Factorize(Matrix<Real>& band, Matrix<Real>& border_coupling, Matrix<Real>& border_factor) const
+{
+    if (!_cyclic)
+    {
+        return _FactorizeLeadingBlock(band, _size);
+    }
+
+    GLuint interior = _InteriorSize();
+    GLuint border   = _half_bandwidth;
+
+    // the coupling blocks have to be copied before the band is overwritten by the factor
+    auto A = [&](GLuint row, GLuint column) -> Real
+    {
+        GLuint band_row, band_column;
+        return _Position(row, column, band_row, band_column) ? band(band_row, band_column) : 0;
+    };
+
+    border_coupling.ResizeRows(interior);
+    border_coupling.ResizeColumns(border);
+    border_factor.ResizeRows(border);
+    border_factor.ResizeColumns(border);
+
+    for (GLuint i = 0; i < interior; i++)
+    {
+        for (GLuint r = 0; r < border; r++)
+        {
+            border_coupling(i, r) = A(i, interior + r);
+        }
+    }
+
+    for (GLuint r = 0; r < border; r++)
+    {
+        for (GLuint s = 0; s < border; s++)
+        {
+            border_factor(r, s) = A(interior + r, interior + s);
+        }
+    }
+
+    if (!_FactorizeLeadingBlock(band, interior))
+        return GL_FALSE;
+
+    // W = inv(L) * A_{IB}, column by column
+    GLint hbw = static_cast<GLint>(_half_bandwidth);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(border) * interior * (_half_bandwidth + 1), border);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint r = 0; r < static_cast<GLint>(border); r++)
+    {
+        for (GLint i = 0; i < static_cast<GLint>(interior); i++)
+        {
+            const Real *l = band.GetRowPointer(i);
+            GLint first = (i > hbw) ? i - hbw : 0;
+
+            Real sum = border_coupling(i, r);
+            for (GLint p = first; p < i; p++)
+            {
+                sum -= l[hbw - i + p] * border_coupling(p, r);
+            }
+            border_coupling(i, r) = sum / l[hbw];
+        }
+    }
+
+    // Schur complement A_{BB} - W' * W, only its lower triangle is needed
+    for (GLuint r = 0; r < border; r++)
+    {
+        for (GLuint s = 0; s <= r; s++)
+        {
+            Real sum = 0;
+            for (GLuint i = 0; i < interior; i++)
+            {
+                sum += border_coupling(i, r) * border_coupling(i, s);
+            }
+            border_factor(r, s) -= sum;
+        }
+    }
+
+    // dense Cholesky decomposition of the Schur complement
+    for (GLuint r = 0; r < border; r++)
+    {
+        for (GLuint s = 0; s <= r; s++)
+        {
+            Real sum = border_factor(r, s);
+            for (GLuint p = 0; p < s; p++)
+            {
+                sum -= border_factor(r, p) * border_factor(s, p);
+            }
+
+            if (r == s)
+            {
+                if (sum <= 0)
+                {
+                    return GL_FALSE;
+                }
+                border_factor(r, r) = sqrt(sum);
+            }
+            else
+            {
+                border_factor(r, s) = sum / border_factor(s, s);
+            }
+        }
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean BandedSPDMatrix::PerformCholeskyDecomposition()
+{
+    if (_cholesky_decomposition_is_done)
+        return GL_TRUE;
+
+    if (!_size)
+        return GL_FALSE;
+
+    _cholesky_decomposition_is_done = _Factorize(_band, _border_coupling, _border_factor);
+
+    return _cholesky_decomposition_is_done;
+}
+
+// The rows first, ..., n - 1 of the factor are rotated column by column (e.g., see the routines dchud and dchdd of LINPACK).
+// The column j of the factor and the working vector w determine the new diagonal entry r = sqrt(L(j, j)^2 + sign * w_j^2) and
+// the rotation c = r / L(j, j), s = w_j / L(j, j) that eliminates w_j. The rotation changes the components of w below the
+// diagonal, which are non-zero only inside the band of the rows that have already been rotated, thus the loop stops at the
+// last row that w can reach.
+GLboolean BandedSPDMatrix::_ModifyCholeskyDecomposition(GLdouble sign, GLuint first, GLuint count, const GLdouble *x)
+{
+    GLuint hbw = _half_bandwidth;
+
+    if (!_cholesky_decomposition_is_done || _cyclic || !count || count > hbw + 1 || first + count > _size)
+        return GL_FALSE;
+
+    // the single precision factors belong to the former matrix
+    _single_precision_cholesky_decomposition_is_done = GL_FALSE;
+
+    vector<GLdouble> w(x, x + count);
+    w.resize(_size - first, 0.0);
+
+    GLuint last = first + count - 1;
+
+    for (GLuint j = first; j <= last; j++)
+    {
+        GLdouble w_j = w[j - first];
+
+        if (w_j == 0.0)
+            continue;
+
+        GLdouble &l_jj = _band(j, hbw);
+        GLdouble r_2   = l_jj * l_jj + sign * w_j * w_j;
+
+        if (r_2 <= 0.0)
+        {
+            // the modified matrix is not positive definite
+            _cholesky_decomposition_is_done = GL_FALSE;
+            return GL_FALSE;
+        }
+
+        GLdouble r = sqrt(r_2);
+        GLdouble c = r / l_jj;
+        GLdouble s = w_j / l_jj;
+
+        l_jj = r;
+
+        GLuint end = min(j + hbw, _size - 1);
+
+        for (GLuint i = j + 1; i <= end; i++)
+        {
+            GLdouble &l_ij = _band(i, hbw - i + j);
+            GLdouble &w_i  = w[i - first];
+
+            l_ij = (l_ij + sign * s * w_i) / c;
+            w_i  = c * w_i - s * l_ij;
+        }
+
+        last = max(last, end);
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean BandedSPDMatrix::UpdateCholeskyDecomposition(GLuint first, GLuint count, const GLdouble *x)
+{
+    return _ModifyCholeskyDecomposition(1.0, first, count, x);
+}
+
+GLboolean BandedSPDMatrix::DowndateCholeskyDecomposition(GLuint first, GLuint count, const GLdouble *x)
+{
+    return _ModifyCholeskyDecomposition(-1.0, first, count, x);
+}
+
+GLboolean BandedSPDMatrix::PerformSinglePrecisionCholeskyDecomposition()
+{
+    if (_single_precision_cholesky_decomposition_is_done)
+        return GL_TRUE;
+
+    // the band has already been overwritten by the double precision factor
+    if (!_size || _cholesky_decomposition_is_done)
+        return GL_FALSE;
+
+    _single_precision_band.ResizeRows(_band.GetRowCount());
+    _single_precision_band.ResizeColumns(_band.GetColumnCount());
+
+    for (GLuint i = 0; i < _band.GetRowCount(); i++)
+    {
+        const GLdouble *a = _band.GetRowPointer(i);
+        GLfloat        *f = _single_precision_band.GetRowPointer(i);
+
+        for (GLuint j = 0; j < _band.GetColumnCount(); j++)
+        {
+            f[j] = static_cast<GLfloat>(a[j]);
+        }
+    }
+
+    _single_precision_cholesky_decomposition_is_done =
+            _Factorize(_single_precision_band, _single_precision_border_coupling, _single_precision_border_factor);
+
+    return _single_precision_cholesky_decomposition_is_done;
+}
+
+GLboolean PerformCholeskyOrLUDecomposition(BandedSPDMatrix& A, LUFactorization& LU)
+{
+    // the band is overwritten by the decomposition even if it fails, therefore the original matrix is copied in advance
+    BandedSPDMatrix original(A);
+
+    if (A.PerformCholeskyDecomposition())
+    {
+        LU.Clear();
+        return GL_TRUE;
+    }
+
+    return LU.Factorize(original.ToRealMatrix());
+}
+}
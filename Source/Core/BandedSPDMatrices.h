@@ -0,0 +1,525 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cmath>
+#include <cstddef>
+#include "Matrices.h"
+#include "RealMatrices.h"
+#include "Exceptions.h"
+#include "IterativeRefinements.h"
+#include "LUFactorizations.h"
+#include "ParallelExecutionPolicies.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // A symmetric positive definite matrix A of size n, the non-zero entries of
+    // which satisfy |i - j| <= b, where b denotes the half-bandwidth.
+    //
+    // Only the lower band is stored in a row-major n x (b + 1) real matrix:
+    // the entry A(i, j), i - b <= j <= i, is kept at position (i, b - i + j),
+    // i.e., the main diagonal is the last column of the band.
+    //
+    // The Cholesky decomposition A = L * L' overwrites the band by the lower
+    // triangular factor L, which has the same half-bandwidth. Both the
+    // factorization and the solution of a linear system require O(n * b^2)
+    // and O(n * b) operations, respectively.
+    //
+    // Cyclic banded matrices (e.g., normal matrices of periodic regression
+    // curves) may also have non-zero entries in the upper right and lower left
+    // b x b corners, i.e., A(i, j) can be non-zero whenever the cyclic distance
+    // min(|i - j|, n - |i - j|) is at most b. In this case the row i of the band
+    // stores the entries A(i, (i - d) mod n), d = 0, 1, ..., b. The last b
+    // unknowns are treated as a border: the leading (n - b) x (n - b) block is
+    // banded and it is factorized in place, while the corner coupling is
+    // eliminated by means of a dense (n - b) x b block and a b x b Schur
+    // complement, thus the costs remain O(n * b^2) and O(n * b).
+    //
+    // Before the decomposition the class can also be used as the O(n * b) storage
+    // of symmetric positive semi-definite banded matrices (e.g., the energy look-up
+    // tables of B-spline functions), that can be combined linearly and multiplied by
+    // dense matrices in O(n * b) operations per column.
+    //--------------------------------------------------------------------------
+    class BandedSPDMatrix
+    {
+    private:
+        GLuint      _size;
+        GLuint      _half_bandwidth;
+        GLboolean   _cyclic;
+        RealMatrix  _band;
+        GLboolean   _cholesky_decomposition_is_done;
+
+        // factors of the cyclic case:
+        // the leading banded block is L * L', the border coupling is W = inv(L) * A_{IB},
+        // while the Cholesky factor of the Schur complement A_{BB} - W' * W is stored in the lower
+        // triangle of _border_factor
+        RealMatrix  _border_coupling;
+        RealMatrix  _border_factor;
+
+        // number of unknowns that are not part of the border
+        GLuint _InteriorSize() const;
+
+        // determines the place of the symmetric entry (row, column) inside the band,
+        // returns GL_FALSE if the position lies outside the band
+        GLboolean _Position(GLuint row, GLuint column, GLuint& band_row, GLuint& band_column) const;
+
+        // single precision copies of the factors (used by the mixed precision solver)
+        GLboolean       _single_precision_cholesky_decomposition_is_done;
+        Matrix<GLfloat> _single_precision_band;
+        Matrix<GLfloat> _single_precision_border_coupling;
+        Matrix<GLfloat> _single_precision_border_factor;
+
+        // banded Cholesky decomposition of the leading row_count x row_count block of the given band
+        template <class Real>
+        GLboolean _FactorizeLeadingBlock(Matrix<Real>& band, GLuint row_count) const;
+
+        // overwrites the given copy of the band of this matrix by the Cholesky factors
+        template <class Real>
+        GLboolean _Factorize(Matrix<Real>& band, Matrix<Real>& border_coupling, Matrix<Real>& border_factor) const;
+
+        // solves the system in place by means of the given factors,
+        // consecutive components of the right-hand side are stride elements apart
+        template <class Real, class T>
+        GLvoid _Solve(const Matrix<Real>& band, const Matrix<Real>& border_coupling, const Matrix<Real>& border_factor,
+                      T *x, std::size_t stride) const;
+
+        // solves all systems represented by the columns or rows of x in place
+        template <class Real, class T>
+        GLvoid _SolveAll(const Matrix<Real>& band, const Matrix<Real>& border_coupling, const Matrix<Real>& border_factor,
+                         Matrix<T>& x, GLboolean represent_solutions_as_columns) const;
+
+        // r = r - A * x, where A is this (not factorized) matrix, consecutive components are stride elements apart
+        template <class T>
+        GLvoid _SubtractProduct(const T *x, T *r, std::size_t stride) const;
+
+        // throws an exception if the band has already been overwritten by the Cholesky factor
+        GLvoid _CheckThatTheBandIsNotFactorized() const;
+
+        // common part of the rank-one update (sign = +1) and downdate (sign = -1) of the Cholesky factor
+        GLboolean _ModifyCholeskyDecomposition(GLdouble sign, GLuint first, GLuint count, const GLdouble *x);
+
+    public:
+        // special/default constructor, all entries are initialized to zero
+        BandedSPDMatrix(GLuint size = 1, GLuint half_bandwidth = 0, GLboolean cyclic = GL_FALSE);
+
+        // specific constructor: copies the (cyclic) band of a dense symmetric square matrix
+        BandedSPDMatrix(const RealMatrix& m, GLuint half_bandwidth, GLboolean cyclic = GL_FALSE);
+
+        // get element by reference, the position (row, column) has to be inside the band
+        GLdouble& operator ()(GLuint row, GLuint column);
+
+        // get copy of an element, positions outside the band are zeros
+        GLdouble operator ()(GLuint row, GLuint column) const;
+
+        // checks whether the (cyclic) distance of row and column is at most b
+        GLboolean IsInBand(GLuint row, GLuint column) const;
+
+        // get dimensions
+        GLuint GetSize() const;
+        GLuint GetHalfBandwidth() const;
+        GLboolean IsCyclic() const;
+
+        // linear combinations of matrices of the same size, half-bandwidth and cyclicity,
+        // none of the matrices can be factorized
+        BandedSPDMatrix& operator +=(const BandedSPDMatrix& rhs);
+        BandedSPDMatrix& AddScaled(GLdouble alpha, const BandedSPDMatrix& X);
+        BandedSPDMatrix& Scale(GLdouble alpha);
+
+        // dense copy of the (not factorized) matrix
+        RealMatrix ToRealMatrix() const;
+
+        // A * X, where X has n rows and A denotes this (not factorized) matrix
+        template <class T>
+        Matrix<T> operator *(const Matrix<T>& X) const;
+
+        template <class T>
+        friend Matrix<T> operator *(const Matrix<T>& M, const BandedSPDMatrix& A);
+
+        // tries to determine the banded Cholesky decomposition of this matrix,
+        // fails if the matrix is not positive definite
+        GLboolean PerformCholeskyDecomposition();
+
+        // Rank-one modifications A + x * x' and A - x * x' of the factorized matrix A, where the non-zero components
+        // x[0], x[1], ..., x[count - 1] of x belong to the consecutive rows first, first + 1, ..., first + count - 1,
+        // count <= b + 1 (e.g., the basis function values of a sample point of a regression curve). The factor is
+        // modified in place by plane rotations in O((n - first) * b) operations instead of a new O(n * b^2) decomposition.
+        // Only non-cyclic factorized matrices are supported. The downdate fails if A - x * x' is not positive definite,
+        // in which case the band is overwritten and the matrix has to be assembled again (as after a failed decomposition).
+        GLboolean UpdateCholeskyDecomposition(GLuint first, GLuint count, const GLdouble *x);
+        GLboolean DowndateCholeskyDecomposition(GLuint first, GLuint count, const GLdouble *x);
+
+        // Solves linear systems of type A * x = b, where A corresponds to *this,
+        // while b and x are row or column matrices with elements of type T (e.g., GLdouble or DCoordinate3).
+        template <class T>
+        GLboolean SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE);
+
+        // tries to determine the banded Cholesky decomposition of a single precision copy of this matrix,
+        // the band of this matrix is not overwritten
+        GLboolean PerformSinglePrecisionCholeskyDecomposition();
+
+        // Mixed precision variant of SolveLinearSystem (see IterativeRefinements.h): the single precision Cholesky factors
+        // provide the corrections, while the residuals are evaluated in double precision by means of this matrix.
+        // Returns GL_FALSE if the relative residual does not drop below tolerance.
+        // If the double precision decomposition has already overwritten the band, the ordinary substitutions are performed.
+        template <class T>
+        GLboolean SolveLinearSystemWithIterativeRefinement(
+                const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE,
+                GLdouble tolerance = 1.0e-12, GLuint maximum_iteration_count = 10, GLuint *iteration_count = nullptr);
+    };
+
+    // M * A, where M has n columns and A is a not factorized banded matrix
+    template <class T>
+    Matrix<T> operator *(const Matrix<T>& M, const BandedSPDMatrix& A);
+
+    // Tries to overwrite A by its banded Cholesky factor. If A is not positive definite (e.g., the normal matrix of
+    // sample points that do not determine a regular system), the pivoted LU decomposition of the dense copy of the
+    // original matrix is stored in LU, otherwise LU is cleared. Returns GL_FALSE if neither factorization exists.
+    GLboolean PerformCholeskyOrLUDecomposition(BandedSPDMatrix& A, LUFactorization& LU);
+
+    // solves A * x = b by means of the factors determined by PerformCholeskyOrLUDecomposition
+    template <class T>
+    GLboolean SolveLinearSystemByCholeskyOrLUFactors(BandedSPDMatrix& A, const LUFactorization& LU,
+                                                     const Matrix<T>& b, Matrix<T>& x);
+
+    template <class Real, class T>
+    GLvoid BandedSPDMatrix::_Solve(const Matrix<Real>& band, const Matrix<Real>& border_coupling, const Matrix<Real>& border_factor,
+                                   T *x, std::size_t stride) const
+    {
+        GLint size     = static_cast<GLint>(_size);
+        GLint hbw      = static_cast<GLint>(_half_bandwidth);
+        GLint interior = static_cast<GLint>(_InteriorSize());
+
+        // forward substitution: L * y = b
+        for (GLint i = 0; i < interior; i++)
+        {
+            const Real *l = band.GetRowPointer(i);
+            GLint first = (i > hbw) ? i - hbw : 0;
+
+            T sum = x[i * stride];
+            for (GLint p = first; p < i; p++)
+            {
+                sum -= x[p * stride] * l[hbw - i + p];
+            }
+            x[i * stride] = sum / l[hbw];
+        }
+
+        if (interior < size)
+        {
+            GLint border = size - interior;
+
+            // right-hand side of the Schur complement system: b_{B} - W' * y
+            for (GLint r = 0; r < border; r++)
+            {
+                T sum = x[(interior + r) * stride];
+                for (GLint i = 0; i < interior; i++)
+                {
+                    sum -= x[i * stride] * border_coupling(i, r);
+                }
+                x[(interior + r) * stride] = sum;
+            }
+
+            // dense Cholesky solve of the Schur complement system
+            for (GLint r = 0; r < border; r++)
+            {
+                T sum = x[(interior + r) * stride];
+                for (GLint p = 0; p < r; p++)
+                {
+                    sum -= x[(interior + p) * stride] * border_factor(r, p);
+                }
+                x[(interior + r) * stride] = sum / border_factor(r, r);
+            }
+
+            for (GLint r = border - 1; r >= 0; r--)
+            {
+                T sum = x[(interior + r) * stride];
+                for (GLint q = r + 1; q < border; q++)
+                {
+                    sum -= x[(interior + q) * stride] * border_factor(q, r);
+                }
+                x[(interior + r) * stride] = sum / border_factor(r, r);
+            }
+
+            // y - W * x_{B}
+            for (GLint i = 0; i < interior; i++)
+            {
+                const Real *w = border_coupling.GetRowPointer(i);
+
+                T sum = x[i * stride];
+                for (GLint r = 0; r < border; r++)
+                {
+                    sum -= x[(interior + r) * stride] * w[r];
+                }
+                x[i * stride] = sum;
+            }
+        }
+
+        // backward substitution: L' * x = y
+        for (GLint i = interior - 1; i >= 0; i--)
+        {
+            GLint last = (i + hbw < interior) ? i + hbw : interior - 1;
+
+            T sum = x[i * stride];
+            for (GLint q = i + 1; q <= last; q++)
+            {
+                sum -= x[q * stride] * band(q, hbw - q + i);
+            }
+            x[i * stride] = sum / band(i, hbw);
+        }
+    }
+
+    template <class Real, class T>
+    GLvoid BandedSPDMatrix::_SolveAll(const Matrix<Real>& band, const Matrix<Real>& border_coupling, const Matrix<Real>& border_factor,
+                                      Matrix<T>& x, GLboolean represent_solutions_as_columns) const
+    {
+        if (represent_solutions_as_columns)
+        {
+            CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * _size * (_half_bandwidth + 1) * x.GetColumnCount(), x.GetColumnCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint k = 0; k < static_cast<GLint>(x.GetColumnCount()); k++)
+            {
+                _Solve(band, border_coupling, border_factor, x.GetColumnPointer(k), x.GetLeadingDimension());
+            }
+        }
+        else
+        {
+            CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * _size * (_half_bandwidth + 1) * x.GetRowCount(), x.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint k = 0; k < static_cast<GLint>(x.GetRowCount()); k++)
+            {
+                _Solve(band, border_coupling, border_factor, x.GetRowPointer(k), 1);
+            }
+        }
+    }
+
+    template <class T>
+    GLvoid BandedSPDMatrix::_SubtractProduct(const T *x, T *r, std::size_t stride) const
+    {
+        GLuint hbw = _half_bandwidth;
+
+        // every symmetric pair of entries is stored once, the other places of the band are zeros
+        for (GLuint i = 0; i < _size; i++)
+        {
+            const GLdouble *a = _band.GetRowPointer(i);
+
+            r[i * stride] -= x[i * stride] * a[hbw];
+
+            for (GLuint d = 1; d <= hbw; d++)
+            {
+                if (!_cyclic && i < d)
+                    break;
+
+                GLdouble a_ij = a[hbw - d];
+
+                if (a_ij != 0.0)
+                {
+                    GLuint j = (i + _size - d) % _size;
+
+                    r[i * stride] -= x[j * stride] * a_ij;
+                    r[j * stride] -= x[i * stride] * a_ij;
+                }
+            }
+        }
+    }
+
+    template <class T>
+    Matrix<T> BandedSPDMatrix::operator *(const Matrix<T>& X) const
+    {
+        _CheckThatTheBandIsNotFactorized();
+
+        if (X.GetRowCount() != _size)
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        GLuint    column_count = X.GetColumnCount();
+        Matrix<T> result(_size, column_count);
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * _size * (_half_bandwidth + 1) * column_count, column_count);
+
+        // a stored entry updates two rows of the result, therefore the threads share out the columns of X
+#pragma omp parallel if (thread_count > 1) num_threads(thread_count)
+        {
+#ifdef _OPENMP
+            GLuint team_size    = static_cast<GLuint>(omp_get_num_threads());
+            GLuint thread_index = static_cast<GLuint>(omp_get_thread_num());
+#else
+            GLuint team_size    = 1;
+            GLuint thread_index = 0;
+#endif
+            GLuint first = column_count * thread_index / team_size;
+            GLuint last  = column_count * (thread_index + 1) / team_size;
+
+            for (GLuint i = 0; first < last && i < _size; i++)
+            {
+                const GLdouble *a   = _band.GetRowPointer(i);
+                const T        *x_i = X.GetRowPointer(i);
+                T              *r_i = result.GetRowPointer(i);
+
+                for (GLuint c = first; c < last; c++)
+                {
+                    r_i[c] += x_i[c] * a[_half_bandwidth];
+                }
+
+                for (GLuint d = 1; d <= _half_bandwidth; d++)
+                {
+                    if (!_cyclic && i < d)
+                        break;
+
+                    GLdouble a_ij = a[_half_bandwidth - d];
+
+                    if (a_ij == 0.0)
+                        continue;
+
+                    GLuint j = (i + _size - d) % _size;
+
+                    const T *x_j = X.GetRowPointer(j);
+                    T       *r_j = result.GetRowPointer(j);
+
+                    for (GLuint c = first; c < last; c++)
+                    {
+                        r_i[c] += x_j[c] * a_ij;
+                        r_j[c] += x_i[c] * a_ij;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    Matrix<T> operator *(const Matrix<T>& M, const BandedSPDMatrix& A)
+    {
+        A._CheckThatTheBandIsNotFactorized();
+
+        if (M.GetColumnCount() != A._size)
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        GLuint    size = A._size, hbw = A._half_bandwidth;
+        Matrix<T> result(M.GetRowCount(), size);
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * M.GetRowCount() * size * (hbw + 1), M.GetRowCount());
+
+        // since A is symmetric, each row of the result is the product of A and the corresponding row of M
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint k = 0; k < static_cast<GLint>(M.GetRowCount()); k++)
+        {
+            const T *m = M.GetRowPointer(k);
+            T       *r = result.GetRowPointer(k);
+
+            for (GLuint i = 0; i < size; i++)
+            {
+                const GLdouble *a = A._band.GetRowPointer(i);
+
+                r[i] += m[i] * a[hbw];
+
+                for (GLuint d = 1; d <= hbw; d++)
+                {
+                    if (!A._cyclic && i < d)
+                        break;
+
+                    GLdouble a_ij = a[hbw - d];
+
+                    if (a_ij != 0.0)
+                    {
+                        GLuint j = (i + size - d) % size;
+
+                        r[i] += m[j] * a_ij;
+                        r[j] += m[i] * a_ij;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    GLboolean BandedSPDMatrix::SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns)
+    {
+        if (!_cholesky_decomposition_is_done)
+            if (!PerformCholeskyDecomposition())
+                return GL_FALSE;
+
+        if (represent_solutions_as_columns ? b.GetRowCount() != _size : b.GetColumnCount() != _size)
+            return GL_FALSE;
+
+        x = b;
+
+        _SolveAll(_band, _border_coupling, _border_factor, x, represent_solutions_as_columns);
+
+        return GL_TRUE;
+    }
+
+    template <class T>
+    GLboolean BandedSPDMatrix::SolveLinearSystemWithIterativeRefinement(
+            const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns,
+            GLdouble tolerance, GLuint maximum_iteration_count, GLuint *iteration_count)
+    {
+        if (_cholesky_decomposition_is_done)
+        {
+            if (iteration_count)
+                *iteration_count = 0;
+
+            return SolveLinearSystem(b, x, represent_solutions_as_columns);
+        }
+
+        if (!_single_precision_cholesky_decomposition_is_done)
+            if (!PerformSinglePrecisionCholeskyDecomposition())
+                return GL_FALSE;
+
+        if (represent_solutions_as_columns ? b.GetRowCount() != _size : b.GetColumnCount() != _size)
+            return GL_FALSE;
+
+        auto solve = [&](const Matrix<T>& r, Matrix<T>& d) -> GLboolean
+        {
+            d = r;
+            _SolveAll(_single_precision_band, _single_precision_border_coupling, _single_precision_border_factor,
+                      d, represent_solutions_as_columns);
+            return GL_TRUE;
+        };
+
+        auto residual = [&](const Matrix<T>& y, Matrix<T>& r)
+        {
+            r = b;
+
+            if (represent_solutions_as_columns)
+            {
+                CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * _size * (_half_bandwidth + 1) * y.GetColumnCount(), y.GetColumnCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+                for (GLint k = 0; k < static_cast<GLint>(y.GetColumnCount()); k++)
+                {
+                    _SubtractProduct(y.GetColumnPointer(k), r.GetColumnPointer(k), y.GetLeadingDimension());
+                }
+            }
+            else
+            {
+                CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(2.0 * _size * (_half_bandwidth + 1) * y.GetRowCount(), y.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+                for (GLint k = 0; k < static_cast<GLint>(y.GetRowCount()); k++)
+                {
+                    _SubtractProduct(y.GetRowPointer(k), r.GetRowPointer(k), 1);
+                }
+            }
+        };
+
+        return RefineIteratively(b, x, solve, residual, tolerance, maximum_iteration_count, iteration_count);
+    }
+
+    template <class T>
+    GLboolean SolveLinearSystemByCholeskyOrLUFactors(BandedSPDMatrix& A, const LUFactorization& LU,
+                                                     const Matrix<T>& b, Matrix<T>& x)
+    {
+        return LU.IsDone() ? LU.SolveLinearSystem(b, x) : A.SolveLinearSystem(b, x);
+    }
+}
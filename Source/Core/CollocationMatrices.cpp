@@ -0,0 +1,157 @@
+#include "CollocationMatrices.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace cagd
+{
+CollocationMatrix::CollocationMatrix(GLuint row_count, GLuint column_count, GLuint order, GLboolean cyclic):
+    _row_count(row_count),
+    _column_count(column_count),
+    _order(order),
+    _cyclic(cyclic),
+    _offsets(row_count, 0),
+    _values(row_count, order)
+{
+}
+
+GLuint CollocationMatrix::GetRowCount() const
+{
+    return _row_count;
+}
+
+GLuint CollocationMatrix::GetColumnCount() const
+{
+    return _column_count;
+}
+
+GLuint CollocationMatrix::GetOrder() const
+{
+    return _order;
+}
+
+GLboolean CollocationMatrix::IsCyclic() const
+{
+    return _cyclic;
+}
+
+GLuint CollocationMatrix::GetOffset(GLuint row) const
+{
+    return _offsets[row];
+}
+
+GLboolean CollocationMatrix::SetRow(GLuint row, GLuint offset, const GLdouble *values)
+{
+    if (row >= _row_count || (!_cyclic && offset + _order > _column_count))
+        return GL_FALSE;
+
+    _offsets[row] = _cyclic ? offset % _column_count : offset;
+    copy(values, values + _order, _values.GetRowPointer(row));
+
+    return GL_TRUE;
+}
+
+RealMatrix CollocationMatrix::ToRealMatrix() const
+{
+    RealMatrix result(_row_count, _column_count);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_row_count) * _order, _row_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(_row_count); i++)
+    {
+        const GLdouble *f = _values.GetRowPointer(i);
+        GLdouble       *r = result.GetRowPointer(i);
+
+        for (GLuint p = 0; p < _order; p++)
+        {
+            r[GetColumnIndex(i, p)] += f[p];
+        }
+    }
+
+    return result;
+}
+
+RealMatrix CollocationMatrix::GramMatrix() const
+{
+    return BandedGramMatrix().ToRealMatrix();
+}
+
+BandedSPDMatrix CollocationMatrix::BandedGramMatrix() const
+{
+    // band(c, d) accumulates the products of the entries that lie in the columns c and c - d
+    // of the same row, d = 0, 1, ..., k - 1 (the column c - d is understood cyclically)
+    RealMatrix band(_column_count, _order);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(0.5 * _row_count * _order * (_order + 1), _row_count);
+
+#pragma omp parallel if (thread_count > 1) num_threads(thread_count)
+    {
+        RealMatrix local_band(_column_count, _order);
+
+#pragma omp for
+        for (GLint i = 0; i < static_cast<GLint>(_row_count); i++)
+        {
+            const GLdouble *f = _values.GetRowPointer(i);
+
+            for (GLuint p = 0; p < _order; p++)
+            {
+                if (f[p] == 0.0)
+                    continue;
+
+                GLdouble *b = local_band.GetRowPointer(GetColumnIndex(i, p));
+
+                for (GLuint q = 0; q <= p; q++)
+                {
+                    b[p - q] += f[p] * f[q];
+                }
+            }
+        }
+
+#pragma omp critical
+        {
+            for (GLuint c = 0; c < _column_count; c++)
+            {
+                GLdouble       *b = band.GetRowPointer(c);
+                const GLdouble *l = local_band.GetRowPointer(c);
+
+                for (GLuint d = 0; d < _order; d++)
+                {
+                    b[d] += l[d];
+                }
+            }
+        }
+    }
+
+    return cagd::BandedGramMatrix(band, _cyclic);
+}
+
+BandedSPDMatrix BandedGramMatrix(const RealMatrix& lagged_product_sums, GLboolean cyclic)
+{
+    GLuint column_count = lagged_product_sums.GetRowCount();
+    GLuint order        = lagged_product_sums.GetColumnCount();
+
+    BandedSPDMatrix result(column_count, order - 1, cyclic);
+
+    for (GLuint c = 0; c < column_count; c++)
+    {
+        const GLdouble *b = lagged_product_sums.GetRowPointer(c);
+
+        result(c, c) += b[0];
+
+        for (GLuint d = 1; d < order; d++)
+        {
+            if (!cyclic && c < d)
+                break;
+
+            GLuint e = (c + column_count * order - d) % column_count;
+
+            // the entries (c, e) and (e, c) share their place in the band, a folded
+            // cyclic column index may also coincide with c
+            result(c, e) += (c == e) ? 2.0 * b[d] : b[d];
+        }
+    }
+
+    return result;
+}
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+#include "Matrices.h"
+#include "RealMatrices.h"
+#include "BandedSPDMatrices.h"
+#include "Exceptions.h"
+#include "ParallelExecutionPolicies.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // A sparse row-block matrix of size m x n, each row of which contains at
+    // most k consecutive non-zero entries (e.g., the collocation matrix of B-spline
+    // functions of order k, where the row i stores the values of the non-vanishing
+    // basis functions at the i-th parameter value).
+    //
+    // The row i is represented by its offset o_i and by the values of the entries
+    // (i, o_i), (i, o_i + 1), ..., (i, o_i + k - 1), that are kept in a row-major
+    // m x k real matrix. In the cyclic case the column indices are understood
+    // modulo n (e.g., folded basis functions of periodic regression curves).
+    //
+    // Thus the memory usage is O(m * k) instead of O(m * n) and the products
+    // below require O(m * k) operations per right-hand side column, while the
+    // transposed matrix is never formed.
+    //--------------------------------------------------------------------------
+    class CollocationMatrix
+    {
+    private:
+        GLuint              _row_count;     // m
+        GLuint              _column_count;  // n
+        GLuint              _order;         // k
+        GLboolean           _cyclic;
+        std::vector<GLuint> _offsets;       // o_i, i = 0, 1, ..., m - 1
+        RealMatrix          _values;        // m x k
+
+    public:
+        // special/default constructor, all entries are initialized to zero
+        CollocationMatrix(GLuint row_count = 1, GLuint column_count = 1, GLuint order = 1, GLboolean cyclic = GL_FALSE);
+
+        // get dimensions
+        GLuint GetRowCount() const;
+        GLuint GetColumnCount() const;
+        GLuint GetOrder() const;
+        GLboolean IsCyclic() const;
+
+        // get the offset of a row
+        GLuint GetOffset(GLuint row) const;
+
+        // the column index of the p-th non-zero entry of a row
+        GLuint GetColumnIndex(GLuint row, GLuint p) const;
+
+        // get the values of the non-zero entries of a row
+        GLdouble* GetRowPointer(GLuint row);
+        const GLdouble* GetRowPointer(GLuint row) const;
+
+        // sets the offset and the k values of a row,
+        // returns GL_FALSE if the non-cyclic block does not fit into the matrix
+        GLboolean SetRow(GLuint row, GLuint offset, const GLdouble *values);
+
+        // dense copy of the matrix
+        RealMatrix ToRealMatrix() const;
+
+        // F' * F, the result is a symmetric n x n matrix with half-bandwidth k - 1 (cyclic in the cyclic case)
+        RealMatrix GramMatrix() const;
+
+        // the same Gram matrix in banded form
+        BandedSPDMatrix BandedGramMatrix() const;
+
+        // F * P, where P has n rows
+        template <class T>
+        Matrix<T> operator *(const Matrix<T>& P) const;
+
+        // F' * X, where X has m rows
+        template <class T>
+        Matrix<T> TransposeTimes(const Matrix<T>& X) const;
+
+        // F' * x, where x is a column matrix of size m
+        template <class T>
+        ColumnMatrix<T> TransposeTimes(const ColumnMatrix<T>& x) const;
+    };
+
+    // The Gram matrix of a collocation matrix of order k with n columns, given by the n x k sums lagged_product_sums(c, d)
+    // of the products of the entries that lie in the columns c and c - d of the same rows, d = 0, 1, ..., k - 1 (the column
+    // c - d is understood cyclically in the cyclic case). This form of the band can be accumulated row by row without
+    // storing the collocation matrix (e.g., by streaming regressions, see CurveNormalEquationAccumulator).
+    BandedSPDMatrix BandedGramMatrix(const RealMatrix& lagged_product_sums, GLboolean cyclic);
+
+    // M * G, where M has m columns
+    template <class T>
+    Matrix<T> operator *(const Matrix<T>& M, const CollocationMatrix& G);
+
+    // M * G', where M has n columns
+    template <class T>
+    Matrix<T> MultiplyByTranspose(const Matrix<T>& M, const CollocationMatrix& G);
+
+    inline GLuint CollocationMatrix::GetColumnIndex(GLuint row, GLuint p) const
+    {
+        GLuint column = _offsets[row] + p;
+        return (_cyclic && column >= _column_count) ? column % _column_count : column;
+    }
+
+    inline GLdouble* CollocationMatrix::GetRowPointer(GLuint row)
+    {
+        return _values.GetRowPointer(row);
+    }
+
+    inline const GLdouble* CollocationMatrix::GetRowPointer(GLuint row) const
+    {
+        return _values.GetRowPointer(row);
+    }
+
+    template <class T>
+    Matrix<T> CollocationMatrix::operator *(const Matrix<T>& P) const
+    {
+        if (P.GetRowCount() != _column_count)
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        GLuint    column_count = P.GetColumnCount();
+        Matrix<T> result(_row_count, column_count);
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_row_count) * _order * column_count, _row_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < static_cast<GLint>(_row_count); i++)
+        {
+            const GLdouble *f = _values.GetRowPointer(i);
+            T              *r = result.GetRowPointer(i);
+
+            for (GLuint p = 0; p < _order; p++)
+            {
+                if (f[p] == 0.0)
+                    continue;
+
+                const T *q = P.GetRowPointer(GetColumnIndex(i, p));
+
+                for (GLuint j = 0; j < column_count; j++)
+                {
+                    r[j] += q[j] * f[p];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    Matrix<T> CollocationMatrix::TransposeTimes(const Matrix<T>& X) const
+    {
+        if (X.GetRowCount() != _row_count)
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        GLuint    column_count = X.GetColumnCount();
+        Matrix<T> result(_column_count, column_count);
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_row_count) * _order * column_count, column_count);
+
+        // the rows of the result that belong to a sample overlap, therefore the threads share out
+        // the columns of X
+#pragma omp parallel if (thread_count > 1) num_threads(thread_count)
+        {
+#ifdef _OPENMP
+            GLuint team_size    = static_cast<GLuint>(omp_get_num_threads());
+            GLuint thread_index = static_cast<GLuint>(omp_get_thread_num());
+#else
+            GLuint team_size    = 1;
+            GLuint thread_index = 0;
+#endif
+            GLuint first = column_count * thread_index / team_size;
+            GLuint last  = column_count * (thread_index + 1) / team_size;
+
+            for (GLuint i = 0; first < last && i < _row_count; i++)
+            {
+                const GLdouble *f = _values.GetRowPointer(i);
+                const T        *x = X.GetRowPointer(i);
+
+                for (GLuint p = 0; p < _order; p++)
+                {
+                    if (f[p] == 0.0)
+                        continue;
+
+                    T *r = result.GetRowPointer(GetColumnIndex(i, p));
+
+                    for (GLuint j = first; j < last; j++)
+                    {
+                        r[j] += x[j] * f[p];
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    ColumnMatrix<T> CollocationMatrix::TransposeTimes(const ColumnMatrix<T>& x) const
+    {
+        if (x.GetRowCount() != _row_count)
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        ColumnMatrix<T> result(_column_count);
+
+        for (GLuint i = 0; i < _row_count; i++)
+        {
+            const GLdouble *f = _values.GetRowPointer(i);
+
+            for (GLuint p = 0; p < _order; p++)
+            {
+                if (f[p] != 0.0)
+                {
+                    result[GetColumnIndex(i, p)] += x[i] * f[p];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    Matrix<T> operator *(const Matrix<T>& M, const CollocationMatrix& G)
+    {
+        if (M.GetColumnCount() != G.GetRowCount())
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        Matrix<T> result(M.GetRowCount(), G.GetColumnCount());
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(M.GetRowCount()) * G.GetRowCount() * G.GetOrder(), M.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < static_cast<GLint>(M.GetRowCount()); i++)
+        {
+            const T *m = M.GetRowPointer(i);
+            T       *r = result.GetRowPointer(i);
+
+            for (GLuint s = 0; s < G.GetRowCount(); s++)
+            {
+                const GLdouble *g = G.GetRowPointer(s);
+
+                for (GLuint p = 0; p < G.GetOrder(); p++)
+                {
+                    r[G.GetColumnIndex(s, p)] += m[s] * g[p];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template <class T>
+    Matrix<T> MultiplyByTranspose(const Matrix<T>& M, const CollocationMatrix& G)
+    {
+        if (M.GetColumnCount() != G.GetColumnCount())
+        {
+            throw Exception("The size of the two matrices is incorrect.");
+        }
+
+        Matrix<T> result(M.GetRowCount(), G.GetRowCount());
+
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(M.GetRowCount()) * G.GetRowCount() * G.GetOrder(), M.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < static_cast<GLint>(M.GetRowCount()); i++)
+        {
+            const T *m = M.GetRowPointer(i);
+            T       *r = result.GetRowPointer(i);
+
+            for (GLuint s = 0; s < G.GetRowCount(); s++)
+            {
+                const GLdouble *g = G.GetRowPointer(s);
+
+                for (GLuint p = 0; p < G.GetOrder(); p++)
+                {
+                    r[s] += m[G.GetColumnIndex(s, p)] * g[p];
+                }
+            }
+        }
+
+        return result;
+    }
+}
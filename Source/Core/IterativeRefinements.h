@@ -0,0 +1,137 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cmath>
+#include "Matrices.h"
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // Mixed precision iterative refinement of the solution of A * x = b.
+    //
+    // Let S denote an inexpensive approximate solver of the system (e.g.,
+    // substitutions by means of single precision factors of A). Starting from
+    // x_0 = S(b), the iterations
+    //
+    //      r_i = b - A * x_i,  x_{i + 1} = x_i + S(r_i),
+    //
+    // where the residuals are evaluated in double precision by means of the
+    // original matrix, converge to the double precision solution provided that
+    // cond(A) * (unit roundoff of S) is considerably less than 1.
+    //
+    // The refinement stops when the relative residual ||r_i|| / ||b|| (Frobenius
+    // norms) drops below tolerance, when it does not decrease any more (the
+    // last correction is then withdrawn), or after maximum_iteration_count
+    // steps. The function returns GL_TRUE if the requested accuracy is reached.
+    //
+    // The callable objects have to be compatible with
+    //
+    //      GLboolean solve(const Matrix<T>& r, Matrix<T>& d);      // d = S(r)
+    //      GLvoid    residual(const Matrix<T>& x, Matrix<T>& r);   // r = b - A * x
+    //--------------------------------------------------------------------------
+    template <class T, class Solver, class Residual>
+    GLboolean RefineIteratively(const Matrix<T>& b, Matrix<T>& x, Solver solve, Residual residual,
+                                GLdouble tolerance, GLuint maximum_iteration_count,
+                                GLuint *iteration_count = nullptr);
+
+    // the elements of type T have to support the product x * x (e.g., GLdouble or DCoordinate3)
+    template <class T>
+    GLdouble SquaredFrobeniusNorm(const Matrix<T>& M);
+
+    template <class T>
+    GLdouble SquaredFrobeniusNorm(const Matrix<T>& M)
+    {
+        GLdouble result = 0.0;
+
+        for (GLuint i = 0; i < M.GetRowCount(); i++)
+        {
+            const T *m = M.GetRowPointer(i);
+
+            for (GLuint j = 0; j < M.GetColumnCount(); j++)
+            {
+                result += m[j] * m[j];
+            }
+        }
+
+        return result;
+    }
+
+    template <class T, class Solver, class Residual>
+    GLboolean RefineIteratively(const Matrix<T>& b, Matrix<T>& x, Solver solve, Residual residual,
+                                GLdouble tolerance, GLuint maximum_iteration_count,
+                                GLuint *iteration_count)
+    {
+        if (iteration_count)
+        {
+            *iteration_count = 0;
+        }
+
+        if (!solve(b, x))
+        {
+            return GL_FALSE;
+        }
+
+        GLdouble b_norm = std::sqrt(SquaredFrobeniusNorm(b));
+        if (b_norm == 0.0)
+        {
+            b_norm = 1.0;
+        }
+
+        Matrix<T> r, d;
+        residual(x, r);
+
+        GLdouble relative_residual = std::sqrt(SquaredFrobeniusNorm(r)) / b_norm;
+        GLuint   performed_iteration_count = 0;
+
+        while (relative_residual > tolerance && performed_iteration_count < maximum_iteration_count)
+        {
+            if (!solve(r, d))
+            {
+                break;
+            }
+
+            for (GLuint i = 0; i < x.GetRowCount(); i++)
+            {
+                T       *x_i = x.GetRowPointer(i);
+                const T *d_i = d.GetRowPointer(i);
+
+                for (GLuint j = 0; j < x.GetColumnCount(); j++)
+                {
+                    x_i[j] += d_i[j];
+                }
+            }
+
+            performed_iteration_count++;
+
+            residual(x, r);
+
+            GLdouble next_relative_residual = std::sqrt(SquaredFrobeniusNorm(r)) / b_norm;
+
+            if (!(next_relative_residual < relative_residual))
+            {
+                // stagnation (the limiting accuracy has been reached) or divergence (A is too ill-conditioned)
+                for (GLuint i = 0; i < x.GetRowCount(); i++)
+                {
+                    T       *x_i = x.GetRowPointer(i);
+                    const T *d_i = d.GetRowPointer(i);
+
+                    for (GLuint j = 0; j < x.GetColumnCount(); j++)
+                    {
+                        x_i[j] -= d_i[j];
+                    }
+                }
+
+                break;
+            }
+
+            relative_residual = next_relative_residual;
+        }
+
+        if (iteration_count)
+        {
+            *iteration_count = performed_iteration_count;
+        }
+
+        return relative_residual <= tolerance;
+    }
+}
@@ -0,0 +1,359 @@
+#include "KroneckerProductSums.h"
+#include "RealSquareMatrices.h"
+#include "ParallelExecutionPolicies.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace cagd
+{
+// Frobenius inner product of two matrices of the same size
+static GLdouble FrobeniusInnerProduct(const RealMatrix& A, const RealMatrix& B)
+{
+    GLdouble result = 0.0;
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(A.GetRowCount()) * A.GetColumnCount(), A.GetRowCount());
+
+#pragma omp parallel for reduction(+:result) if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(A.GetRowCount()); i++)
+    {
+        const GLdouble *a = A.GetRowPointer(i);
+        const GLdouble *b = B.GetRowPointer(i);
+
+        for (GLuint j = 0; j < A.GetColumnCount(); j++)
+        {
+            result += a[j] * b[j];
+        }
+    }
+
+    return result;
+}
+
+// U + relative_shift * max_{i} U(i, i) * I
+static RealMatrix ShiftedDiagonal(const RealMatrix& U, GLdouble relative_shift)
+{
+    GLdouble largest = 0.0;
+    for (GLuint i = 0; i < U.GetRowCount(); i++)
+    {
+        largest = max(largest, U(i, i));
+    }
+
+    RealMatrix result(U);
+    for (GLuint i = 0; i < U.GetRowCount(); i++)
+    {
+        result(i, i) += relative_shift * largest;
+    }
+
+    return result;
+}
+
+KroneckerProductSum::KroneckerProductSum(GLuint row_count, GLuint column_count):
+    _row_count(row_count),
+    _column_count(column_count),
+    _preconditioner_is_done(GL_FALSE),
+    _first_term_is_shifted(GL_FALSE)
+{
+}
+
+GLboolean KroneckerProductSum::AddTerm(const RealMatrix& U, const RealMatrix& V)
+{
+    if (U.GetRowCount() != _row_count || U.GetColumnCount() != _row_count ||
+        V.GetRowCount() != _column_count || V.GetColumnCount() != _column_count)
+    {
+        return GL_FALSE;
+    }
+
+    _u_terms.push_back(U);
+    _v_terms.push_back(V);
+
+    _preconditioner_is_done = GL_FALSE;
+
+    return GL_TRUE;
+}
+
+GLuint KroneckerProductSum::GetRowCount() const
+{
+    return _row_count;
+}
+
+GLuint KroneckerProductSum::GetColumnCount() const
+{
+    return _column_count;
+}
+
+GLuint KroneckerProductSum::GetTermCount() const
+{
+    return static_cast<GLuint>(_u_terms.size());
+}
+
+RealMatrix KroneckerProductSum::operator *(const RealMatrix& P) const
+{
+    if (P.GetRowCount() != _row_count || P.GetColumnCount() != _column_count)
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    RealMatrix result(_row_count, _column_count);
+
+    for (GLuint a = 0; a < _u_terms.size(); a++)
+    {
+        result += _u_terms[a] * P * _v_terms[a];
+    }
+
+    return result;
+}
+
+GLboolean KroneckerProductSum::_DiagonalizeSimultaneously(
+        const RealMatrix& U_0, const RealMatrix& U_1,
+        RealMatrix& X, ColumnMatrix<GLdouble>& eigenvalues)
+{
+    GLuint size = U_0.GetRowCount();
+
+    // U_0 = Q_0 * diag(d_0) * Q_0'
+    ColumnMatrix<GLdouble> d_0;
+    RealSquareMatrix       Q_0;
+    if (!RealSquareMatrix(U_0).PerformSymmetricEigenDecomposition(d_0, Q_0))
+        return GL_FALSE;
+
+    GLdouble largest = 0.0;
+    for (GLuint i = 0; i < size; i++)
+    {
+        largest = max(largest, d_0[i]);
+    }
+
+    // S = Q_0 * diag(d_0)^{-1/2}, i.e., S' * U_0 * S = I
+    RealMatrix S(Q_0);
+    for (GLuint j = 0; j < size; j++)
+    {
+        if (d_0[j] <= largest * 1.0e-14)
+        {
+            // U_0 is not positive definite
+            return GL_FALSE;
+        }
+
+        GLdouble scale = 1.0 / sqrt(d_0[j]);
+        for (GLuint i = 0; i < size; i++)
+        {
+            S(i, j) *= scale;
+        }
+    }
+
+    // C = S' * U_1 * S = Q_1 * diag(eigenvalues) * Q_1'
+    RealSquareMatrix C(S.TransposeTimes(U_1 * S));
+    for (GLuint i = 0; i < size; i++)
+    {
+        for (GLuint j = 0; j < i; j++)
+        {
+            C(i, j) = C(j, i) = 0.5 * (C(i, j) + C(j, i));
+        }
+    }
+
+    RealSquareMatrix Q_1;
+    if (!C.PerformSymmetricEigenDecomposition(eigenvalues, Q_1))
+        return GL_FALSE;
+
+    X = S * Q_1;
+
+    return GL_TRUE;
+}
+
+GLboolean KroneckerProductSum::_PreparePreconditioner()
+{
+    if (_preconditioner_is_done)
+        return GL_TRUE;
+
+    if (_u_terms.empty())
+        return GL_FALSE;
+
+    RealMatrix U(_row_count, _row_count), V(_column_count, _column_count);
+
+    if (_u_terms.size() == 2)
+    {
+        U = _u_terms[1];
+        V = _v_terms[1];
+    }
+    else if (_u_terms.size() > 2)
+    {
+        // nearest Kronecker product U (x) V of sum_{a >= 1} U_a (x) V_a in the Frobenius norm,
+        // determined by alternating least squares: the optimal U for a fixed V is
+        // sum_{a} <V_a, V> U_a / <V, V> and vice versa
+        for (GLuint a = 1; a < _v_terms.size(); a++)
+        {
+            V += _v_terms[a];
+        }
+
+        for (GLuint iteration = 0; iteration < 8; iteration++)
+        {
+            GLdouble V_V = FrobeniusInnerProduct(V, V);
+            if (V_V == 0.0)
+                break;
+
+            U = RealMatrix(_row_count, _row_count);
+            for (GLuint a = 1; a < _u_terms.size(); a++)
+            {
+                U.AddScaled(FrobeniusInnerProduct(_v_terms[a], V) / V_V, _u_terms[a]);
+            }
+
+            GLdouble U_U = FrobeniusInnerProduct(U, U);
+            if (U_U == 0.0)
+                break;
+
+            V = RealMatrix(_column_count, _column_count);
+            for (GLuint a = 1; a < _v_terms.size(); a++)
+            {
+                V.AddScaled(FrobeniusInnerProduct(_u_terms[a], U) / U_U, _v_terms[a]);
+            }
+        }
+    }
+
+    ColumnMatrix<GLdouble> lambda, mu;
+    _first_term_is_shifted = !_DiagonalizeSimultaneously(_u_terms[0], U, _u_transformation, lambda) ||
+                             !_DiagonalizeSimultaneously(_v_terms[0], V, _v_transformation, mu);
+
+    // if U_0 or V_0 is not positive definite, both of them are made positive definite by a small shift of their spectra
+    if (_first_term_is_shifted &&
+        (!_DiagonalizeSimultaneously(ShiftedDiagonal(_u_terms[0], 1.0e-8), U, _u_transformation, lambda) ||
+         !_DiagonalizeSimultaneously(ShiftedDiagonal(_v_terms[0], 1.0e-8), V, _v_transformation, mu)))
+    {
+        return GL_FALSE;
+    }
+
+    _v_transformation_transposed = _v_transformation.Transpose();
+
+    _denominators.ResizeRows(_row_count);
+    _denominators.ResizeColumns(_column_count);
+
+    for (GLuint i = 0; i < _row_count; i++)
+    {
+        for (GLuint j = 0; j < _column_count; j++)
+        {
+            _denominators(i, j) = 1.0 + lambda[i] * mu[j];
+        }
+    }
+
+    _preconditioner_is_done = GL_TRUE;
+
+    return GL_TRUE;
+}
+
+GLvoid KroneckerProductSum::_ApplyPreconditioner(const RealMatrix& R, RealMatrix& Z) const
+{
+    RealMatrix W = _u_transformation.TransposeTimes(R * _v_transformation);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_row_count) * _column_count, _row_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(_row_count); i++)
+    {
+        GLdouble       *w = W.GetRowPointer(i);
+        const GLdouble *d = _denominators.GetRowPointer(i);
+
+        for (GLuint j = 0; j < _column_count; j++)
+        {
+            w[j] /= d[j];
+        }
+    }
+
+    Z = _u_transformation * W * _v_transformation_transposed;
+}
+
+GLboolean KroneckerProductSum::SolveLinearSystem(const RealMatrix& Y, RealMatrix& P,
+                                                 GLdouble tolerance, GLuint maximum_iteration_count)
+{
+    if (Y.GetRowCount() != _row_count || Y.GetColumnCount() != _column_count)
+        return GL_FALSE;
+
+    if (!_PreparePreconditioner())
+        return GL_FALSE;
+
+    // the preconditioner is the exact inverse of operators that consist of at most two terms,
+    // unless the first term has been shifted
+    if (!_first_term_is_shifted && _u_terms.size() <= 2)
+    {
+        _ApplyPreconditioner(Y, P);
+        return GL_TRUE;
+    }
+
+    if (!maximum_iteration_count)
+    {
+        maximum_iteration_count = _row_count * _column_count;
+    }
+
+    // preconditioned conjugate gradient method
+    P = RealMatrix(_row_count, _column_count);
+
+    GLdouble Y_norm = sqrt(FrobeniusInnerProduct(Y, Y));
+    if (Y_norm == 0.0)
+        return GL_TRUE;
+
+    RealMatrix R(Y), Z, D;
+
+    _ApplyPreconditioner(R, Z);
+    D = Z;
+
+    GLdouble R_Z = FrobeniusInnerProduct(R, Z);
+
+    for (GLuint iteration = 0; iteration < maximum_iteration_count; iteration++)
+    {
+        RealMatrix Q = (*this) * D;
+
+        GLdouble alpha = R_Z / FrobeniusInnerProduct(D, Q);
+
+        P.AddScaled(alpha, D);
+        R.AddScaled(-alpha, Q);
+
+        if (sqrt(FrobeniusInnerProduct(R, R)) <= tolerance * Y_norm)
+            return GL_TRUE;
+
+        _ApplyPreconditioner(R, Z);
+
+        GLdouble R_Z_new = FrobeniusInnerProduct(R, Z);
+        GLdouble beta    = R_Z_new / R_Z;
+        R_Z = R_Z_new;
+
+        // D = Z + beta * D
+        Z.AddScaled(beta, D);
+        // the old search direction is recycled as the storage of the next preconditioned residual
+        swap(D, Z);
+    }
+
+    return GL_FALSE;
+}
+
+GLboolean KroneckerProductSum::SolveLinearSystem(const Matrix<DCoordinate3>& Y, Matrix<DCoordinate3>& P,
+                                                 GLdouble tolerance, GLuint maximum_iteration_count)
+{
+    if (Y.GetRowCount() != _row_count || Y.GetColumnCount() != _column_count)
+        return GL_FALSE;
+
+    P.ResizeRows(_row_count);
+    P.ResizeColumns(_column_count);
+
+    for (GLuint c = 0; c < 3; c++)
+    {
+        RealMatrix Y_c(_row_count, _column_count), P_c;
+
+        for (GLuint i = 0; i < _row_count; i++)
+        {
+            for (GLuint j = 0; j < _column_count; j++)
+            {
+                Y_c(i, j) = Y(i, j)[c];
+            }
+        }
+
+        if (!SolveLinearSystem(Y_c, P_c, tolerance, maximum_iteration_count))
+            return GL_FALSE;
+
+        for (GLuint i = 0; i < _row_count; i++)
+        {
+            for (GLuint j = 0; j < _column_count; j++)
+            {
+                P(i, j)[c] = P_c(i, j);
+            }
+        }
+    }
+
+    return GL_TRUE;
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+#include "DCoordinates3.h"
+#include "Matrices.h"
+#include "RealMatrices.h"
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------------------------
+    // Linear operators of the form A = sum_{a} U_a (x) V_a, where (x) denotes the Kronecker
+    // product, while U_a and V_a are symmetric matrices of sizes m x m and n x n, respectively.
+    //
+    // The unknown vector is the row-major vectorization of an m x n matrix P, i.e.,
+    // A * vec(P) = vec(sum_{a} U_a * P * V_a), thus the mn x mn matrix A is never formed and the
+    // memory usage is O(m^2 + n^2) per term.
+    //
+    // The terms have to be positive semi-definite and the first one is expected to be positive definite
+    // (e.g. F'F (x) G'G and the energy terms of regression surfaces).
+    //
+    // If there are at most two terms, the pairs (U_0, U_1) and (V_0, V_1) are diagonalized
+    // simultaneously, i.e., X_u' U_0 X_u = I, X_u' U_1 X_u = diag(lambda), X_v' V_0 X_v = I,
+    // X_v' V_1 X_v = diag(mu), and the solution is P = X_u [(X_u' Y X_v)_{ij} / (1 + lambda_i mu_j)] X_v'.
+    //
+    // Otherwise, the terms a >= 1 are replaced by their nearest Kronecker product U (x) V and the
+    // two-term operator U_0 (x) V_0 + U (x) V obtained in this way preconditions a conjugate
+    // gradient method.
+    //
+    // If U_0 or V_0 is not positive definite (e.g., F'F of sample points that do not determine all
+    // control points), the pairs are diagonalized after shifting the spectra of U_0 and V_0 by
+    // 10^{-8} times their largest diagonal entries, and the shifted two-term operator preconditions
+    // the conjugate gradient method independently of the number of terms.
+    //
+    // The iterations stop at a relative residual ||Y - A(P)|| / ||Y|| below the given tolerance, thus
+    // the relative error of P is bounded by cond(A) times the tolerance. Since the normal equations of
+    // regression surfaces are often ill-conditioned, the default tolerance is close to the unit roundoff.
+    //--------------------------------------------------------------------------------------------
+    class KroneckerProductSum
+    {
+    private:
+        GLuint                  _row_count;         // m
+        GLuint                  _column_count;      // n
+        std::vector<RealMatrix> _u_terms;
+        std::vector<RealMatrix> _v_terms;
+
+        // simultaneous diagonalization of the (approximate) two-term operator
+        GLboolean               _preconditioner_is_done;
+        GLboolean               _first_term_is_shifted;                            // U_0 or V_0 is not positive definite
+        RealMatrix              _u_transformation;                                 // X_u
+        RealMatrix              _v_transformation, _v_transformation_transposed;   // X_v, X_v'
+        RealMatrix              _denominators;                                     // 1 + lambda_i * mu_j
+
+        // X' * U_0 * X = I and X' * U_1 * X = diag(eigenvalues)
+        static GLboolean _DiagonalizeSimultaneously(
+                const RealMatrix& U_0, const RealMatrix& U_1,
+                RealMatrix& X, ColumnMatrix<GLdouble>& eigenvalues);
+
+        GLboolean _PreparePreconditioner();
+
+        // Z = inv(U_0 (x) V_0 + U (x) V) R
+        GLvoid _ApplyPreconditioner(const RealMatrix& R, RealMatrix& Z) const;
+
+    public:
+        // special/default constructor: an empty sum of operators that act on m x n matrices
+        KroneckerProductSum(GLuint row_count = 1, GLuint column_count = 1);
+
+        // appends the term U (x) V, where U is an m x m and V is an n x n symmetric matrix
+        GLboolean AddTerm(const RealMatrix& U, const RealMatrix& V);
+
+        // get dimensions
+        GLuint GetRowCount() const;
+        GLuint GetColumnCount() const;
+        GLuint GetTermCount() const;
+
+        // evaluates sum_{a} U_a * P * V_a
+        RealMatrix operator *(const RealMatrix& P) const;
+
+        // Solves the linear system sum_{a} U_a * P * V_a = Y.
+        // The conjugate gradient iterations (if any) stop when the Frobenius norm of the residual
+        // becomes less than tolerance * ||Y||; a maximum_iteration_count of 0 means m * n iterations.
+        // Returns GL_FALSE if the iterations do not converge.
+        GLboolean SolveLinearSystem(const RealMatrix& Y, RealMatrix& P,
+                                    GLdouble tolerance = 1.0e-13, GLuint maximum_iteration_count = 0);
+
+        // the coordinates of the right-hand side are solved as three independent real systems
+        GLboolean SolveLinearSystem(const Matrix<DCoordinate3>& Y, Matrix<DCoordinate3>& P,
+                                    GLdouble tolerance = 1.0e-13, GLuint maximum_iteration_count = 0);
+    };
+}
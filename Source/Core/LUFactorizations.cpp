@@ -0,0 +1,320 @@
+#include "LUFactorizations.h"
+#include "MatrixProducts.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace cagd
+{
+// the blocked algorithm for both double and single precision factors
+template <class Real>
+static GLboolean DecomposeBlocked(Matrix<Real>& A, vector<GLuint>& row_permutation)
+{
+    GLuint size = A.GetRowCount();
+
+    if (!size || A.GetColumnCount() != size)
+        return GL_FALSE;
+
+    const Real tiny = numeric_limits<Real>::min();
+
+    //-------------------------------------------------------
+    // loop over rows to get the implicit scaling information
+    //-------------------------------------------------------
+    vector<Real>     implicit_scaling_of_each_row(size);
+    GLint            zero_row_count = 0;
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size, size);
+
+#pragma omp parallel for reduction(+:zero_row_count) if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(size); i++)
+    {
+        const Real *row = A.GetRowPointer(i);
+
+        Real big = 0;
+        for (GLuint j = 0; j < size; j++)
+        {
+            Real temp = abs(row[j]);
+            if (temp > big)
+                big = temp;
+        }
+
+        if (big == 0)
+        {
+            // the matrix is singular
+            zero_row_count++;
+        }
+        else
+        {
+            implicit_scaling_of_each_row[i] = 1 / big;
+        }
+    }
+
+    if (zero_row_count)
+        return GL_FALSE;
+
+    row_permutation.resize(size);
+
+    size_t lda = A.GetLeadingDimension();
+
+    // the negated block L_21 of the current panel
+    vector<Real> minus_L_21;
+
+    for (GLuint k_begin = 0; k_begin < size; k_begin += REAL_MATRIX_BLOCK_SIZE)
+    {
+        GLuint k_end = min(k_begin + REAL_MATRIX_BLOCK_SIZE, size);
+
+        //----------------------------------------------------------
+        // factorization of the panel formed by the columns [k_begin, k_end)
+        //----------------------------------------------------------
+        for (GLuint k = k_begin; k < k_end; k++)
+        {
+            // search for the largest scaled pivot element
+            GLuint imax = k;
+            Real   big = 0;
+            for (GLuint i = k; i < size; i++)
+            {
+                Real temp = implicit_scaling_of_each_row[i] * abs(A(i, k));
+                if (temp > big)
+                {
+                    big = temp;
+                    imax = i;
+                }
+            }
+
+            Real *row_k = A.GetRowPointer(k);
+
+            // do we need to interchange rows?
+            if (k != imax)
+            {
+                swap_ranges(row_k, row_k + size, A.GetRowPointer(imax));
+                // also interchange the scale factor
+                implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
+            }
+
+            row_permutation[k] = imax;
+            if (row_k[k] == 0)
+                row_k[k] = tiny;
+
+            thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size - k) * (k_end - k), size - k - 1);
+
+            // divide by the pivot element and reduce the remaining columns of the panel
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint i = static_cast<GLint>(k) + 1; i < static_cast<GLint>(size); i++)
+            {
+                Real *row_i = A.GetRowPointer(i);
+
+                Real temp = row_i[k] /= row_k[k];
+
+                for (GLuint j = k + 1; j < k_end; j++)
+                    row_i[j] -= temp * row_k[j];
+            }
+        }
+
+        if (k_end == size)
+            break;
+
+        GLuint panel_width    = k_end - k_begin;
+        GLuint trailing_size  = size - k_end;
+
+        //----------------------------------------------------------
+        // U_12 = inv(L_11) * A_12, the column blocks are independent
+        //----------------------------------------------------------
+        GLint column_block_count = static_cast<GLint>((trailing_size + REAL_MATRIX_BLOCK_SIZE - 1) / REAL_MATRIX_BLOCK_SIZE);
+
+        thread_count = ParallelExecutionPolicy::ThreadCount(0.5 * trailing_size * panel_width * panel_width, column_block_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint J = 0; J < column_block_count; J++)
+        {
+            GLuint j_begin = k_end + J * REAL_MATRIX_BLOCK_SIZE;
+            GLuint j_end   = min(j_begin + REAL_MATRIX_BLOCK_SIZE, size);
+
+            for (GLuint i = k_begin + 1; i < k_end; i++)
+            {
+                Real *row_i = A.GetRowPointer(i);
+
+                for (GLuint p = k_begin; p < i; p++)
+                {
+                    Real        l_ip  = row_i[p];
+                    const Real *row_p = A.GetRowPointer(p);
+
+                    for (GLuint j = j_begin; j < j_end; j++)
+                        row_i[j] -= l_ip * row_p[j];
+                }
+            }
+        }
+
+        //----------------------------------------------------------
+        // A_22 = A_22 - L_21 * U_12
+        //----------------------------------------------------------
+        minus_L_21.resize(static_cast<size_t>(trailing_size) * panel_width);
+
+        thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(trailing_size) * panel_width, trailing_size);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < static_cast<GLint>(trailing_size); i++)
+        {
+            const Real *l = A.GetRowPointer(k_end + i) + k_begin;
+            Real       *m = &minus_L_21[static_cast<size_t>(i) * panel_width];
+
+            for (GLuint p = 0; p < panel_width; p++)
+                m[p] = -l[p];
+        }
+
+        AccumulateMatrixProduct(
+                trailing_size, trailing_size, panel_width,
+                minus_L_21.data(), panel_width,
+                A.GetRowPointer(k_begin) + k_end, lda,
+                A.GetRowPointer(k_end) + k_end, lda);
+    }
+
+    return GL_TRUE;
+}
+
+// (s_0, s_1, s_2) -= (l * x_0, l * x_1, l * x_2)
+static inline GLvoid SubtractThreeDotProducts(
+        GLuint count, const GLfloat *l,
+        const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s)
+{
+    for (GLuint p = 0; p < count; p++)
+    {
+        GLdouble l_p = l[p];
+
+        s[0] -= l_p * x_0[p];
+        s[1] -= l_p * x_1[p];
+        s[2] -= l_p * x_2[p];
+    }
+}
+
+// the substitutions of three structure-of-arrays right-hand sides, the double precision
+// dot products are evaluated by the SIMD kernels of MatrixProducts.h
+template <class Real>
+static GLvoid SolveThreeRightHandSides(const Matrix<Real>& factors, const vector<GLuint>& row_permutation,
+                                       GLdouble *x_0, GLdouble *x_1, GLdouble *x_2)
+{
+    GLint size = static_cast<GLint>(factors.GetRowCount());
+
+    // forward substitution L * y = P * b, the leading zero components are skipped
+    GLint first_non_zero = -1;
+    for (GLint i = 0; i < size; i++)
+    {
+        GLuint   ip = row_permutation[i];
+        GLdouble sum[3] = {x_0[ip], x_1[ip], x_2[ip]};
+
+        x_0[ip] = x_0[i];
+        x_1[ip] = x_1[i];
+        x_2[ip] = x_2[i];
+
+        if (first_non_zero >= 0)
+        {
+            SubtractThreeDotProducts(
+                    static_cast<GLuint>(i - first_non_zero), factors.GetRowPointer(i) + first_non_zero,
+                    x_0 + first_non_zero, x_1 + first_non_zero, x_2 + first_non_zero, sum);
+        }
+        else
+        {
+            if (sum[0] != 0.0 || sum[1] != 0.0 || sum[2] != 0.0)
+            {
+                first_non_zero = i;
+            }
+        }
+
+        x_0[i] = sum[0];
+        x_1[i] = sum[1];
+        x_2[i] = sum[2];
+    }
+
+    // backward substitution: U * x = y
+    for (GLint i = size - 1; i >= 0; i--)
+    {
+        const Real *u = factors.GetRowPointer(i);
+
+        GLdouble sum[3] = {x_0[i], x_1[i], x_2[i]};
+
+        SubtractThreeDotProducts(
+                static_cast<GLuint>(size - 1 - i), u + i + 1,
+                x_0 + i + 1, x_1 + i + 1, x_2 + i + 1, sum);
+
+        GLdouble u_ii = static_cast<GLdouble>(u[i]);
+
+        x_0[i] = sum[0] / u_ii;
+        x_1[i] = sum[1] / u_ii;
+        x_2[i] = sum[2] / u_ii;
+    }
+}
+
+GLvoid LUFactorization::_SolveThreeRightHandSides(const Matrix<GLdouble>& factors, const vector<GLuint>& row_permutation,
+                                                  GLdouble *x_0, GLdouble *x_1, GLdouble *x_2)
+{
+    SolveThreeRightHandSides(factors, row_permutation, x_0, x_1, x_2);
+}
+
+GLvoid LUFactorization::_SolveThreeRightHandSides(const Matrix<GLfloat>& factors, const vector<GLuint>& row_permutation,
+                                                  GLdouble *x_0, GLdouble *x_1, GLdouble *x_2)
+{
+    SolveThreeRightHandSides(factors, row_permutation, x_0, x_1, x_2);
+}
+
+GLboolean LUFactorization::Decompose(RealMatrix& A, vector<GLuint>& row_permutation)
+{
+    return DecomposeBlocked(A, row_permutation);
+}
+
+GLboolean LUFactorization::Decompose(Matrix<GLfloat>& A, vector<GLuint>& row_permutation)
+{
+    return DecomposeBlocked(A, row_permutation);
+}
+
+LUFactorization::LUFactorization():
+    _factors(0, 0),
+    _is_done(GL_FALSE)
+{
+}
+
+LUFactorization::LUFactorization(const RealMatrix& A):
+    _factors(A),
+    _is_done(GL_FALSE)
+{
+    _is_done = Decompose(_factors, _row_permutation);
+}
+
+LUFactorization::LUFactorization(RealMatrix&& A):
+    _factors(std::move(A)),
+    _is_done(GL_FALSE)
+{
+    _is_done = Decompose(_factors, _row_permutation);
+}
+
+GLboolean LUFactorization::Factorize(const RealMatrix& A)
+{
+    _factors = A;
+    _is_done = Decompose(_factors, _row_permutation);
+    return _is_done;
+}
+
+GLboolean LUFactorization::Factorize(RealMatrix&& A)
+{
+    _factors = std::move(A);
+    _is_done = Decompose(_factors, _row_permutation);
+    return _is_done;
+}
+
+GLvoid LUFactorization::Clear()
+{
+    _factors = RealMatrix(0, 0);
+    _row_permutation.clear();
+    _is_done = GL_FALSE;
+}
+
+GLboolean LUFactorization::IsDone() const
+{
+    return _is_done;
+}
+
+GLuint LUFactorization::GetSize() const
+{
+    return _factors.GetRowCount();
+}
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+#include "DCoordinates3.h"
+#include "Matrices.h"
+#include "ParallelExecutionPolicies.h"
+#include "RealMatrices.h"
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // LU decomposition of a regular square matrix A of size n with (implicitly
+    // scaled) partial pivoting, i.e., P * A = L * U, where L is unit lower and U
+    // is upper triangular.
+    //
+    // The factors overwrite the entries of A (the unit diagonal of L is not
+    // stored), while the row interchanges are represented by the sequence of
+    // transpositions (k, p_k), k = 0, 1, ..., n - 1.
+    //
+    // The right-looking blocked algorithm processes panels of
+    // REAL_MATRIX_BLOCK_SIZE columns: the panel is factorized column by column
+    // (the rows below the pivot are eliminated in parallel) and its row
+    // interchanges are applied to whole rows, then the block row U_12 of the
+    // upper factor is determined by a unit lower triangular solve (in parallel
+    // over column blocks), finally the trailing submatrix is updated by the
+    // single matrix product A_22 -= L_21 * U_12. The latter is evaluated by the
+    // cache-blocked kernels of MatrixProducts.h, thus most of the O(n^3)
+    // operations are performed by the SIMD micro-kernels.
+    //
+    // Once determined, the factorization can be stored and reused for any
+    // number of right-hand sides, each of which requires O(n^2) operations.
+    //--------------------------------------------------------------------------
+    class LUFactorization
+    {
+    private:
+        RealMatrix          _factors;
+        std::vector<GLuint> _row_permutation;
+        GLboolean           _is_done;
+
+        // solves L * U * x = P * b in place, consecutive components of the right-hand side are stride elements apart
+        template <class Real, class T>
+        static GLvoid _Solve(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                             T *x, std::size_t stride);
+
+        // DCoordinate3 right-hand sides are gathered into three contiguous arrays of x, y and z components,
+        // that are solved together: each row of the factors is loaded once and multiplied by the three
+        // components by means of SIMD dot products, the solution is scattered back at the end
+        template <class Real>
+        static GLvoid _Solve(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                             DCoordinate3 *x, std::size_t stride);
+
+        // solves L * U * [x_0 | x_1 | x_2] = P * [b_0 | b_1 | b_2] in place
+        static GLvoid _SolveThreeRightHandSides(const Matrix<GLdouble>& factors, const std::vector<GLuint>& row_permutation,
+                                                GLdouble *x_0, GLdouble *x_1, GLdouble *x_2);
+        static GLvoid _SolveThreeRightHandSides(const Matrix<GLfloat>& factors, const std::vector<GLuint>& row_permutation,
+                                                GLdouble *x_0, GLdouble *x_1, GLdouble *x_2);
+
+    public:
+        // overwrites the square matrix A by its LU factors,
+        // returns GL_FALSE if A is not square or if it has a zero row
+        static GLboolean Decompose(RealMatrix& A, std::vector<GLuint>& row_permutation);
+
+        // single precision variant (e.g., the inner solver of a mixed precision iterative refinement),
+        // the trailing updates are performed by the single precision matrix product kernels
+        static GLboolean Decompose(Matrix<GLfloat>& A, std::vector<GLuint>& row_permutation);
+
+        // Solves linear systems of type A * x = b by means of the factors determined by Decompose,
+        // where b and x are row or column matrices with elements of type T (e.g., GLdouble or DCoordinate3).
+        // In case of single precision factors the substitutions are still evaluated in double precision.
+        template <class Real, class T>
+        static GLboolean Substitute(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                                    const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE);
+
+        // default constructor: an empty factorization
+        LUFactorization();
+
+        // specific constructors: try to factorize the given square matrix
+        LUFactorization(const RealMatrix& A);
+        LUFactorization(RealMatrix&& A);
+
+        // try to determine the factors of a new square matrix
+        GLboolean Factorize(const RealMatrix& A);
+        GLboolean Factorize(RealMatrix&& A);
+
+        // releases the factors
+        GLvoid Clear();
+
+        GLboolean IsDone() const;
+        GLuint GetSize() const;
+
+        // Solves linear systems of type A * x = b, where A is the factorized matrix,
+        // while b and x are row or column matrices with elements of type T.
+        template <class T>
+        GLboolean SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE) const;
+    };
+
+    template <class Real, class T>
+    GLvoid LUFactorization::_Solve(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                                   T *x, std::size_t stride)
+    {
+        GLint size = static_cast<GLint>(factors.GetRowCount());
+
+        // the transpositions only affect the not yet processed components,
+        // therefore they can be applied during the forward substitution L * y = P * b
+        GLint first_non_zero = -1;
+        for (GLint i = 0; i < size; i++)
+        {
+            GLuint ip  = row_permutation[i];
+            T      sum = x[ip * stride];
+            x[ip * stride] = x[i * stride];
+
+            if (first_non_zero >= 0)
+            {
+                const Real *l = factors.GetRowPointer(i);
+                for (GLint j = first_non_zero; j < i; j++)
+                {
+                    sum -= x[j * stride] * static_cast<GLdouble>(l[j]);
+                }
+            }
+            else
+            {
+                if (sum != 0.0)
+                {
+                    first_non_zero = i;
+                }
+            }
+
+            x[i * stride] = sum;
+        }
+
+        // backward substitution: U * x = y
+        for (GLint i = size - 1; i >= 0; i--)
+        {
+            const Real *u = factors.GetRowPointer(i);
+
+            T sum = x[i * stride];
+            for (GLint j = i + 1; j < size; j++)
+            {
+                sum -= x[j * stride] * static_cast<GLdouble>(u[j]);
+            }
+            x[i * stride] = sum / static_cast<GLdouble>(u[i]);
+        }
+    }
+
+    template <class Real>
+    GLvoid LUFactorization::_Solve(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                                   DCoordinate3 *x, std::size_t stride)
+    {
+        std::size_t size = factors.GetRowCount();
+
+        std::vector<GLdouble> components(3 * size);
+
+        GLdouble *x_0 = components.data();
+        GLdouble *x_1 = x_0 + size;
+        GLdouble *x_2 = x_1 + size;
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            const DCoordinate3 &c = x[i * stride];
+
+            x_0[i] = c.x();
+            x_1[i] = c.y();
+            x_2[i] = c.z();
+        }
+
+        _SolveThreeRightHandSides(factors, row_permutation, x_0, x_1, x_2);
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            x[i * stride] = DCoordinate3(x_0[i], x_1[i], x_2[i]);
+        }
+    }
+
+    template <class Real, class T>
+    GLboolean LUFactorization::Substitute(const Matrix<Real>& factors, const std::vector<GLuint>& row_permutation,
+                                          const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns)
+    {
+        GLuint size = factors.GetRowCount();
+
+        if (row_permutation.size() != size)
+            return GL_FALSE;
+
+        if (represent_solutions_as_columns)
+        {
+            if (b.GetRowCount() != size)
+                return GL_FALSE;
+
+            x = b;
+
+            CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size * x.GetColumnCount(), x.GetColumnCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint k = 0; k < static_cast<GLint>(x.GetColumnCount()); k++)
+            {
+                _Solve(factors, row_permutation, x.GetColumnPointer(k), x.GetLeadingDimension());
+            }
+        }
+        else
+        {
+            if (b.GetColumnCount() != size)
+                return GL_FALSE;
+
+            x = b;
+
+            CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size * x.GetRowCount(), x.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint k = 0; k < static_cast<GLint>(x.GetRowCount()); k++)
+            {
+                _Solve(factors, row_permutation, x.GetRowPointer(k), 1);
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    template <class T>
+    GLboolean LUFactorization::SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns) const
+    {
+        if (!_is_done)
+            return GL_FALSE;
+
+        return Substitute(_factors, _row_permutation, b, x, represent_solutions_as_columns);
+    }
+}
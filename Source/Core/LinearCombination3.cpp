@@ -1,6 +1,7 @@
 #include "LinearCombination3.h"
 #include "RealSquareMatrices.h"
 #include "Constants.h"
+#include "ParallelExecutionPolicies.h"
 
 using namespace cagd;
 using namespace std;
@@ -25,13 +26,25 @@ LinearCombination3::Derivatives& LinearCombination3::Derivatives::operator =(con
     return *this;
 }
 
+// move constructor
+LinearCombination3::Derivatives::Derivatives(LinearCombination3::Derivatives&& d) noexcept: ColumnMatrix<DCoordinate3>(std::move(d))
+{
+}
+
+// move assignment operator
+LinearCombination3::Derivatives& LinearCombination3::Derivatives::operator =(LinearCombination3::Derivatives&& rhs) noexcept
+{
+    ColumnMatrix<DCoordinate3>::operator =(std::move(rhs));
+    return *this;
+}
+
 // set every derivative to null vector
 GLvoid LinearCombination3::Derivatives::LoadNullVectors()
 {
-    for (GLuint i = 0; i < _data.size(); ++i)
+    for (GLuint i = 0; i < _row_count; ++i)
     {
         for (GLuint j = 0; j < 3; ++j)
-            _data[i][0][j] = 0.0;
+            (*this)[i][j] = 0.0;
     }
 }
 
@@ -215,7 +228,9 @@ GenericCurve3* LinearCombination3::GenerateImage(GLuint max_order_of_derivatives
 
     GLboolean aborted = GL_FALSE;
 
-#pragma omp parallel for
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(div_point_count) * (max_order_of_derivatives + 1) * _data.GetRowCount(), div_point_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i = 0; i < static_cast<GLint>(div_point_count); i++)
     {
 #pragma omp flush(aborted)
@@ -255,7 +270,9 @@ GenericCurve3* LinearCombination3::GenerateImageInAGivenInterval(GLuint max_orde
 
     GLboolean aborted = GL_FALSE;
 
-#pragma omp parallel for
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(div_point_count) * (max_order_of_derivatives + 1) * _data.GetRowCount(), div_point_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i = 0; i < static_cast<GLint> (div_point_count); i++)
     {
 #pragma omp flush(aborted)
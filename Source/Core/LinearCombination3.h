@@ -24,6 +24,10 @@ namespace cagd
             // assignment operator
             Derivatives& operator =(const Derivatives& rhs);
 
+            // move constructor and move assignment operator
+            Derivatives(Derivatives&& d) noexcept;
+            Derivatives& operator =(Derivatives&& rhs) noexcept;
+
             // all inherited Descartes coordinates are set to the null vector
             GLvoid LoadNullVectors();
         };
@@ -1,12 +1,95 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <utility>
 #include <vector>
 #include <GL/glew.h>
 #include <QTextStream>
 
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <malloc.h>
+#endif
+
 namespace cagd
 {
+// byte alignment of the first element of each matrix buffer (a cache line, which is also a multiple of the AVX/AVX-512 register width)
+static const std::size_t MATRIX_ALIGNMENT = 64;
+
+//---------------------------------------------------------------------------------
+// template class AlignedAllocator
+//
+// a minimal standard allocator that returns memory blocks the addresses of which
+// are multiples of Alignment; it is used as the storage engine of the template
+// class Matrix, in order to ensure that every row of a real matrix starts at
+// a cache line boundary
+//---------------------------------------------------------------------------------
+template <typename T, std::size_t Alignment = MATRIX_ALIGNMENT>
+class AlignedAllocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() {}
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        if (!count)
+            return nullptr;
+
+        void *block = nullptr;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+        block = _aligned_malloc(count * sizeof(T), Alignment);
+#else
+        if (posix_memalign(&block, Alignment, count * sizeof(T)))
+            block = nullptr;
+#endif
+        if (!block)
+            throw std::bad_alloc();
+
+        return static_cast<T*>(block);
+    }
+
+    void deallocate(T* block, std::size_t)
+    {
+#if defined(_MSC_VER) || defined(__MINGW32__)
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator ==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+    return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator !=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+    return false;
+}
+
 // forward declaration of template class Matrix
 template <typename T>
 class Matrix;
@@ -55,9 +138,15 @@ class Matrix
     friend QTextStream& operator >> <T>(QTextStream& lhs, Matrix<T>& rhs);
 
 protected:
-    GLuint                          _row_count;
-    GLuint                          _column_count;
-    std::vector< std::vector<T> >   _data;
+    GLuint                                  _row_count;
+    GLuint                                  _column_count;
+    GLuint                                  _leading_dimension; // distance (in elements) between the first elements of consecutive rows
+    std::vector<T, AlignedAllocator<T> >    _data;              // single contiguous row-major buffer: element (i, j) is stored at _data[i * _leading_dimension + j]
+
+    // if the elements of type T tile a cache line, rows that are at least one cache line wide
+    // are padded to a multiple of the cache line, otherwise the rows are stored tightly
+    static GLuint _LeadingDimension(GLuint column_count);
+
 public:
     // special constructor (can also be used as a default constructor)
     Matrix(GLuint row_count = 1, GLuint column_count = 1);
@@ -68,6 +157,12 @@ public:
     // assignment operator
     Matrix& operator =(const Matrix& m);
 
+    // move constructor: takes over the storage of m, which becomes an empty matrix
+    Matrix(Matrix&& m) noexcept;
+
+    // move assignment operator: exchanges the storages
+    Matrix& operator =(Matrix&& m) noexcept;
+
     // addition operator
     const Matrix operator +(const Matrix& m) const;
 
@@ -80,6 +175,16 @@ public:
     // get dimensions
     GLuint GetRowCount() const;
     GLuint GetColumnCount() const;
+    GLuint GetLeadingDimension() const;
+
+    // raw access to the row-major storage:
+    // - consecutive elements of a row are adjacent in memory;
+    // - consecutive elements of a column are GetLeadingDimension() elements apart
+    T* GetRowPointer(GLuint row);
+    const T* GetRowPointer(GLuint row) const;
+
+    T* GetColumnPointer(GLuint column);
+    const T* GetColumnPointer(GLuint column) const;
 
     // set dimensions
     virtual GLboolean ResizeRows(GLuint row_count);
@@ -171,15 +276,32 @@ public:
 // homework: implementation of template class Matrix
 //--------------------------------------------------
 
+template <typename T>
+GLuint Matrix<T>::_LeadingDimension(GLuint column_count)
+{
+    if (sizeof(T) > MATRIX_ALIGNMENT || MATRIX_ALIGNMENT % sizeof(T))
+        return column_count;
+
+    GLuint elements_per_line = static_cast<GLuint>(MATRIX_ALIGNMENT / sizeof(T));
+
+    if (column_count < elements_per_line)
+        return column_count;
+
+    return (column_count + elements_per_line - 1) / elements_per_line * elements_per_line;
+}
+
 template <typename T>
 Matrix<T>:: Matrix(GLuint row_count, GLuint column_count):
-    _row_count(row_count), _column_count(column_count), _data(row_count, std::vector<T>(column_count))
+    _row_count(row_count), _column_count(column_count),
+    _leading_dimension(_LeadingDimension(column_count)),
+    _data(static_cast<std::size_t>(row_count) * _leading_dimension)
 {
 }
 
 template <typename T>
 Matrix<T>::Matrix(const Matrix& m):
-    _row_count(m._row_count), _column_count(m._column_count), _data(m._data)
+    _row_count(m._row_count), _column_count(m._column_count),
+    _leading_dimension(m._leading_dimension), _data(m._data)
 {
 }
 
@@ -190,21 +312,45 @@ Matrix<T>& Matrix<T>::operator =(const Matrix<T>& m)
     {
         _row_count = m._row_count;
         _column_count = m._column_count;
+        _leading_dimension = m._leading_dimension;
         _data = m._data;
     }
     return *this;
 }
 
+// move constructor
+template <typename T>
+Matrix<T>::Matrix(Matrix&& m) noexcept:
+    _row_count(m._row_count), _column_count(m._column_count),
+    _leading_dimension(m._leading_dimension), _data(std::move(m._data))
+{
+    m._row_count = m._column_count = m._leading_dimension = 0;
+}
+
+// move assignment operator
+template <typename T>
+Matrix<T>& Matrix<T>::operator =(Matrix<T>&& m) noexcept
+{
+    if (this != &m)
+    {
+        std::swap(_row_count, m._row_count);
+        std::swap(_column_count, m._column_count);
+        std::swap(_leading_dimension, m._leading_dimension);
+        _data.swap(m._data);
+    }
+    return *this;
+}
+
 template <typename T>
 T& Matrix<T>::operator ()(GLuint row, GLuint column)
 {
-    return _data[row][column];
+    return _data[static_cast<std::size_t>(row) * _leading_dimension + column];
 }
 
 template <typename T>
 T Matrix<T>::operator ()(GLuint row, GLuint column) const
 {
-    return _data[row][column];
+    return _data[static_cast<std::size_t>(row) * _leading_dimension + column];
 }
 
 template <typename T>
@@ -219,10 +365,41 @@ GLuint Matrix<T>::GetColumnCount() const
     return _column_count;
 }
 
+template <typename T>
+GLuint Matrix<T>::GetLeadingDimension() const
+{
+    return _leading_dimension;
+}
+
+template <typename T>
+T* Matrix<T>::GetRowPointer(GLuint row)
+{
+    return _data.data() + static_cast<std::size_t>(row) * _leading_dimension;
+}
+
+template <typename T>
+const T* Matrix<T>::GetRowPointer(GLuint row) const
+{
+    return _data.data() + static_cast<std::size_t>(row) * _leading_dimension;
+}
+
+template <typename T>
+T* Matrix<T>::GetColumnPointer(GLuint column)
+{
+    return _data.data() + column;
+}
+
+template <typename T>
+const T* Matrix<T>::GetColumnPointer(GLuint column) const
+{
+    return _data.data() + column;
+}
+
 template <typename T>
 GLboolean Matrix<T>::ResizeRows(GLuint row_count)
 {
-    _data.resize(row_count, std::vector<T>(_column_count));
+    // rows are stored one after the other, therefore the existing rows keep their place
+    _data.resize(static_cast<std::size_t>(row_count) * _leading_dimension);
     _row_count = row_count;
 
     return GL_TRUE;
@@ -231,13 +408,21 @@ GLboolean Matrix<T>::ResizeRows(GLuint row_count)
 template <typename T>
 GLboolean Matrix<T>::ResizeColumns(GLuint column_count)
 {
-    typename std::vector< std::vector<T> >::iterator it;
-    for(it = _data.begin(); it != _data.end(); ++it)
+    GLuint leading_dimension = _LeadingDimension(column_count);
+
+    // the rows have to be repacked into a new buffer
+    std::vector<T, AlignedAllocator<T> > data(static_cast<std::size_t>(_row_count) * leading_dimension);
+
+    GLuint common_column_count = std::min(_column_count, column_count);
+    for (GLuint i = 0; i < _row_count; i++)
     {
-        (*it).resize(column_count);
+        std::copy(GetRowPointer(i), GetRowPointer(i) + common_column_count,
+                  data.data() + static_cast<std::size_t>(i) * leading_dimension);
     }
 
+    _data.swap(data);
     _column_count = column_count;
+    _leading_dimension = leading_dimension;
 
     return GL_TRUE;
 }
@@ -248,7 +433,7 @@ GLboolean Matrix<T>::SetRow(GLuint index, const RowMatrix<T>& row)
     if(index >= _row_count || row._column_count != _column_count)
         return GL_FALSE;
 
-    _data[index] = row._data[0];
+    std::copy(row.GetRowPointer(0), row.GetRowPointer(0) + _column_count, GetRowPointer(index));
     return GL_TRUE;
 }
 
@@ -259,7 +444,7 @@ GLboolean Matrix<T>::SetColumn(GLuint index, const ColumnMatrix<T>& column)
         return GL_FALSE;
 
     for(GLuint i = 0; i<_row_count; i++){
-        _data[i][index] = column._data[i][0];
+        (*this)(i, index) = column(i);
     }
 
     return GL_TRUE;
@@ -269,7 +454,7 @@ template <typename T>
 Matrix<T>::~Matrix()
 {
     _data.clear();
-    _row_count = _column_count = 0;
+    _row_count = _column_count = _leading_dimension = 0;
 }
 
 //-----------------------------------------------------
@@ -282,25 +467,25 @@ RowMatrix<T>::RowMatrix(GLuint column_count) : Matrix<T> (1, column_count) {}
 template <typename T>
 T& RowMatrix<T>::operator ()(GLuint column)
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 template <typename T>
 T& RowMatrix<T>::operator [](GLuint column)
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 template <typename T>
 T RowMatrix<T>::operator ()(GLuint column) const
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 template <typename T>
 T RowMatrix<T>::operator [](GLuint column) const
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 template <typename T>
@@ -319,25 +504,25 @@ ColumnMatrix<T>::ColumnMatrix(GLuint row_count) : Matrix<T>(row_count, 1) {}
 template <typename T>
 T& ColumnMatrix<T>::operator ()(GLuint row)
 {
-    return this->_data[row][0];
+    return this->_data[static_cast<std::size_t>(row) * this->_leading_dimension];
 }
 
 template <typename T>
 T& ColumnMatrix<T>::operator [](GLuint row)
 {
-    return this->_data[row][0];
+    return this->_data[static_cast<std::size_t>(row) * this->_leading_dimension];
 }
 
 template <typename T>
 T ColumnMatrix<T>::operator ()(GLuint row) const
 {
-    return this->_data[row][0];
+    return this->_data[static_cast<std::size_t>(row) * this->_leading_dimension];
 }
 
 template <typename T>
 T ColumnMatrix<T>::operator [](GLuint row) const
 {
-    return this->_data[row][0];
+    return this->_data[static_cast<std::size_t>(row) * this->_leading_dimension];
 }
 
 template <typename T>
@@ -402,12 +587,11 @@ template <typename T>
 std::ostream& operator <<(std::ostream& lhs, const Matrix<T>& rhs)
 {
     lhs << rhs._row_count << " " << rhs._column_count << std::endl;
-    for (typename std::vector< std::vector<T> >::const_iterator row = rhs._data.begin();
-         row != rhs._data.end(); ++row)
+    for (GLuint i = 0; i < rhs._row_count; i++)
     {
-        for (typename std::vector<T>::const_iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs << *column << " ";
+        const T *row = rhs.GetRowPointer(i);
+        for (GLuint j = 0; j < rhs._column_count; j++)
+            lhs << row[j] << " ";
         lhs << std::endl;
     }
     return lhs;
@@ -418,14 +602,13 @@ template <typename T>
 std::istream& operator >>(std::istream& lhs, Matrix<T>& rhs)
 {
     lhs >> rhs._row_count >> rhs._column_count;
-    rhs._data.resize(rhs._row_count);
-    for (typename std::vector< std::vector<T> >::iterator row = rhs._data.begin();
-         row != rhs._data.end(); ++row)
+    rhs._leading_dimension = Matrix<T>::_LeadingDimension(rhs._column_count);
+    rhs._data.assign(static_cast<std::size_t>(rhs._row_count) * rhs._leading_dimension, T());
+    for (GLuint i = 0; i < rhs._row_count; i++)
     {
-        row->resize(rhs._column_count);
-        for (typename std::vector<T>::iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs >> *column;
+        T *row = rhs.GetRowPointer(i);
+        for (GLuint j = 0; j < rhs._column_count; j++)
+            lhs >> row[j];
     }
     return lhs;
 }
@@ -436,12 +619,11 @@ template <typename T>
 QTextStream& operator <<(QTextStream& lhs, const Matrix<T>& rhs)
 {
     lhs << rhs._row_count << ' ' << rhs._column_count << '\n';
-    for (typename std::vector< std::vector<T> >::const_iterator row = rhs._data.begin();
-         row != rhs._data.end(); ++row)
+    for (GLuint i = 0; i < rhs._row_count; i++)
     {
-        for (typename std::vector<T>::const_iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs << *column << ' ';
+        const T *row = rhs.GetRowPointer(i);
+        for (GLuint j = 0; j < rhs._column_count; j++)
+            lhs << row[j] << ' ';
         lhs << '\n';
     }
     return lhs;
@@ -452,14 +634,13 @@ template <typename T>
 QTextStream& operator >>(QTextStream& lhs, Matrix<T>& rhs)
 {
     lhs >> rhs._row_count >> rhs._column_count;
-    rhs._data.resize(rhs._row_count);
-    for (typename std::vector< std::vector<T> >::iterator row = rhs._data.begin();
-         row != rhs._data.end(); ++row)
+    rhs._leading_dimension = Matrix<T>::_LeadingDimension(rhs._column_count);
+    rhs._data.assign(static_cast<std::size_t>(rhs._row_count) * rhs._leading_dimension, T());
+    for (GLuint i = 0; i < rhs._row_count; i++)
     {
-        row->resize(rhs._column_count);
-        for (typename std::vector<T>::iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs >> *column;
+        T *row = rhs.GetRowPointer(i);
+        for (GLuint j = 0; j < rhs._column_count; j++)
+            lhs >> row[j];
     }
     return lhs;
 }
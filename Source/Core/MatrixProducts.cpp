@@ -0,0 +1,684 @@
+#include "MatrixProducts.h"
+#include "ParallelExecutionPolicies.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CAGD_X86_MATRIX_PRODUCT_KERNELS
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CAGD_TARGET(instruction_sets) __attribute__((target(instruction_sets)))
+#else
+#define CAGD_TARGET(instruction_sets)
+#endif
+
+using namespace std;
+
+namespace cagd
+{
+// sizes of the tiles: MATRIX_PRODUCT_ROW_BLOCK rows of A and C, MATRIX_PRODUCT_DEPTH_BLOCK columns of A (rows of B),
+// MATRIX_PRODUCT_COLUMN_BLOCK columns of B and C
+static const GLuint MATRIX_PRODUCT_ROW_BLOCK    = 64;
+static const GLuint MATRIX_PRODUCT_DEPTH_BLOCK  = 256;
+static const GLuint MATRIX_PRODUCT_COLUMN_BLOCK = 512;
+
+// the (i_begin : i_end, j_begin : j_end) tile of C is updated by the product of the tiles
+// (i_begin : i_end, p_begin : p_end) and (p_begin : p_end, j_begin : j_end) of A and B, respectively
+template <class Real>
+using MatrixProductBlockKernel = GLvoid (*)(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const Real *A, size_t lda, const Real *B, size_t ldb, Real *C, size_t ldc);
+
+// rows and columns that do not fill a whole micro-kernel
+template <class Real>
+static inline GLvoid AccumulateMatrixProductEdge(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const Real *A, size_t lda, const Real *B, size_t ldb, Real *C, size_t ldc)
+{
+    for (GLuint i = i_begin; i < i_end; i++)
+    {
+        const Real *a = A + i * lda;
+        Real       *c = C + i * ldc;
+
+        for (GLuint p = p_begin; p < p_end; p++)
+        {
+            Real        a_ip = a[p];
+            const Real *b    = B + p * ldb;
+
+            for (GLuint j = j_begin; j < j_end; j++)
+            {
+                c[j] += a_ip * b[j];
+            }
+        }
+    }
+}
+
+template <class Real>
+static GLvoid AccumulateMatrixProductBlockScalar(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const Real *A, size_t lda, const Real *B, size_t ldb, Real *C, size_t ldc)
+{
+    GLuint i = i_begin;
+
+    for (; i + 4 <= i_end; i += 4)
+    {
+        GLuint j = j_begin;
+
+        for (; j + 4 <= j_end; j += 4)
+        {
+            Real c[4][4];
+
+            for (GLuint r = 0; r < 4; r++)
+            {
+                for (GLuint s = 0; s < 4; s++)
+                {
+                    c[r][s] = C[(i + r) * ldc + j + s];
+                }
+            }
+
+            for (GLuint p = p_begin; p < p_end; p++)
+            {
+                const Real *b = B + p * ldb + j;
+
+                for (GLuint r = 0; r < 4; r++)
+                {
+                    Real a = A[(i + r) * lda + p];
+
+                    for (GLuint s = 0; s < 4; s++)
+                    {
+                        c[r][s] += a * b[s];
+                    }
+                }
+            }
+
+            for (GLuint r = 0; r < 4; r++)
+            {
+                for (GLuint s = 0; s < 4; s++)
+                {
+                    C[(i + r) * ldc + j + s] = c[r][s];
+                }
+            }
+        }
+
+        AccumulateMatrixProductEdge(i, i + 4, j, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+    }
+
+    AccumulateMatrixProductEdge(i, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+}
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+CAGD_TARGET("avx2,fma")
+static GLvoid AccumulateMatrixProductBlockAVX2(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const GLdouble *A, size_t lda, const GLdouble *B, size_t ldb, GLdouble *C, size_t ldc)
+{
+    GLuint i = i_begin;
+
+    for (; i + 4 <= i_end; i += 4)
+    {
+        GLuint j = j_begin;
+
+        // 4 x 8 micro-kernel: 8 accumulators, 2 registers for the row of B
+        for (; j + 8 <= j_end; j += 8)
+        {
+            GLdouble *c_0 = C + i * ldc + j, *c_1 = c_0 + ldc, *c_2 = c_1 + ldc, *c_3 = c_2 + ldc;
+
+            __m256d c_00 = _mm256_loadu_pd(c_0), c_01 = _mm256_loadu_pd(c_0 + 4);
+            __m256d c_10 = _mm256_loadu_pd(c_1), c_11 = _mm256_loadu_pd(c_1 + 4);
+            __m256d c_20 = _mm256_loadu_pd(c_2), c_21 = _mm256_loadu_pd(c_2 + 4);
+            __m256d c_30 = _mm256_loadu_pd(c_3), c_31 = _mm256_loadu_pd(c_3 + 4);
+
+            const GLdouble *a_0 = A + i * lda, *a_1 = a_0 + lda, *a_2 = a_1 + lda, *a_3 = a_2 + lda;
+
+            for (GLuint p = p_begin; p < p_end; p++)
+            {
+                const GLdouble *b = B + p * ldb + j;
+                __m256d b_0 = _mm256_loadu_pd(b), b_1 = _mm256_loadu_pd(b + 4);
+                __m256d a;
+
+                a = _mm256_broadcast_sd(a_0 + p); c_00 = _mm256_fmadd_pd(a, b_0, c_00); c_01 = _mm256_fmadd_pd(a, b_1, c_01);
+                a = _mm256_broadcast_sd(a_1 + p); c_10 = _mm256_fmadd_pd(a, b_0, c_10); c_11 = _mm256_fmadd_pd(a, b_1, c_11);
+                a = _mm256_broadcast_sd(a_2 + p); c_20 = _mm256_fmadd_pd(a, b_0, c_20); c_21 = _mm256_fmadd_pd(a, b_1, c_21);
+                a = _mm256_broadcast_sd(a_3 + p); c_30 = _mm256_fmadd_pd(a, b_0, c_30); c_31 = _mm256_fmadd_pd(a, b_1, c_31);
+            }
+
+            _mm256_storeu_pd(c_0, c_00); _mm256_storeu_pd(c_0 + 4, c_01);
+            _mm256_storeu_pd(c_1, c_10); _mm256_storeu_pd(c_1 + 4, c_11);
+            _mm256_storeu_pd(c_2, c_20); _mm256_storeu_pd(c_2 + 4, c_21);
+            _mm256_storeu_pd(c_3, c_30); _mm256_storeu_pd(c_3 + 4, c_31);
+        }
+
+        AccumulateMatrixProductEdge(i, i + 4, j, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+    }
+
+    AccumulateMatrixProductEdge(i, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+}
+
+CAGD_TARGET("avx512f")
+static GLvoid AccumulateMatrixProductBlockAVX512(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const GLdouble *A, size_t lda, const GLdouble *B, size_t ldb, GLdouble *C, size_t ldc)
+{
+    GLuint i = i_begin;
+
+    for (; i + 4 <= i_end; i += 4)
+    {
+        GLuint j = j_begin;
+
+        // 4 x 16 micro-kernel: 8 accumulators, 2 registers for the row of B
+        for (; j + 16 <= j_end; j += 16)
+        {
+            GLdouble *c_0 = C + i * ldc + j, *c_1 = c_0 + ldc, *c_2 = c_1 + ldc, *c_3 = c_2 + ldc;
+
+            __m512d c_00 = _mm512_loadu_pd(c_0), c_01 = _mm512_loadu_pd(c_0 + 8);
+            __m512d c_10 = _mm512_loadu_pd(c_1), c_11 = _mm512_loadu_pd(c_1 + 8);
+            __m512d c_20 = _mm512_loadu_pd(c_2), c_21 = _mm512_loadu_pd(c_2 + 8);
+            __m512d c_30 = _mm512_loadu_pd(c_3), c_31 = _mm512_loadu_pd(c_3 + 8);
+
+            const GLdouble *a_0 = A + i * lda, *a_1 = a_0 + lda, *a_2 = a_1 + lda, *a_3 = a_2 + lda;
+
+            for (GLuint p = p_begin; p < p_end; p++)
+            {
+                const GLdouble *b = B + p * ldb + j;
+                __m512d b_0 = _mm512_loadu_pd(b), b_1 = _mm512_loadu_pd(b + 8);
+                __m512d a;
+
+                a = _mm512_set1_pd(a_0[p]); c_00 = _mm512_fmadd_pd(a, b_0, c_00); c_01 = _mm512_fmadd_pd(a, b_1, c_01);
+                a = _mm512_set1_pd(a_1[p]); c_10 = _mm512_fmadd_pd(a, b_0, c_10); c_11 = _mm512_fmadd_pd(a, b_1, c_11);
+                a = _mm512_set1_pd(a_2[p]); c_20 = _mm512_fmadd_pd(a, b_0, c_20); c_21 = _mm512_fmadd_pd(a, b_1, c_21);
+                a = _mm512_set1_pd(a_3[p]); c_30 = _mm512_fmadd_pd(a, b_0, c_30); c_31 = _mm512_fmadd_pd(a, b_1, c_31);
+            }
+
+            _mm512_storeu_pd(c_0, c_00); _mm512_storeu_pd(c_0 + 8, c_01);
+            _mm512_storeu_pd(c_1, c_10); _mm512_storeu_pd(c_1 + 8, c_11);
+            _mm512_storeu_pd(c_2, c_20); _mm512_storeu_pd(c_2 + 8, c_21);
+            _mm512_storeu_pd(c_3, c_30); _mm512_storeu_pd(c_3 + 8, c_31);
+        }
+
+        AccumulateMatrixProductEdge(i, i + 4, j, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+    }
+
+    AccumulateMatrixProductEdge(i, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+}
+
+CAGD_TARGET("avx2,fma")
+static GLvoid AccumulateSinglePrecisionMatrixProductBlockAVX2(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const GLfloat *A, size_t lda, const GLfloat *B, size_t ldb, GLfloat *C, size_t ldc)
+{
+    GLuint i = i_begin;
+
+    for (; i + 4 <= i_end; i += 4)
+    {
+        GLuint j = j_begin;
+
+        // 4 x 16 micro-kernel: 8 accumulators, 2 registers for the row of B
+        for (; j + 16 <= j_end; j += 16)
+        {
+            GLfloat *c_0 = C + i * ldc + j, *c_1 = c_0 + ldc, *c_2 = c_1 + ldc, *c_3 = c_2 + ldc;
+
+            __m256 c_00 = _mm256_loadu_ps(c_0), c_01 = _mm256_loadu_ps(c_0 + 8);
+            __m256 c_10 = _mm256_loadu_ps(c_1), c_11 = _mm256_loadu_ps(c_1 + 8);
+            __m256 c_20 = _mm256_loadu_ps(c_2), c_21 = _mm256_loadu_ps(c_2 + 8);
+            __m256 c_30 = _mm256_loadu_ps(c_3), c_31 = _mm256_loadu_ps(c_3 + 8);
+
+            const GLfloat *a_0 = A + i * lda, *a_1 = a_0 + lda, *a_2 = a_1 + lda, *a_3 = a_2 + lda;
+
+            for (GLuint p = p_begin; p < p_end; p++)
+            {
+                const GLfloat *b = B + p * ldb + j;
+                __m256 b_0 = _mm256_loadu_ps(b), b_1 = _mm256_loadu_ps(b + 8);
+                __m256 a;
+
+                a = _mm256_broadcast_ss(a_0 + p); c_00 = _mm256_fmadd_ps(a, b_0, c_00); c_01 = _mm256_fmadd_ps(a, b_1, c_01);
+                a = _mm256_broadcast_ss(a_1 + p); c_10 = _mm256_fmadd_ps(a, b_0, c_10); c_11 = _mm256_fmadd_ps(a, b_1, c_11);
+                a = _mm256_broadcast_ss(a_2 + p); c_20 = _mm256_fmadd_ps(a, b_0, c_20); c_21 = _mm256_fmadd_ps(a, b_1, c_21);
+                a = _mm256_broadcast_ss(a_3 + p); c_30 = _mm256_fmadd_ps(a, b_0, c_30); c_31 = _mm256_fmadd_ps(a, b_1, c_31);
+            }
+
+            _mm256_storeu_ps(c_0, c_00); _mm256_storeu_ps(c_0 + 8, c_01);
+            _mm256_storeu_ps(c_1, c_10); _mm256_storeu_ps(c_1 + 8, c_11);
+            _mm256_storeu_ps(c_2, c_20); _mm256_storeu_ps(c_2 + 8, c_21);
+            _mm256_storeu_ps(c_3, c_30); _mm256_storeu_ps(c_3 + 8, c_31);
+        }
+
+        AccumulateMatrixProductEdge(i, i + 4, j, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+    }
+
+    AccumulateMatrixProductEdge(i, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+}
+
+CAGD_TARGET("avx512f")
+static GLvoid AccumulateSinglePrecisionMatrixProductBlockAVX512(
+        GLuint i_begin, GLuint i_end, GLuint j_begin, GLuint j_end, GLuint p_begin, GLuint p_end,
+        const GLfloat *A, size_t lda, const GLfloat *B, size_t ldb, GLfloat *C, size_t ldc)
+{
+    GLuint i = i_begin;
+
+    for (; i + 4 <= i_end; i += 4)
+    {
+        GLuint j = j_begin;
+
+        // 4 x 32 micro-kernel: 8 accumulators, 2 registers for the row of B
+        for (; j + 32 <= j_end; j += 32)
+        {
+            GLfloat *c_0 = C + i * ldc + j, *c_1 = c_0 + ldc, *c_2 = c_1 + ldc, *c_3 = c_2 + ldc;
+
+            __m512 c_00 = _mm512_loadu_ps(c_0), c_01 = _mm512_loadu_ps(c_0 + 16);
+            __m512 c_10 = _mm512_loadu_ps(c_1), c_11 = _mm512_loadu_ps(c_1 + 16);
+            __m512 c_20 = _mm512_loadu_ps(c_2), c_21 = _mm512_loadu_ps(c_2 + 16);
+            __m512 c_30 = _mm512_loadu_ps(c_3), c_31 = _mm512_loadu_ps(c_3 + 16);
+
+            const GLfloat *a_0 = A + i * lda, *a_1 = a_0 + lda, *a_2 = a_1 + lda, *a_3 = a_2 + lda;
+
+            for (GLuint p = p_begin; p < p_end; p++)
+            {
+                const GLfloat *b = B + p * ldb + j;
+                __m512 b_0 = _mm512_loadu_ps(b), b_1 = _mm512_loadu_ps(b + 16);
+                __m512 a;
+
+                a = _mm512_set1_ps(a_0[p]); c_00 = _mm512_fmadd_ps(a, b_0, c_00); c_01 = _mm512_fmadd_ps(a, b_1, c_01);
+                a = _mm512_set1_ps(a_1[p]); c_10 = _mm512_fmadd_ps(a, b_0, c_10); c_11 = _mm512_fmadd_ps(a, b_1, c_11);
+                a = _mm512_set1_ps(a_2[p]); c_20 = _mm512_fmadd_ps(a, b_0, c_20); c_21 = _mm512_fmadd_ps(a, b_1, c_21);
+                a = _mm512_set1_ps(a_3[p]); c_30 = _mm512_fmadd_ps(a, b_0, c_30); c_31 = _mm512_fmadd_ps(a, b_1, c_31);
+            }
+
+            _mm512_storeu_ps(c_0, c_00); _mm512_storeu_ps(c_0 + 16, c_01);
+            _mm512_storeu_ps(c_1, c_10); _mm512_storeu_ps(c_1 + 16, c_11);
+            _mm512_storeu_ps(c_2, c_20); _mm512_storeu_ps(c_2 + 16, c_21);
+            _mm512_storeu_ps(c_3, c_30); _mm512_storeu_ps(c_3 + 16, c_31);
+        }
+
+        AccumulateMatrixProductEdge(i, i + 4, j, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+    }
+
+    AccumulateMatrixProductEdge(i, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+}
+
+// checks the processor and whether the operating system saves the extended registers
+static MatrixProductKernel DetectMatrixProductKernel()
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return SCALAR_MATRIX_PRODUCT_KERNEL;
+
+    __cpuid(info, 1);
+    GLboolean os_xsave = (info[2] & (1 << 27)) != 0;
+    GLboolean fma      = (info[2] & (1 << 12)) != 0;
+    if (!os_xsave)
+        return SCALAR_MATRIX_PRODUCT_KERNEL;
+
+    unsigned long long xcr0 = _xgetbv(0);
+
+    __cpuid(info, 7);
+    GLboolean avx2    = (info[1] & (1 << 5)) != 0;
+    GLboolean avx512f = (info[1] & (1 << 16)) != 0;
+
+    if (avx512f && (xcr0 & 0xE6) == 0xE6)
+        return AVX512_MATRIX_PRODUCT_KERNEL;
+
+    if (avx2 && fma && (xcr0 & 0x6) == 0x6)
+        return AVX2_MATRIX_PRODUCT_KERNEL;
+
+    return SCALAR_MATRIX_PRODUCT_KERNEL;
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512_MATRIX_PRODUCT_KERNEL;
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return AVX2_MATRIX_PRODUCT_KERNEL;
+
+    return SCALAR_MATRIX_PRODUCT_KERNEL;
+#else
+    return SCALAR_MATRIX_PRODUCT_KERNEL;
+#endif
+}
+#endif
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+// the best kernel of the processor, unless another one is selected
+static MatrixProductKernel& SelectedMatrixProductKernel()
+{
+    static MatrixProductKernel kernel = DetectMatrixProductKernel();
+    return kernel;
+}
+#endif
+
+MatrixProductKernel ActiveMatrixProductKernel()
+{
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    return SelectedMatrixProductKernel();
+#else
+    return SCALAR_MATRIX_PRODUCT_KERNEL;
+#endif
+}
+
+GLboolean SelectMatrixProductKernel(MatrixProductKernel kernel)
+{
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    // the instruction sets are nested, i.e., a processor that supports AVX-512 also supports AVX2 and FMA
+    static const MatrixProductKernel best_kernel = DetectMatrixProductKernel();
+
+    if (kernel > best_kernel)
+        return GL_FALSE;
+
+    SelectedMatrixProductKernel() = kernel;
+    return GL_TRUE;
+#else
+    return kernel == SCALAR_MATRIX_PRODUCT_KERNEL;
+#endif
+}
+
+// the row blocks of C are disjoint, small products are evaluated by a single thread
+template <class Real>
+static GLvoid AccumulateTiledMatrixProduct(
+        MatrixProductBlockKernel<Real> kernel,
+        GLuint m, GLuint n, GLuint k,
+        const Real *A, size_t lda,
+        const Real *B, size_t ldb,
+        Real *C, size_t ldc)
+{
+    GLint row_block_count = static_cast<GLint>((m + MATRIX_PRODUCT_ROW_BLOCK - 1) / MATRIX_PRODUCT_ROW_BLOCK);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(m) * n * k, row_block_count);
+
+#pragma omp parallel for schedule(dynamic) if (thread_count > 1) num_threads(thread_count)
+    for (GLint block = 0; block < row_block_count; block++)
+    {
+        GLuint i_begin = static_cast<GLuint>(block) * MATRIX_PRODUCT_ROW_BLOCK;
+        GLuint i_end   = (i_begin + MATRIX_PRODUCT_ROW_BLOCK < m) ? i_begin + MATRIX_PRODUCT_ROW_BLOCK : m;
+
+        for (GLuint p_begin = 0; p_begin < k; p_begin += MATRIX_PRODUCT_DEPTH_BLOCK)
+        {
+            GLuint p_end = (p_begin + MATRIX_PRODUCT_DEPTH_BLOCK < k) ? p_begin + MATRIX_PRODUCT_DEPTH_BLOCK : k;
+
+            for (GLuint j_begin = 0; j_begin < n; j_begin += MATRIX_PRODUCT_COLUMN_BLOCK)
+            {
+                GLuint j_end = (j_begin + MATRIX_PRODUCT_COLUMN_BLOCK < n) ? j_begin + MATRIX_PRODUCT_COLUMN_BLOCK : n;
+
+                kernel(i_begin, i_end, j_begin, j_end, p_begin, p_end, A, lda, B, ldb, C, ldc);
+            }
+        }
+    }
+}
+
+GLvoid AccumulateMatrixProduct(
+        GLuint m, GLuint n, GLuint k,
+        const GLdouble *A, size_t lda,
+        const GLdouble *B, size_t ldb,
+        GLdouble *C, size_t ldc)
+{
+    if (!m || !n || !k)
+        return;
+
+    MatrixProductBlockKernel<GLdouble> kernel = AccumulateMatrixProductBlockScalar<GLdouble>;
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        kernel = AccumulateMatrixProductBlockAVX512;
+        break;
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        kernel = AccumulateMatrixProductBlockAVX2;
+        break;
+    default:
+        break;
+    }
+#endif
+
+    AccumulateTiledMatrixProduct(kernel, m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+GLvoid AccumulateMatrixProduct(
+        GLuint m, GLuint n, GLuint k,
+        const GLfloat *A, size_t lda,
+        const GLfloat *B, size_t ldb,
+        GLfloat *C, size_t ldc)
+{
+    if (!m || !n || !k)
+        return;
+
+    MatrixProductBlockKernel<GLfloat> kernel = AccumulateMatrixProductBlockScalar<GLfloat>;
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        kernel = AccumulateSinglePrecisionMatrixProductBlockAVX512;
+        break;
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        kernel = AccumulateSinglePrecisionMatrixProductBlockAVX2;
+        break;
+    default:
+        break;
+    }
+#endif
+
+    AccumulateTiledMatrixProduct(kernel, m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+static GLvoid SubtractThreeDotProductsScalar(
+        GLuint count, const GLdouble *l,
+        const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s)
+{
+    // two independent partial sums per component hide the latency of the additions
+    GLdouble s_00 = 0.0, s_01 = 0.0, s_10 = 0.0, s_11 = 0.0, s_20 = 0.0, s_21 = 0.0;
+
+    GLuint p = 0;
+    for (; p + 2 <= count; p += 2)
+    {
+        s_00 += l[p] * x_0[p]; s_01 += l[p + 1] * x_0[p + 1];
+        s_10 += l[p] * x_1[p]; s_11 += l[p + 1] * x_1[p + 1];
+        s_20 += l[p] * x_2[p]; s_21 += l[p + 1] * x_2[p + 1];
+    }
+
+    for (; p < count; p++)
+    {
+        s_00 += l[p] * x_0[p];
+        s_10 += l[p] * x_1[p];
+        s_20 += l[p] * x_2[p];
+    }
+
+    s[0] -= s_00 + s_01;
+    s[1] -= s_10 + s_11;
+    s[2] -= s_20 + s_21;
+}
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+CAGD_TARGET("avx2,fma")
+static inline GLdouble HorizontalSumAVX2(__m256d v)
+{
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+}
+
+CAGD_TARGET("avx2,fma")
+static GLvoid SubtractThreeDotProductsAVX2(
+        GLuint count, const GLdouble *l,
+        const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s)
+{
+    // each element of l is loaded once and multiplied by the three components
+    __m256d s_00 = _mm256_setzero_pd(), s_01 = _mm256_setzero_pd();
+    __m256d s_10 = _mm256_setzero_pd(), s_11 = _mm256_setzero_pd();
+    __m256d s_20 = _mm256_setzero_pd(), s_21 = _mm256_setzero_pd();
+
+    GLuint p = 0;
+    for (; p + 8 <= count; p += 8)
+    {
+        __m256d l_0 = _mm256_loadu_pd(l + p), l_1 = _mm256_loadu_pd(l + p + 4);
+
+        s_00 = _mm256_fmadd_pd(l_0, _mm256_loadu_pd(x_0 + p), s_00); s_01 = _mm256_fmadd_pd(l_1, _mm256_loadu_pd(x_0 + p + 4), s_01);
+        s_10 = _mm256_fmadd_pd(l_0, _mm256_loadu_pd(x_1 + p), s_10); s_11 = _mm256_fmadd_pd(l_1, _mm256_loadu_pd(x_1 + p + 4), s_11);
+        s_20 = _mm256_fmadd_pd(l_0, _mm256_loadu_pd(x_2 + p), s_20); s_21 = _mm256_fmadd_pd(l_1, _mm256_loadu_pd(x_2 + p + 4), s_21);
+    }
+
+    GLdouble r_0 = HorizontalSumAVX2(_mm256_add_pd(s_00, s_01));
+    GLdouble r_1 = HorizontalSumAVX2(_mm256_add_pd(s_10, s_11));
+    GLdouble r_2 = HorizontalSumAVX2(_mm256_add_pd(s_20, s_21));
+
+    for (; p < count; p++)
+    {
+        r_0 += l[p] * x_0[p];
+        r_1 += l[p] * x_1[p];
+        r_2 += l[p] * x_2[p];
+    }
+
+    s[0] -= r_0;
+    s[1] -= r_1;
+    s[2] -= r_2;
+}
+
+// folds the upper half onto the lower one, the masked extractions with a zeroed source avoid the undefined
+// source operands of _mm512_reduce_add_pd and of _mm512_castpd512_pd256 (which is an unmasked extraction in GCC)
+CAGD_TARGET("avx512f")
+static inline GLdouble HorizontalSumAVX512(__m512d v)
+{
+    return HorizontalSumAVX2(_mm256_add_pd(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, v, 0),
+                                           _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, v, 1)));
+}
+
+CAGD_TARGET("avx512f")
+static GLvoid SubtractThreeDotProductsAVX512(
+        GLuint count, const GLdouble *l,
+        const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s)
+{
+    __m512d s_0 = _mm512_setzero_pd(), s_1 = _mm512_setzero_pd(), s_2 = _mm512_setzero_pd();
+
+    GLuint p = 0;
+    for (; p + 8 <= count; p += 8)
+    {
+        __m512d l_p = _mm512_loadu_pd(l + p);
+
+        s_0 = _mm512_fmadd_pd(l_p, _mm512_loadu_pd(x_0 + p), s_0);
+        s_1 = _mm512_fmadd_pd(l_p, _mm512_loadu_pd(x_1 + p), s_1);
+        s_2 = _mm512_fmadd_pd(l_p, _mm512_loadu_pd(x_2 + p), s_2);
+    }
+
+    // the remaining elements are handled by a masked iteration
+    if (p < count)
+    {
+        __mmask8 mask = static_cast<__mmask8>((1u << (count - p)) - 1u);
+        __m512d  l_p  = _mm512_maskz_loadu_pd(mask, l + p);
+
+        s_0 = _mm512_fmadd_pd(l_p, _mm512_maskz_loadu_pd(mask, x_0 + p), s_0);
+        s_1 = _mm512_fmadd_pd(l_p, _mm512_maskz_loadu_pd(mask, x_1 + p), s_1);
+        s_2 = _mm512_fmadd_pd(l_p, _mm512_maskz_loadu_pd(mask, x_2 + p), s_2);
+    }
+
+    s[0] -= HorizontalSumAVX512(s_0);
+    s[1] -= HorizontalSumAVX512(s_1);
+    s[2] -= HorizontalSumAVX512(s_2);
+}
+#endif
+
+GLvoid SubtractThreeDotProducts(
+        GLuint count, const GLdouble *l,
+        const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s)
+{
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+        SubtractThreeDotProductsAVX512(count, l, x_0, x_1, x_2, s);
+        return;
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        SubtractThreeDotProductsAVX2(count, l, x_0, x_1, x_2, s);
+        return;
+    default:
+        break;
+    }
+#endif
+
+    SubtractThreeDotProductsScalar(count, l, x_0, x_1, x_2, s);
+}
+
+static GLvoid AccumulateInterleavedDotProductsScalar(GLuint count, const GLdouble *a, const GLdouble *xyz, GLdouble *s)
+{
+    GLdouble s_0 = 0.0, s_1 = 0.0, s_2 = 0.0;
+
+    for (GLuint p = 0; p < count; p++, xyz += 3)
+    {
+        GLdouble a_p = a[p];
+
+        s_0 += a_p * xyz[0];
+        s_1 += a_p * xyz[1];
+        s_2 += a_p * xyz[2];
+    }
+
+    s[0] += s_0;
+    s[1] += s_1;
+    s[2] += s_2;
+}
+
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+CAGD_TARGET("avx2,fma")
+static GLvoid AccumulateInterleavedDotProductsAVX2(GLuint count, const GLdouble *a, const GLdouble *xyz, GLdouble *s)
+{
+    // 4 consecutive triplets fill 3 registers: [x_0 y_0 z_0 x_1], [y_1 z_1 x_2 y_2], [z_2 x_3 y_3 z_3],
+    // the matching multipliers [a_0 a_0 a_0 a_1], [a_1 a_1 a_2 a_2], [a_2 a_3 a_3 a_3] are permutations of [a_0 a_1 a_2 a_3]
+    __m256d s_0 = _mm256_setzero_pd(), s_1 = _mm256_setzero_pd(), s_2 = _mm256_setzero_pd();
+
+    GLuint p = 0;
+    for (; p + 4 <= count; p += 4)
+    {
+        __m256d a_p = _mm256_loadu_pd(a + p);
+        const GLdouble *v = xyz + 3 * p;
+
+        s_0 = _mm256_fmadd_pd(_mm256_permute4x64_pd(a_p, 0x40), _mm256_loadu_pd(v), s_0);
+        s_1 = _mm256_fmadd_pd(_mm256_permute4x64_pd(a_p, 0xA5), _mm256_loadu_pd(v + 4), s_1);
+        s_2 = _mm256_fmadd_pd(_mm256_permute4x64_pd(a_p, 0xFE), _mm256_loadu_pd(v + 8), s_2);
+    }
+
+    alignas(32) GLdouble r_0[4], r_1[4], r_2[4];
+    _mm256_store_pd(r_0, s_0);
+    _mm256_store_pd(r_1, s_1);
+    _mm256_store_pd(r_2, s_2);
+
+    GLdouble t_0 = (r_0[0] + r_0[3]) + (r_1[2] + r_2[1]);
+    GLdouble t_1 = (r_0[1] + r_1[0]) + (r_1[3] + r_2[2]);
+    GLdouble t_2 = (r_0[2] + r_1[1]) + (r_2[0] + r_2[3]);
+
+    // the remaining triplets are not handed over to the scalar kernel, since calling non-VEX code
+    // with dirty upper register halves would be penalized
+    for (; p < count; p++)
+    {
+        const GLdouble *v = xyz + 3 * p;
+
+        t_0 += a[p] * v[0];
+        t_1 += a[p] * v[1];
+        t_2 += a[p] * v[2];
+    }
+
+    s[0] += t_0;
+    s[1] += t_1;
+    s[2] += t_2;
+}
+#endif
+
+GLvoid AccumulateInterleavedDotProducts(GLuint count, const GLdouble *a, const GLdouble *xyz, GLdouble *s)
+{
+#ifdef CAGD_X86_MATRIX_PRODUCT_KERNELS
+    // the AVX2 kernel is also used on AVX-512 processors, since a triplet does not fit the wider registers any better
+    switch (ActiveMatrixProductKernel())
+    {
+    case AVX512_MATRIX_PRODUCT_KERNEL:
+    case AVX2_MATRIX_PRODUCT_KERNEL:
+        AccumulateInterleavedDotProductsAVX2(count, a, xyz, s);
+        return;
+    default:
+        break;
+    }
+#endif
+
+    AccumulateInterleavedDotProductsScalar(count, a, xyz, s);
+}
+}
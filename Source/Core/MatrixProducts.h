@@ -0,0 +1,54 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // Cache-blocked and register-blocked kernels of real matrix products.
+    //
+    // The matrices are stored row by row, consecutive rows of a matrix are
+    // leading dimension elements apart (see Matrix<T>::GetLeadingDimension()).
+    //
+    // The product is evaluated tile by tile, where the innermost micro-kernel
+    // keeps a block of 4 rows of C in vector registers. The instruction set of
+    // the micro-kernel (AVX-512, AVX2 + FMA or portable scalar code) is selected
+    // once, at the first call, according to the capabilities of the processor,
+    // unless another one is selected explicitly.
+    //--------------------------------------------------------------------------
+    enum MatrixProductKernel { SCALAR_MATRIX_PRODUCT_KERNEL, AVX2_MATRIX_PRODUCT_KERNEL, AVX512_MATRIX_PRODUCT_KERNEL };
+
+    // the kernel that is used on the current processor
+    MatrixProductKernel ActiveMatrixProductKernel();
+
+    // restricts the products and the vectorised B-spline kernels to the given instruction set (e.g., in order to test
+    // or to compare the kernels), a kernel that the processor does not support is not selected and GL_FALSE is returned;
+    // the selection must not be changed while other threads use the kernels
+    GLboolean SelectMatrixProductKernel(MatrixProductKernel kernel);
+
+    // C += A * B, where A, B and C are of sizes m x k, k x n and m x n, respectively
+    GLvoid AccumulateMatrixProduct(
+            GLuint m, GLuint n, GLuint k,
+            const GLdouble *A, std::size_t lda,
+            const GLdouble *B, std::size_t ldb,
+            GLdouble *C, std::size_t ldc);
+
+    // single precision variant, each vector register holds twice as many columns of B and C
+    GLvoid AccumulateMatrixProduct(
+            GLuint m, GLuint n, GLuint k,
+            const GLfloat *A, std::size_t lda,
+            const GLfloat *B, std::size_t ldb,
+            GLfloat *C, std::size_t ldc);
+
+    // (s_0, s_1, s_2) -= (l * x_0, l * x_1, l * x_2), i.e., the 1 x count row l is multiplied by the
+    // count x 3 matrix the columns of which are stored contiguously (e.g., a row of a triangular factor
+    // and the separated x, y and z components of DCoordinate3 right-hand sides)
+    GLvoid SubtractThreeDotProducts(
+            GLuint count, const GLdouble *l,
+            const GLdouble *x_0, const GLdouble *x_1, const GLdouble *x_2, GLdouble *s);
+
+    // (s_0, s_1, s_2) += a * X, where the rows of the count x 3 matrix X are stored contiguously,
+    // i.e., xyz = (x_0, y_0, z_0, x_1, y_1, z_1, ...) (e.g., a column matrix of DCoordinate3 elements)
+    GLvoid AccumulateInterleavedDotProducts(GLuint count, const GLdouble *a, const GLdouble *xyz, GLdouble *s);
+}
@@ -0,0 +1,81 @@
+#include "ParallelExecutionPolicies.h"
+
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace cagd
+{
+const GLdouble ParallelExecutionPolicy::DEFAULT_GRAIN_SIZE = 16384.0;
+
+static atomic<GLint>    parallel_execution_mode(ParallelExecutionPolicy::PARALLEL);
+static atomic<GLdouble> parallel_execution_grain_size(ParallelExecutionPolicy::DEFAULT_GRAIN_SIZE);
+static atomic<GLuint>   parallel_execution_maximum_thread_count(0);
+
+GLvoid ParallelExecutionPolicy::SetMode(Mode mode)
+{
+    parallel_execution_mode = mode;
+}
+
+ParallelExecutionPolicy::Mode ParallelExecutionPolicy::GetMode()
+{
+    return static_cast<Mode>(parallel_execution_mode.load());
+}
+
+GLvoid ParallelExecutionPolicy::SetGrainSize(GLdouble grain_size)
+{
+    parallel_execution_grain_size = (grain_size > 1.0) ? grain_size : 1.0;
+}
+
+GLdouble ParallelExecutionPolicy::GetGrainSize()
+{
+    return parallel_execution_grain_size;
+}
+
+GLvoid ParallelExecutionPolicy::SetMaximumThreadCount(GLuint maximum_thread_count)
+{
+    parallel_execution_maximum_thread_count = maximum_thread_count;
+}
+
+GLuint ParallelExecutionPolicy::GetMaximumThreadCount()
+{
+    return parallel_execution_maximum_thread_count;
+}
+
+GLint ParallelExecutionPolicy::ThreadCount(GLdouble work, GLuint iteration_count)
+{
+#ifdef _OPENMP
+    if (parallel_execution_mode != PARALLEL || omp_in_parallel())
+        return 1;
+
+    GLdouble grain_size = parallel_execution_grain_size;
+
+    if (!(work >= 2.0 * grain_size))
+        return 1;
+
+    GLint thread_count = omp_get_max_threads();
+
+    GLuint cap = parallel_execution_maximum_thread_count;
+    if (cap && static_cast<GLint>(cap) < thread_count)
+        thread_count = static_cast<GLint>(cap);
+
+    if (iteration_count && static_cast<GLint>(iteration_count) < thread_count)
+        thread_count = static_cast<GLint>(iteration_count);
+
+    GLdouble grain_count = work / grain_size;
+    if (grain_count < thread_count)
+        thread_count = static_cast<GLint>(grain_count);
+
+    return thread_count > 1 ? thread_count : 1;
+#else
+    (void)work;
+    (void)iteration_count;
+
+    return 1;
+#endif
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// the thread counts are only referenced by the OpenMP pragmas, i.e., they are unused if OpenMP is not enabled
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_OPENMP)
+#define CAGD_OPENMP_ONLY __attribute__((unused))
+#else
+#define CAGD_OPENMP_ONLY
+#endif
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // Central control of the OpenMP parallel loops of the library.
+    //
+    // Before forking, each parallel loop estimates its amount of work (roughly
+    // the number of floating point operations or elementary steps) and asks the
+    // policy for the size of the thread team. Loops with less work than the
+    // grain size are executed serially by the calling thread. Larger loops get
+    // at most one thread per grain size of work, and never more than the thread
+    // count cap. In serial mode every loop is executed by the calling thread.
+    // Loops that are encountered inside an active parallel region are also
+    // executed serially, since a nested team would only add fork/join overhead.
+    //
+    // The parallel loops follow the pattern
+    //
+    //      CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(work);
+    //
+    //      #pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    //      for (...)
+    //
+    // The settings are global and may be modified at any time; loops that are
+    // already running are not affected.
+    //--------------------------------------------------------------------------
+    class ParallelExecutionPolicy
+    {
+    public:
+        enum Mode { SERIAL, PARALLEL };
+
+        // default settings
+        static const GLdouble DEFAULT_GRAIN_SIZE;
+
+        static GLvoid SetMode(Mode mode);
+        static Mode GetMode();
+
+        // minimal amount of work per thread, a loop with less work is executed serially
+        static GLvoid SetGrainSize(GLdouble grain_size);
+        static GLdouble GetGrainSize();
+
+        // upper bound for the size of the thread teams, 0 means the OpenMP default (omp_get_max_threads())
+        static GLvoid SetMaximumThreadCount(GLuint maximum_thread_count);
+        static GLuint GetMaximumThreadCount();
+
+        // the number of threads (at least 1) that should execute a loop of the given amount of work,
+        // the optional iteration count of the loop is also an upper bound (0 means unknown)
+        static GLint ThreadCount(GLdouble work, GLuint iteration_count = 0);
+    };
+}
@@ -1,5 +1,12 @@
 #include "RealMatrices.h"
 #include "Exceptions.h"
+#include "MatrixProducts.h"
+#include <cmath>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace cagd
 {
@@ -22,7 +29,74 @@ RealMatrix& RealMatrix::operator =(const RealMatrix& rhs)
     return *this;
 }
 
-const RealMatrix RealMatrix::operator +(const RealMatrix& rhs) const
+RealMatrix::RealMatrix(RealMatrix&& m) noexcept:
+    Matrix<GLdouble>(std::move(m))
+{
+}
+
+RealMatrix& RealMatrix::operator =(RealMatrix&& rhs) noexcept
+{
+    Matrix<GLdouble>::operator=(std::move(rhs));
+    return *this;
+}
+
+RealMatrix& RealMatrix::operator +=(const RealMatrix& rhs)
+{
+    return AddScaled(1.0, rhs);
+}
+
+RealMatrix& RealMatrix::operator -=(const RealMatrix& rhs)
+{
+    return AddScaled(-1.0, rhs);
+}
+
+RealMatrix& RealMatrix::operator *=(const GLdouble value)
+{
+    return Scale(value);
+}
+
+RealMatrix& RealMatrix::AddScaled(GLdouble alpha, const RealMatrix& X)
+{
+    if (this->GetColumnCount() != X.GetColumnCount() ||
+            this->GetRowCount() != X.GetRowCount())
+    {
+        throw Exception("The size of the two matrices does not match.");
+    }
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint i = 0; i < static_cast<GLint> (this->GetRowCount()); i++)
+    {
+        GLdouble       *a = this->GetRowPointer(i);
+        const GLdouble *x = X.GetRowPointer(i);
+
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            a[j] += alpha * x[j];
+        }
+    }
+    return *this;
+}
+
+RealMatrix& RealMatrix::Scale(GLdouble alpha)
+{
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint i = 0; i < static_cast<GLint> (this->GetRowCount()); i++)
+    {
+        GLdouble *a = this->GetRowPointer(i);
+
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            a[j] *= alpha;
+        }
+    }
+    return *this;
+}
+
+RealMatrix RealMatrix::operator +(const RealMatrix& rhs) const
 {
     if (this->GetColumnCount() != rhs.GetColumnCount() ||
             this->GetRowCount() != rhs.GetRowCount())
@@ -32,18 +106,24 @@ const RealMatrix RealMatrix::operator +(const RealMatrix& rhs) const
 
     RealMatrix C(this->GetRowCount(), this->GetColumnCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint> (this->GetRowCount() * rhs.GetColumnCount()); i_j++)
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint i = 0; i < static_cast<GLint> (this->GetRowCount()); i++)
     {
-        GLint i = i_j / rhs.GetColumnCount();
-        GLint j = i_j % rhs.GetColumnCount();
+        const GLdouble *a = this->GetRowPointer(i);
+        const GLdouble *b = rhs.GetRowPointer(i);
+        GLdouble       *c = C.GetRowPointer(i);
 
-        C(i, j) = (*this)(i, j) + rhs(i, j);
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            c[j] = a[j] + b[j];
+        }
     }
     return C;
 }
 
-const RealMatrix RealMatrix::operator -(const RealMatrix& rhs) const
+RealMatrix RealMatrix::operator -(const RealMatrix& rhs) const
 {
     if (this->GetColumnCount() != rhs.GetColumnCount() ||
             this->GetRowCount() != rhs.GetRowCount())
@@ -52,18 +132,25 @@ const RealMatrix RealMatrix::operator -(const RealMatrix& rhs) const
     }
 
     RealMatrix C(this->GetRowCount(), this->GetColumnCount());
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint> (this->GetRowCount() * rhs.GetColumnCount()); i_j++)
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint i = 0; i < static_cast<GLint> (this->GetRowCount()); i++)
     {
-        GLint i = i_j / rhs.GetColumnCount();
-        GLint j = i_j % rhs.GetColumnCount();
+        const GLdouble *a = this->GetRowPointer(i);
+        const GLdouble *b = rhs.GetRowPointer(i);
+        GLdouble       *c = C.GetRowPointer(i);
 
-        C(i, j) = (*this)(i, j) - rhs(i, j);
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            c[j] = a[j] - b[j];
+        }
     }
     return C;
 }
 
-const RealMatrix RealMatrix::operator *(const RealMatrix& rhs) const
+RealMatrix RealMatrix::operator *(const RealMatrix& rhs) const
 {
     if (this->GetColumnCount() != rhs.GetRowCount())
     {
@@ -72,50 +159,365 @@ const RealMatrix RealMatrix::operator *(const RealMatrix& rhs) const
 
     RealMatrix C(this->GetRowCount(), rhs.GetColumnCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint> (this->GetRowCount() * rhs.GetColumnCount()); i_j++)
+    if (C.GetRowCount() && C.GetColumnCount() && this->GetColumnCount())
     {
-        GLint i = i_j / rhs.GetColumnCount();
-        GLint j = i_j % rhs.GetColumnCount();
+        AccumulateMatrixProduct(
+                this->GetRowCount(), rhs.GetColumnCount(), this->GetColumnCount(),
+                this->GetRowPointer(0), this->GetLeadingDimension(),
+                rhs.GetRowPointer(0), rhs.GetLeadingDimension(),
+                C.GetRowPointer(0), C.GetLeadingDimension());
+    }
 
-        // dot product
-        for (GLuint k = 0; k < this->GetColumnCount(); k++)
+    return C;
+}
+
+template<>
+Matrix<GLdouble> RealMatrix::operator *(const Matrix<GLdouble>& rhs) const
+{
+    if (this->GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    Matrix<GLdouble> C(this->GetRowCount(), rhs.GetColumnCount());
+
+    if (C.GetRowCount() && C.GetColumnCount() && this->GetColumnCount())
+    {
+        AccumulateMatrixProduct(
+                this->GetRowCount(), rhs.GetColumnCount(), this->GetColumnCount(),
+                this->GetRowPointer(0), this->GetLeadingDimension(),
+                rhs.GetRowPointer(0), rhs.GetLeadingDimension(),
+                C.GetRowPointer(0), C.GetLeadingDimension());
+    }
+
+    return C;
+}
+
+template<>
+ColumnMatrix<DCoordinate3> RealMatrix::operator *(const ColumnMatrix<DCoordinate3>& rhs) const
+{
+    if (this->GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    GLuint row_count    = this->GetRowCount();
+    GLuint column_count = this->GetColumnCount();
+
+    ColumnMatrix<DCoordinate3> C(row_count);
+
+    if (!row_count || !column_count)
+    {
+        return C;
+    }
+
+    // the elements of a column matrix are contiguous, i.e., its entries form the sequence x_0, y_0, z_0, x_1, ...
+    static_assert(sizeof(DCoordinate3) == 3 * sizeof(GLdouble), "DCoordinate3 has to consist of three packed coordinates.");
+
+    const GLdouble *xyz = reinterpret_cast<const GLdouble*>(rhs.GetRowPointer(0));
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * row_count * column_count);
+
+    if (row_count >= static_cast<GLuint>(thread_count))
+    {
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < static_cast<GLint>(row_count); i++)
+        {
+            GLdouble s[3] = {0.0, 0.0, 0.0};
+
+            AccumulateInterleavedDotProducts(column_count, this->GetRowPointer(i), xyz, s);
+
+            C[i] = DCoordinate3(s[0], s[1], s[2]);
+        }
+    }
+    else
+    {
+        // a single parallel region, each thread evaluates all rows over its own range of columns
+        std::vector<GLdouble> sums(3 * static_cast<std::size_t>(row_count), 0.0);
+
+#pragma omp parallel num_threads(thread_count)
+        {
+#ifdef _OPENMP
+            GLuint team_size    = static_cast<GLuint>(omp_get_num_threads());
+            GLuint thread_index = static_cast<GLuint>(omp_get_thread_num());
+#else
+            GLuint team_size    = 1;
+            GLuint thread_index = 0;
+#endif
+            GLuint first = static_cast<GLuint>(static_cast<std::size_t>(column_count) * thread_index / team_size);
+            GLuint last  = static_cast<GLuint>(static_cast<std::size_t>(column_count) * (thread_index + 1) / team_size);
+
+            std::vector<GLdouble> partial_sums(3 * static_cast<std::size_t>(row_count), 0.0);
+
+            for (GLuint i = 0; first < last && i < row_count; i++)
+            {
+                AccumulateInterleavedDotProducts(last - first, this->GetRowPointer(i) + first, xyz + 3 * static_cast<std::size_t>(first), &partial_sums[3 * i]);
+            }
+
+#pragma omp critical
+            for (std::size_t l = 0; l < sums.size(); l++)
+            {
+                sums[l] += partial_sums[l];
+            }
+        }
+
+        for (GLuint i = 0; i < row_count; i++)
         {
-            C(i, j) += (*this)(i, k) * rhs(k, j);
+            C[i] = DCoordinate3(sums[3 * i], sums[3 * i + 1], sums[3 * i + 2]);
         }
     }
+
+    return C;
+}
+
+template<>
+Matrix<DCoordinate3> RealMatrix::operator *(const Matrix<DCoordinate3>& rhs) const
+{
+    if (this->GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    Matrix<DCoordinate3> C(this->GetRowCount(), rhs.GetColumnCount());
+
+    // the rows of rhs and C are viewed as real rows of three times as many elements
+    static_assert(sizeof(DCoordinate3) == 3 * sizeof(GLdouble), "DCoordinate3 has to consist of three packed coordinates.");
+
+    if (C.GetRowCount() && C.GetColumnCount() && this->GetColumnCount())
+    {
+        AccumulateMatrixProduct(
+                this->GetRowCount(), 3 * rhs.GetColumnCount(), this->GetColumnCount(),
+                this->GetRowPointer(0), this->GetLeadingDimension(),
+                reinterpret_cast<const GLdouble*>(rhs.GetRowPointer(0)), 3 * static_cast<std::size_t>(rhs.GetLeadingDimension()),
+                reinterpret_cast<GLdouble*>(C.GetRowPointer(0)), 3 * static_cast<std::size_t>(C.GetLeadingDimension()));
+    }
+
     return C;
 }
 
+template<>
+Matrix<GLdouble> operator *(const Matrix<GLdouble>& lhs, const RealMatrix& rhs)
+{
+    if (lhs.GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    Matrix<GLdouble> C(lhs.GetRowCount(), rhs.GetColumnCount());
+
+    if (C.GetRowCount() && C.GetColumnCount() && lhs.GetColumnCount())
+    {
+        AccumulateMatrixProduct(
+                lhs.GetRowCount(), rhs.GetColumnCount(), lhs.GetColumnCount(),
+                lhs.GetRowPointer(0), lhs.GetLeadingDimension(),
+                rhs.GetRowPointer(0), rhs.GetLeadingDimension(),
+                C.GetRowPointer(0), C.GetLeadingDimension());
+    }
 
-const RealMatrix RealMatrix::operator *(const GLdouble value) const
+    return C;
+}
+
+template<>
+Matrix<DCoordinate3> operator *(const Matrix<DCoordinate3>& lhs, const RealMatrix& rhs)
+{
+    if (lhs.GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    GLuint row_count = lhs.GetRowCount();
+
+    Matrix<DCoordinate3> C(row_count, rhs.GetColumnCount());
+
+    if (!row_count || !C.GetColumnCount() || !lhs.GetColumnCount())
+    {
+        return C;
+    }
+
+    // the coordinates of lhs are separated into the three row blocks of a real matrix,
+    // the product of which is evaluated at once
+    RealMatrix L(3 * row_count, lhs.GetColumnCount());
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * row_count * lhs.GetColumnCount(), row_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(row_count); i++)
+    {
+        const DCoordinate3 *l = lhs.GetRowPointer(i);
+        GLdouble           *x = L.GetRowPointer(i);
+        GLdouble           *y = L.GetRowPointer(row_count + i);
+        GLdouble           *z = L.GetRowPointer(2 * row_count + i);
+
+        for (GLuint k = 0; k < lhs.GetColumnCount(); k++)
+        {
+            x[k] = l[k].x();
+            y[k] = l[k].y();
+            z[k] = l[k].z();
+        }
+    }
+
+    RealMatrix LR = L * rhs;
+
+    thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * row_count * C.GetColumnCount(), row_count);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(row_count); i++)
+    {
+        const GLdouble *x = LR.GetRowPointer(i);
+        const GLdouble *y = LR.GetRowPointer(row_count + i);
+        const GLdouble *z = LR.GetRowPointer(2 * row_count + i);
+        DCoordinate3   *c = C.GetRowPointer(i);
+
+        for (GLuint j = 0; j < C.GetColumnCount(); j++)
+        {
+            c[j] = DCoordinate3(x[j], y[j], z[j]);
+        }
+    }
+
+    return C;
+}
+
+RealMatrix RealMatrix::operator *(const GLdouble value) const
 {
     RealMatrix C(this->GetRowCount(), this->GetColumnCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint> (this->GetRowCount() * this->GetColumnCount()); i_j++)
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint i = 0; i < static_cast<GLint> (this->GetRowCount()); i++)
     {
-        GLint i = i_j / this->GetColumnCount();
-        GLint j = i_j % this->GetColumnCount();
+        const GLdouble *a = this->GetRowPointer(i);
+        GLdouble       *c = C.GetRowPointer(i);
 
-        C(i, j) = (*this)(i, j) * value;
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            c[j] = a[j] * value;
+        }
     }
     return C;
 }
 
 
-const RealMatrix RealMatrix::Transpose() const
+RealMatrix RealMatrix::Transpose() const
 {
     RealMatrix C(this->GetColumnCount(), this->GetRowCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint> (this->GetRowCount() * this->GetColumnCount()); i_j++)
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetColumnCount());
+
+    // each thread writes its own row of the transpose, reading a column of *this with stride GetLeadingDimension()
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for(GLint j = 0; j < static_cast<GLint> (this->GetColumnCount()); j++)
+    {
+        const GLdouble *a = this->GetColumnPointer(j);
+        GLdouble       *c = C.GetRowPointer(j);
+        GLuint         ld = this->GetLeadingDimension();
+
+        for (GLuint i = 0; i < this->GetRowCount(); i++)
+        {
+            c[i] = a[static_cast<std::size_t>(i) * ld];
+        }
+    }
+    return C;
+}
+
+RealMatrix RealMatrix::GramMatrix() const
+{
+    GLuint size        = this->GetColumnCount();
+    GLuint block_count = (size + REAL_MATRIX_BLOCK_SIZE - 1) / REAL_MATRIX_BLOCK_SIZE;
+
+    RealMatrix C(size, size);
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(0.5 * this->GetRowCount() * size * size, block_count * (block_count + 1) / 2);
+
+    // the lower triangular tiles (I, J), J <= I, are enumerated row by row, i.e., tile = I * (I + 1) / 2 + J;
+    // the diagonal tiles require about half of the work, thus the tiles are scheduled dynamically
+#pragma omp parallel for schedule(dynamic) if (thread_count > 1) num_threads(thread_count)
+    for (GLint tile = 0; tile < static_cast<GLint>(block_count * (block_count + 1) / 2); tile++)
+    {
+        GLuint I = static_cast<GLuint>((sqrt(8.0 * tile + 1.0) - 1.0) / 2.0);
+        while ((I + 1) * (I + 2) / 2 <= static_cast<GLuint>(tile))
+            I++;
+        while (I * (I + 1) / 2 > static_cast<GLuint>(tile))
+            I--;
+        GLuint J = tile - I * (I + 1) / 2;
+
+        GLuint i_begin = I * REAL_MATRIX_BLOCK_SIZE;
+        GLuint j_begin = J * REAL_MATRIX_BLOCK_SIZE;
+        GLuint i_end   = (i_begin + REAL_MATRIX_BLOCK_SIZE < size) ? i_begin + REAL_MATRIX_BLOCK_SIZE : size;
+        GLuint j_end   = (j_begin + REAL_MATRIX_BLOCK_SIZE < size) ? j_begin + REAL_MATRIX_BLOCK_SIZE : size;
+
+        GLuint r = 0;
+
+        // four rows of A at a time, so that each entry of the tile is loaded and stored once per four updates
+        for (; r + 4 <= this->GetRowCount(); r += 4)
+        {
+            const GLdouble *a_0 = this->GetRowPointer(r);
+            const GLdouble *a_1 = this->GetRowPointer(r + 1);
+            const GLdouble *a_2 = this->GetRowPointer(r + 2);
+            const GLdouble *a_3 = this->GetRowPointer(r + 3);
+
+            for (GLuint i = i_begin; i < i_end; i++)
+            {
+                GLdouble a_0i = a_0[i], a_1i = a_1[i], a_2i = a_2[i], a_3i = a_3[i];
+
+                GLdouble *c    = C.GetRowPointer(i);
+                GLuint    last = (I == J) ? i + 1 : j_end;
+
+                for (GLuint j = j_begin; j < last; j++)
+                {
+                    c[j] += a_0i * a_0[j] + a_1i * a_1[j] + a_2i * a_2[j] + a_3i * a_3[j];
+                }
+            }
+        }
+
+        for (; r < this->GetRowCount(); r++)
+        {
+            const GLdouble *a = this->GetRowPointer(r);
+
+            for (GLuint i = i_begin; i < i_end; i++)
+            {
+                GLdouble a_ri = a[i];
+                if (a_ri == 0.0)
+                    continue;
+
+                GLdouble *c    = C.GetRowPointer(i);
+                GLuint    last = (I == J) ? i + 1 : j_end;
+
+                for (GLuint j = j_begin; j < last; j++)
+                {
+                    c[j] += a_ri * a[j];
+                }
+            }
+        }
+    }
+
+    thread_count = ParallelExecutionPolicy::ThreadCount(0.5 * size * size, size);
+
+    // upper triangle
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(size); i++)
     {
-        GLint i = i_j / this->GetColumnCount();
-        GLint j = i_j % this->GetColumnCount();
+        const GLdouble *c = C.GetRowPointer(i);
 
-        C(j, i) = (*this)(i, j);
+        for (GLint j = 0; j < i; j++)
+        {
+            C(j, i) = c[j];
+        }
+    }
+
+    return C;
+}
+
+RealMatrix RealMatrix::TransposeTimes(const RealMatrix& X) const
+{
+    if (this->GetRowCount() != X.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
     }
+
+    RealMatrix C(this->GetColumnCount(), X.GetColumnCount());
+    _AccumulateTransposeTimes(X, C);
+
     return C;
 }
 }
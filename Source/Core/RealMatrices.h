@@ -4,11 +4,20 @@
 #include "Matrices.h"
 #include "Exceptions.h"
 #include "DCoordinates3.h"
+#include "ParallelExecutionPolicies.h"
 
 namespace cagd
 {
+// edge length of the square tiles used by the cache-blocked kernels of RealMatrix
+static const GLuint REAL_MATRIX_BLOCK_SIZE = 64;
+
 class RealMatrix: public Matrix<GLdouble>
 {
+private:
+    // C += A' * X tile by tile, where A corresponds to *this and C is a zero matrix of the correct size
+    template<class T>
+    GLvoid _AccumulateTransposeTimes(const Matrix<T>& X, Matrix<T>& C) const;
+
 public:
     RealMatrix(GLuint row_size = 1, GLuint column_size = 1);
 
@@ -16,78 +25,154 @@ public:
 
     RealMatrix& operator =(const RealMatrix& rhs);
 
-    const RealMatrix operator +(const RealMatrix& rhs) const;
+    RealMatrix(RealMatrix&& m) noexcept;
+
+    RealMatrix& operator =(RealMatrix&& rhs) noexcept;
+
+    // in-place updates, none of them allocates memory
+    RealMatrix& operator +=(const RealMatrix& rhs);
+
+    RealMatrix& operator -=(const RealMatrix& rhs);
+
+    RealMatrix& operator *=(const GLdouble value);
+
+    // *this = *this + alpha * X (axpy)
+    RealMatrix& AddScaled(GLdouble alpha, const RealMatrix& X);
+
+    // *this = alpha * *this
+    RealMatrix& Scale(GLdouble alpha);
 
-    const RealMatrix operator -(const RealMatrix& rhs) const;
+    RealMatrix operator +(const RealMatrix& rhs) const;
 
-    const RealMatrix operator *(const RealMatrix& rhs) const;
+    RealMatrix operator -(const RealMatrix& rhs) const;
 
-    const RealMatrix operator *(const GLdouble value) const;
+    RealMatrix operator *(const RealMatrix& rhs) const;
+
+    RealMatrix operator *(const GLdouble value) const;
 
     template<class T>
-    const ColumnMatrix<T> operator *(const ColumnMatrix<T>& rhs) const;
+    ColumnMatrix<T> operator *(const ColumnMatrix<T>& rhs) const;
 
     template<class T>
-    const Matrix<T> operator *(const Matrix<T>& rhs) const;
+    Matrix<T> operator *(const Matrix<T>& rhs) const;
+
+    RealMatrix Transpose() const;
+
+    // A' * A, where A corresponds to *this; only the lower triangle is computed, the upper one is its mirror image
+    RealMatrix GramMatrix() const;
 
-    const RealMatrix Transpose() const;
+    // A' * X without forming the transpose of A
+    RealMatrix TransposeTimes(const RealMatrix& X) const;
+
+    template<class T>
+    Matrix<T> TransposeTimes(const Matrix<T>& X) const;
+
+    template<class T>
+    ColumnMatrix<T> TransposeTimes(const ColumnMatrix<T>& x) const;
 };
 
 template<class T>
-const ColumnMatrix<T> RealMatrix::operator *(const ColumnMatrix<T>& rhs) const
+GLvoid RealMatrix::_AccumulateTransposeTimes(const Matrix<T>& X, Matrix<T>& C) const
 {
-    if (this->GetColumnCount() != rhs.GetRowCount())
-    {
-        throw Exception("The size of the two matrices is incorrect.");
-    }
+    GLuint row_count    = this->GetColumnCount();
+    GLuint column_count = X.GetColumnCount();
 
-    ColumnMatrix<T> C(this->GetRowCount());
+    GLuint row_block_count    = (row_count + REAL_MATRIX_BLOCK_SIZE - 1) / REAL_MATRIX_BLOCK_SIZE;
+    GLuint column_block_count = (column_count + REAL_MATRIX_BLOCK_SIZE - 1) / REAL_MATRIX_BLOCK_SIZE;
 
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * row_count * column_count, row_block_count * column_block_count);
 
-    if (this->GetRowCount() <= this->GetColumnCount() && typeid(T) == typeid(DCoordinate3))
+    // the tiles of C are disjoint, each of them is updated by streaming through the rows of A and X
+#pragma omp parallel for schedule(dynamic) if (thread_count > 1) num_threads(thread_count)
+    for (GLint tile = 0; tile < static_cast<GLint>(row_block_count * column_block_count); tile++)
     {
-        for (GLuint i = 0; i < this->GetRowCount(); i++)
+        GLuint i_begin = (tile / column_block_count) * REAL_MATRIX_BLOCK_SIZE;
+        GLuint j_begin = (tile % column_block_count) * REAL_MATRIX_BLOCK_SIZE;
+        GLuint i_end   = (i_begin + REAL_MATRIX_BLOCK_SIZE < row_count) ? i_begin + REAL_MATRIX_BLOCK_SIZE : row_count;
+        GLuint j_end   = (j_begin + REAL_MATRIX_BLOCK_SIZE < column_count) ? j_begin + REAL_MATRIX_BLOCK_SIZE : column_count;
+
+        for (GLuint r = 0; r < this->GetRowCount(); r++)
         {
-            if (typeid(T) == typeid(DCoordinate3))
+            const GLdouble *a = this->GetRowPointer(r);
+            const T        *x = X.GetRowPointer(r);
+
+            for (GLuint i = i_begin; i < i_end; i++)
             {
-                GLdouble x = 0.0;
-                GLdouble y = 0.0;
-                GLdouble z = 0.0;
-#pragma omp parallel for reduction(+:x, y, z)
-                for (GLint j = 0; j < static_cast<GLint>(this->GetColumnCount()); j++)
-                {
-                    x += rhs[j].x() * (*this)(i, j);
-                    y += rhs[j].y() * (*this)(i, j);
-                    z += rhs[j].z() * (*this)(i, j);
+                GLdouble a_ri = a[i];
+                if (a_ri == 0.0)
+                    continue;
 
+                T *c = C.GetRowPointer(i);
+                for (GLuint j = j_begin; j < j_end; j++)
+                {
+                    c[j] += x[j] * a_ri;
                 }
-                C[i][0] = x;
-                C[i][1] = y;
-                C[i][2] = z;
             }
         }
     }
-    else
+}
+
+template<class T>
+Matrix<T> RealMatrix::TransposeTimes(const Matrix<T>& X) const
+{
+    if (this->GetRowCount() != X.GetRowCount())
     {
-#pragma omp parallel for
-        for (GLint i = 0; i < static_cast<GLint>(this->GetRowCount()); i++)
-        {
-            for (GLuint j = 0; j < this->GetColumnCount(); j++)
-            {
-                C[i] += rhs[j] * (*this)(i, j);
-            }
-        }
+        throw Exception("The size of the two matrices is incorrect.");
+    }
 
+    Matrix<T> C(this->GetColumnCount(), X.GetColumnCount());
+    _AccumulateTransposeTimes(X, C);
+
+    return C;
+}
+
+template<class T>
+ColumnMatrix<T> RealMatrix::TransposeTimes(const ColumnMatrix<T>& x) const
+{
+    if (this->GetRowCount() != x.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
     }
 
+    ColumnMatrix<T> C(this->GetColumnCount());
+    _AccumulateTransposeTimes(x, C);
 
     return C;
 }
 
+template<class T>
+ColumnMatrix<T> RealMatrix::operator *(const ColumnMatrix<T>& rhs) const
+{
+    if (this->GetColumnCount() != rhs.GetRowCount())
+    {
+        throw Exception("The size of the two matrices is incorrect.");
+    }
+
+    ColumnMatrix<T> C(this->GetRowCount());
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount(), this->GetRowCount());
 
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(this->GetRowCount()); i++)
+    {
+        const GLdouble *a = this->GetRowPointer(i);
+
+        for (GLuint j = 0; j < this->GetColumnCount(); j++)
+        {
+            C[i] += rhs[j] * a[j];
+        }
+    }
+
+    return C;
+}
+
+// the x, y and z lanes of consecutive coordinates are multiplied by the SIMD kernels of MatrixProducts.h,
+// short and wide matrices are split into column ranges, the partial results of which are accumulated per thread
+template<>
+ColumnMatrix<DCoordinate3> RealMatrix::operator *(const ColumnMatrix<DCoordinate3>& rhs) const;
 
 template<class T>
-const Matrix<T> RealMatrix::operator *(const Matrix<T>& rhs) const
+Matrix<T> RealMatrix::operator *(const Matrix<T>& rhs) const
 {
     if (this->GetColumnCount() != rhs.GetRowCount())
     {
@@ -96,27 +181,42 @@ const Matrix<T> RealMatrix::operator *(const Matrix<T>& rhs) const
 
     Matrix<T> C(this->GetRowCount(), rhs.GetColumnCount());
 
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(this->GetRowCount()) * this->GetColumnCount() * rhs.GetColumnCount(), this->GetRowCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint>(this->GetRowCount() * rhs.GetColumnCount()); i_j++)
+    // i-k-j ordering: the innermost loop streams through contiguous rows of rhs and C
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(this->GetRowCount()); i++)
     {
-        int i = i_j / rhs.GetColumnCount();
-        int j = i_j % rhs.GetColumnCount();
+        const GLdouble *a = this->GetRowPointer(i);
+        T              *c = C.GetRowPointer(i);
 
-        // dot product
         for (GLuint k = 0; k < this->GetColumnCount(); k++)
         {
-            C(i, j) += (*this)(i, k) * rhs(k, j);
+            GLdouble a_ik = a[k];
+            if (a_ik == 0.0)
+                continue;
+
+            const T *b = rhs.GetRowPointer(k);
+            for (GLuint j = 0; j < rhs.GetColumnCount(); j++)
+            {
+                c[j] += b[j] * a_ik;
+            }
         }
     }
 
-
     return C;
 }
 
+// real and DCoordinate3 payloads are multiplied by the blocked kernels of MatrixProducts.h,
+// the coordinates x, y and z are treated as three right-hand sides
+template<>
+Matrix<GLdouble> RealMatrix::operator *(const Matrix<GLdouble>& rhs) const;
+
+template<>
+Matrix<DCoordinate3> RealMatrix::operator *(const Matrix<DCoordinate3>& rhs) const;
 
 template<class T>
-const Matrix<T> operator *(const Matrix<T>& lhs, const RealMatrix& rhs)
+Matrix<T> operator *(const Matrix<T>& lhs, const RealMatrix& rhs)
 {
     if (lhs.GetColumnCount() != rhs.GetRowCount())
     {
@@ -125,20 +225,30 @@ const Matrix<T> operator *(const Matrix<T>& lhs, const RealMatrix& rhs)
 
     Matrix<T> C(lhs.GetRowCount(), rhs.GetColumnCount());
 
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(lhs.GetRowCount()) * lhs.GetColumnCount() * rhs.GetColumnCount(), lhs.GetRowCount());
 
-#pragma omp parallel for
-    for(GLint i_j = 0; i_j < static_cast<GLint>(lhs.GetRowCount() * rhs.GetColumnCount()); i_j++)
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(lhs.GetRowCount()); i++)
     {
-        int i = i_j / rhs.GetColumnCount();
-        int j = i_j % rhs.GetColumnCount();
+        const T *a = lhs.GetRowPointer(i);
+        T       *c = C.GetRowPointer(i);
 
-        // dot product
         for (GLuint k = 0; k < lhs.GetColumnCount(); k++)
         {
-            C(i, j) += lhs(i, k) * rhs(k, j);
+            const GLdouble *b = rhs.GetRowPointer(k);
+            for (GLuint j = 0; j < rhs.GetColumnCount(); j++)
+            {
+                c[j] += a[k] * b[j];
+            }
         }
     }
 
     return C;
 }
+
+template<>
+Matrix<GLdouble> operator *(const Matrix<GLdouble>& lhs, const RealMatrix& rhs);
+
+template<>
+Matrix<DCoordinate3> operator *(const Matrix<DCoordinate3>& lhs, const RealMatrix& rhs);
 }
@@ -1,29 +1,46 @@
 #include "RealSquareMatrices.h"
+#include <algorithm>
 using namespace std;
 
 namespace cagd
 {
 RealSquareMatrix::RealSquareMatrix(GLuint size):
     RealMatrix(size, size),
-    _lu_decomposition_is_done(false)
+    _lu_decomposition_is_done(false),
+    _single_precision_lu_decomposition_is_done(false),
+    _single_precision_factors(0, 0)
 {}
 
 RealSquareMatrix::RealSquareMatrix(const RealSquareMatrix& m):
     RealMatrix(m),
     _lu_decomposition_is_done(m._lu_decomposition_is_done),
-    _row_permutation(m._row_permutation)
+    _row_permutation(m._row_permutation),
+    _single_precision_lu_decomposition_is_done(m._single_precision_lu_decomposition_is_done),
+    _single_precision_factors(m._single_precision_factors),
+    _single_precision_row_permutation(m._single_precision_row_permutation)
 {
 }
 
 // specific contructor
 RealSquareMatrix::RealSquareMatrix(const RealMatrix& m):
     RealMatrix(m),
-    _lu_decomposition_is_done(false)
+    _lu_decomposition_is_done(false),
+    _single_precision_lu_decomposition_is_done(false),
+    _single_precision_factors(0, 0)
 {
 
 }
 
 
+// specific move contructor
+RealSquareMatrix::RealSquareMatrix(RealMatrix&& m):
+    RealMatrix(std::move(m)),
+    _lu_decomposition_is_done(false),
+    _single_precision_lu_decomposition_is_done(false),
+    _single_precision_factors(0, 0)
+{
+}
+
 RealSquareMatrix& RealSquareMatrix::operator =(const RealSquareMatrix& rhs)
 {
     if(this != &rhs)
@@ -31,6 +48,35 @@ RealSquareMatrix& RealSquareMatrix::operator =(const RealSquareMatrix& rhs)
         RealMatrix::operator=(rhs);
         this->_lu_decomposition_is_done = rhs._lu_decomposition_is_done;
         this->_row_permutation = rhs._row_permutation;
+        this->_single_precision_lu_decomposition_is_done = rhs._single_precision_lu_decomposition_is_done;
+        this->_single_precision_factors = rhs._single_precision_factors;
+        this->_single_precision_row_permutation = rhs._single_precision_row_permutation;
+    }
+    return *this;
+}
+
+RealSquareMatrix::RealSquareMatrix(RealSquareMatrix&& m) noexcept:
+    RealMatrix(std::move(m)),
+    _lu_decomposition_is_done(m._lu_decomposition_is_done),
+    _row_permutation(std::move(m._row_permutation)),
+    _single_precision_lu_decomposition_is_done(m._single_precision_lu_decomposition_is_done),
+    _single_precision_factors(std::move(m._single_precision_factors)),
+    _single_precision_row_permutation(std::move(m._single_precision_row_permutation))
+{
+    m._lu_decomposition_is_done = false;
+    m._single_precision_lu_decomposition_is_done = false;
+}
+
+RealSquareMatrix& RealSquareMatrix::operator =(RealSquareMatrix&& rhs) noexcept
+{
+    if(this != &rhs)
+    {
+        RealMatrix::operator=(std::move(rhs));
+        std::swap(_lu_decomposition_is_done, rhs._lu_decomposition_is_done);
+        _row_permutation.swap(rhs._row_permutation);
+        std::swap(_single_precision_lu_decomposition_is_done, rhs._single_precision_lu_decomposition_is_done);
+        _single_precision_factors = std::move(rhs._single_precision_factors);
+        _single_precision_row_permutation.swap(rhs._single_precision_row_permutation);
     }
     return *this;
 }
@@ -53,87 +99,221 @@ GLboolean RealSquareMatrix::PerformLUDecomposition()
     if (_row_count <= 1)
         return GL_FALSE;
 
-    const GLdouble tiny = numeric_limits<GLdouble>::min();
+    _lu_decomposition_is_done = LUFactorization::Decompose(*this, _row_permutation);
 
-    GLuint size = static_cast<GLuint>(_data.size());
-    vector<GLdouble> implicit_scaling_of_each_row(size);
+    return _lu_decomposition_is_done;
+}
 
-    _row_permutation.resize(size);
+GLboolean RealSquareMatrix::PerformSinglePrecisionLUDecomposition()
+{
+    if (_single_precision_lu_decomposition_is_done)
+        return GL_TRUE;
+
+    if (_row_count <= 1 || _lu_decomposition_is_done)
+        return GL_FALSE;
+
+    _single_precision_factors.ResizeRows(_row_count);
+    _single_precision_factors.ResizeColumns(_column_count);
 
-    GLdouble row_interchanges = 1.0;
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(_row_count) * _column_count, _row_count);
 
-    //-------------------------------------------------------
-    // loop over rows to get the implicit scaling information
-    //-------------------------------------------------------
-    vector<GLdouble>::iterator its = implicit_scaling_of_each_row.begin();
-    for (vector<vector<GLdouble> >::const_iterator itr = _data.begin(); itr < _data.end(); ++itr)
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(_row_count); i++)
     {
-        GLdouble big = 0.0;
-        for (vector<GLdouble>::const_iterator itc = itr->begin(); itc < itr->end(); ++itc)
-        {
-            GLdouble temp = abs(*itc);
-            if (temp > big)
-                big = temp;
-        }
+        const GLdouble *a = GetRowPointer(i);
+        GLfloat        *f = _single_precision_factors.GetRowPointer(i);
 
-        if (big == 0.0)
+        for (GLuint j = 0; j < _column_count; j++)
         {
-            // the matrix is singular
-            return GL_FALSE;
+            f[j] = static_cast<GLfloat>(a[j]);
         }
-        *its = 1.0 / big;
-        ++its;
     }
 
-    //-----------------------------------
-    // search for the largest pivot element
-    //-----------------------------------
-    for (GLuint k = 0; k < size; ++k)
+    _single_precision_lu_decomposition_is_done =
+            LUFactorization::Decompose(_single_precision_factors, _single_precision_row_permutation);
+
+    return _single_precision_lu_decomposition_is_done;
+}
+
+GLboolean RealSquareMatrix::PerformSymmetricEigenDecomposition(ColumnMatrix<GLdouble>& eigenvalues, RealSquareMatrix& eigenvectors) const
+{
+    GLint size = static_cast<GLint>(_row_count);
+
+    if (size < 1)
+        return GL_FALSE;
+
+    RealSquareMatrix &z = eigenvectors;
+    z = *this;
+    z._lu_decomposition_is_done = GL_FALSE;
+    z._single_precision_lu_decomposition_is_done = GL_FALSE;
+
+    ColumnMatrix<GLdouble> &d = eigenvalues;
+    d.ResizeRows(size);
+
+    vector<GLdouble> e(size);
+
+    //------------------------------------------------------------------
+    // Householder reduction to tridiagonal form: d and e store the main
+    // and sub-diagonal, z accumulates the orthogonal transformation
+    //------------------------------------------------------------------
+    for (GLint i = size - 1; i > 0; i--)
     {
-        GLuint imax = k;
-        GLdouble big = 0.0;
-        for (GLuint i = k; i < size; ++i)
+        GLint    l = i - 1;
+        GLdouble h = 0.0, scale = 0.0;
+
+        if (l > 0)
         {
-            GLdouble temp = implicit_scaling_of_each_row[i] * abs(_data[i][k]);
-            if (temp > big)
+            for (GLint k = 0; k < i; k++)
+                scale += abs(z(i, k));
+
+            if (scale == 0.0)
+            {
+                e[i] = z(i, l);
+            }
+            else
             {
-                big = temp;
-                imax = i;
+                for (GLint k = 0; k < i; k++)
+                {
+                    z(i, k) /= scale;
+                    h += z(i, k) * z(i, k);
+                }
+
+                GLdouble f = z(i, l);
+                GLdouble g = (f >= 0.0) ? -sqrt(h) : sqrt(h);
+                e[i] = scale * g;
+                h -= f * g;
+                z(i, l) = f - g;
+                f = 0.0;
+
+                for (GLint j = 0; j < i; j++)
+                {
+                    z(j, i) = z(i, j) / h;
+                    g = 0.0;
+                    for (GLint k = 0; k <= j; k++)
+                        g += z(j, k) * z(i, k);
+                    for (GLint k = j + 1; k < i; k++)
+                        g += z(k, j) * z(i, k);
+                    e[j] = g / h;
+                    f += e[j] * z(i, j);
+                }
+
+                GLdouble hh = f / (h + h);
+                for (GLint j = 0; j < i; j++)
+                {
+                    f = z(i, j);
+                    e[j] = g = e[j] - hh * f;
+                    for (GLint k = 0; k <= j; k++)
+                        z(j, k) -= (f * e[k] + g * z(i, k));
+                }
             }
         }
+        else
+        {
+            e[i] = z(i, l);
+        }
+
+        d[i] = h;
+    }
 
-        // do we need to interchange rows?
-        if (k != imax)
+    d[0] = 0.0;
+    e[0] = 0.0;
+
+    for (GLint i = 0; i < size; i++)
+    {
+        if (d[i] != 0.0)
         {
-            for (GLuint j = 0; j < size; ++j)
+            for (GLint j = 0; j < i; j++)
             {
-                GLdouble temp = _data[imax][j];
-                _data[imax][j] = _data[k][j];
-                _data[k][j] = temp;
+                GLdouble g = 0.0;
+                for (GLint k = 0; k < i; k++)
+                    g += z(i, k) * z(k, j);
+                for (GLint k = 0; k < i; k++)
+                    z(k, j) -= g * z(k, i);
             }
-            // change the parity of row_interchanges
-            row_interchanges = -row_interchanges;
-            // also interchange the scale factor
-            implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
         }
 
-        _row_permutation[k] = imax;
-        if (_data[k][k] == 0.0)
-            _data[k][k] = tiny;
+        d[i] = z(i, i);
+        z(i, i) = 1.0;
+        for (GLint j = 0; j < i; j++)
+            z(j, i) = z(i, j) = 0.0;
+    }
+
+    //------------------------------------------------------------------
+    // QL algorithm with implicit shifts applied to the tridiagonal matrix
+    //------------------------------------------------------------------
+    const GLdouble eps = numeric_limits<GLdouble>::epsilon();
 
-        for (GLuint i = k + 1; i < size; ++i)
+    for (GLint i = 1; i < size; i++)
+        e[i - 1] = e[i];
+    e[size - 1] = 0.0;
+
+    for (GLint l = 0; l < size; l++)
+    {
+        GLint iteration = 0;
+        GLint m;
+
+        do
         {
-            // divide by pivot element
-            GLdouble temp = _data[i][k] /= _data[k][k];
+            for (m = l; m < size - 1; m++)
+            {
+                GLdouble dd = abs(d[m]) + abs(d[m + 1]);
+                if (abs(e[m]) <= eps * dd)
+                    break;
+            }
+
+            if (m != l)
+            {
+                if (iteration++ == 60)
+                {
+                    // the method did not converge
+                    return GL_FALSE;
+                }
+
+                GLdouble g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+                GLdouble r = hypot(g, 1.0);
+                g = d[m] - d[l] + e[l] / (g + (g >= 0.0 ? abs(r) : -abs(r)));
 
-            // reduce remaining submatrix
-            for (GLuint j = k + 1; j < size; ++j)
-                _data[i][j] -= temp * _data[k][j];
+                GLdouble s = 1.0, c = 1.0, p = 0.0;
+                GLint i;
+                for (i = m - 1; i >= l; i--)
+                {
+                    GLdouble f = s * e[i];
+                    GLdouble b = c * e[i];
+                    e[i + 1] = (r = hypot(f, g));
+
+                    if (r == 0.0)
+                    {
+                        d[i + 1] -= p;
+                        e[m] = 0.0;
+                        break;
+                    }
+
+                    s = f / r;
+                    c = g / r;
+                    g = d[i + 1] - p;
+                    r = (d[i] - g) * s + 2.0 * c * b;
+                    d[i + 1] = g + (p = s * r);
+                    g = c * r - b;
+
+                    for (GLint k = 0; k < size; k++)
+                    {
+                        f = z(k, i + 1);
+                        z(k, i + 1) = s * z(k, i) + c * f;
+                        z(k, i) = c * z(k, i) - s * f;
+                    }
+                }
+
+                if (r == 0.0 && i >= l)
+                    continue;
+
+                d[l] -= p;
+                e[l] = g;
+                e[m] = 0.0;
+            }
         }
+        while (m != l);
     }
 
-    _lu_decomposition_is_done = GL_TRUE;
-
     return GL_TRUE;
 }
 
@@ -4,6 +4,9 @@
 #include <limits>
 #include <cmath>
 #include "RealMatrices.h"
+#include "LUFactorizations.h"
+#include "IterativeRefinements.h"
+#include "ParallelExecutionPolicies.h"
 
 namespace cagd
 {
@@ -13,6 +16,15 @@ namespace cagd
         GLboolean           _lu_decomposition_is_done;
         std::vector<GLuint> _row_permutation;
 
+        // LU factors of a single precision copy of this matrix (used by the mixed precision solver)
+        GLboolean           _single_precision_lu_decomposition_is_done;
+        Matrix<GLfloat>     _single_precision_factors;
+        std::vector<GLuint> _single_precision_row_permutation;
+
+        // r = r - A * x, where A corresponds to *this
+        template <class T>
+        GLvoid _SubtractProduct(const Matrix<T>& x, Matrix<T>& r, GLboolean represent_solutions_as_columns) const;
+
     public:
         // special/default constructor
         RealSquareMatrix(GLuint size = 1);
@@ -23,16 +35,34 @@ namespace cagd
         // specific contructor
         RealSquareMatrix(const RealMatrix& m);
 
+        // specific move contructor
+        RealSquareMatrix(RealMatrix&& m);
+
         // assignment operator
         RealSquareMatrix& operator =(const RealSquareMatrix& rhs);
 
+        // move constructor and move assignment operator
+        RealSquareMatrix(RealSquareMatrix&& m) noexcept;
+        RealSquareMatrix& operator =(RealSquareMatrix&& rhs) noexcept;
+
         // square matrices have the same number of rows and columns!
         GLboolean ResizeRows(GLuint row_count);
         GLboolean ResizeColumns(GLuint column_count);
 
-        // tries to determine the LU decomposition of this square matrix
+        // tries to determine the LU decomposition of this square matrix in place
+        // (blocked algorithm, see LUFactorizations.h); if the same matrix has to be kept
+        // for other purposes, use a separate LUFactorization object instead
         GLboolean PerformLUDecomposition();
 
+        // tries to determine the LU decomposition of a single precision copy of this square matrix,
+        // the entries of this matrix are not overwritten
+        GLboolean PerformSinglePrecisionLUDecomposition();
+
+        // Determines the eigenvalues and orthonormal eigenvectors of this matrix, which is assumed to be symmetric.
+        // The eigenvectors are stored column-wise, i.e., *this = eigenvectors * diag(eigenvalues) * eigenvectors'.
+        // (Householder reduction to tridiagonal form, followed by the QL algorithm with implicit shifts.)
+        GLboolean PerformSymmetricEigenDecomposition(ColumnMatrix<GLdouble>& eigenvalues, RealSquareMatrix& eigenvectors) const;
+
         // Solves linear systems of type A * x = b, where A is a regular square matrix,
         // while b and x are row or column matrices with elements of type T.
         // Here matrix A corresponds to *this.
@@ -40,86 +70,109 @@ namespace cagd
         // or any other type which has similar mathematical operators.
         template <class T>
         GLboolean SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE);
+
+        // Mixed precision variant of SolveLinearSystem (see IterativeRefinements.h): the LU decomposition
+        // is performed in single precision, while the residuals of the refinement steps are evaluated in
+        // double precision by means of this matrix. Returns GL_FALSE if the relative residual does not drop below tolerance.
+        // If the double precision LU decomposition has already overwritten this matrix, the ordinary substitutions are performed.
+        template <class T>
+        GLboolean SolveLinearSystemWithIterativeRefinement(
+                const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns = GL_TRUE,
+                GLdouble tolerance = 1.0e-12, GLuint maximum_iteration_count = 10, GLuint *iteration_count = nullptr);
     };
 
 template <class T>
-GLboolean RealSquareMatrix::SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns)
+GLvoid RealSquareMatrix::_SubtractProduct(const Matrix<T>& x, Matrix<T>& r, GLboolean represent_solutions_as_columns) const
 {
-    if (!_lu_decomposition_is_done)
-        if (!PerformLUDecomposition())
-            return GL_FALSE;
+    GLint size = static_cast<GLint>(_row_count);
 
     if (represent_solutions_as_columns)
     {
-        GLint size = static_cast<GLint>(GetColumnCount());
-        if (static_cast<GLint>(b.GetRowCount()) != size)
-            return GL_FALSE;
-
-        x = b;
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size * x.GetColumnCount(), size);
 
-#pragma omp parallel for
-        for (GLint k = 0; k < static_cast<GLint> (b.GetColumnCount()); ++k)
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < size; i++)
         {
-            GLint ii = 0;
-            for (GLint i = 0; i < size; ++i)
-            {
-                GLuint ip = _row_permutation[i];
-                T sum = x(ip, k);
-                x(ip, k) = x(i, k);
-                if (ii != 0)
-                    for (GLint j = ii - 1; j < i; ++j)
-                        sum -= _data[i][j] * x(j, k);
-                else
-                    if (sum != 0.0)
-                        ii = i + 1;
-                x(i, k) = sum;
-            }
+            const GLdouble *a   = GetRowPointer(i);
+            T              *r_i = r.GetRowPointer(i);
 
-            for (GLint i = size - 1; i >= 0; --i)
+            for (GLint j = 0; j < size; j++)
             {
-                T sum = x(i, k);
-                for (GLint j = i + 1; j < size; ++j)
-                    sum -= _data[i][j] * x(j, k);
-                x(i, k) = sum /= _data[i][i];
+                const T *x_j = x.GetRowPointer(j);
+
+                for (GLuint k = 0; k < x.GetColumnCount(); k++)
+                {
+                    r_i[k] -= x_j[k] * a[j];
+                }
             }
         }
     }
     else
     {
-        GLint size = static_cast<GLint>(GetRowCount());
-        if (static_cast<GLint>(b.GetColumnCount()) != size)
-            return GL_FALSE;
-
-        x = b;
+        CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size * x.GetRowCount(), size);
 
-#pragma omp parallel for
-        for (GLint k = 0; k < static_cast<GLint> (b.GetRowCount()); ++k)
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i = 0; i < size; i++)
         {
-            GLint ii = 0;
-            for (GLint i = 0; i < size; ++i)
-            {
-                GLuint ip = _row_permutation[i];
-                T sum = x(k, ip);
-                x(k, ip) = x(k, i);
-                if (ii != 0)
-                    for (GLint j = ii - 1; j < i; ++j)
-                        sum -= _data[i][j] * x(k, j);
-                else
-                    if (sum != 0.0)
-                        ii = i + 1;
-                x(k, i) = sum;
-            }
+            const GLdouble *a = GetRowPointer(i);
 
-            for (GLint i = size - 1; i >= 0; --i)
+            for (GLuint k = 0; k < x.GetRowCount(); k++)
             {
-                T sum = x(k, i);
-                for (GLint j = i + 1; j < size; ++j)
-                    sum -= _data[i][j] * x(k, j);
-                x(k, i) = sum /= _data[i][i];
+                const T *x_k = x.GetRowPointer(k);
+
+                T sum = x_k[0] * a[0];
+                for (GLint j = 1; j < size; j++)
+                {
+                    sum += x_k[j] * a[j];
+                }
+                r(k, i) -= sum;
             }
         }
     }
+}
+
+template <class T>
+GLboolean RealSquareMatrix::SolveLinearSystem(const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns)
+{
+    if (!_lu_decomposition_is_done)
+        if (!PerformLUDecomposition())
+            return GL_FALSE;
+
+    return LUFactorization::Substitute(*this, _row_permutation, b, x, represent_solutions_as_columns);
+}
+
+template <class T>
+GLboolean RealSquareMatrix::SolveLinearSystemWithIterativeRefinement(
+        const Matrix<T>& b, Matrix<T>& x, GLboolean represent_solutions_as_columns,
+        GLdouble tolerance, GLuint maximum_iteration_count, GLuint *iteration_count)
+{
+    if (_lu_decomposition_is_done)
+    {
+        if (iteration_count)
+            *iteration_count = 0;
+
+        return SolveLinearSystem(b, x, represent_solutions_as_columns);
+    }
+
+    if (!_single_precision_lu_decomposition_is_done)
+        if (!PerformSinglePrecisionLUDecomposition())
+            return GL_FALSE;
+
+    if (represent_solutions_as_columns ? b.GetRowCount() != _row_count : b.GetColumnCount() != _row_count)
+        return GL_FALSE;
+
+    auto solve = [&](const Matrix<T>& r, Matrix<T>& d) -> GLboolean
+    {
+        return LUFactorization::Substitute(_single_precision_factors, _single_precision_row_permutation,
+                                           r, d, represent_solutions_as_columns);
+    };
+
+    auto residual = [&](const Matrix<T>& y, Matrix<T>& r)
+    {
+        r = b;
+        _SubtractProduct(y, r, represent_solutions_as_columns);
+    };
 
-    return GL_TRUE;
+    return RefineIteratively(b, x, solve, residual, tolerance, maximum_iteration_count, iteration_count);
 }
 }
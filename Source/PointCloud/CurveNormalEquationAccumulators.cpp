@@ -0,0 +1,279 @@
+#include "PointCloud/CurveNormalEquationAccumulators.h"
+#include "Core/Exceptions.h"
+#include "Core/CollocationMatrices.h"
+#include "Core/LUFactorizations.h"
+#include "Core/ParallelExecutionPolicies.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace cagd
+{
+CurveNormalEquationAccumulator::CurveNormalEquationAccumulator(KnotVector::Type type, GLuint k, GLuint n, GLdouble u_min, GLdouble u_max):
+    _knot_vector(type, k, n, u_min, u_max),
+    _column_count(_knot_vector.GetN() + 1),
+    _cyclic(type == KnotVector::PERIODIC),
+    _lagged_product_sums(_column_count, k),
+    _FT_X(_column_count),
+    _sample_count(0),
+    _skipped_sample_count(0),
+    _values(k)
+{
+}
+
+GLvoid CurveNormalEquationAccumulator::_AccumulateRow(GLuint i, const GLdouble *N, const DCoordinate3 &x, GLdouble weight,
+                                                      RealMatrix &lagged_product_sums, ColumnMatrix<DCoordinate3> &FT_X) const
+{
+    GLuint k      = _knot_vector.GetOrder();
+    GLuint offset = i - k + 1;
+
+    // in case of periodic knot vectors the last k - 1 basis functions are folded onto the first ones
+    for (GLuint p = 0; p < k; p++)
+    {
+        if (N[p] == 0.0)
+            continue;
+
+        GLuint column = offset + p;
+
+        if (_cyclic && column >= _column_count)
+        {
+            column %= _column_count;
+        }
+
+        GLdouble *b           = lagged_product_sums.GetRowPointer(column);
+        GLdouble weighted_N_p = weight * N[p];
+
+        for (GLuint q = 0; q <= p; q++)
+        {
+            b[p - q] += weighted_N_p * N[q];
+        }
+
+        FT_X[column] += x * weighted_N_p;
+    }
+}
+
+GLboolean CurveNormalEquationAccumulator::AddSample(GLdouble u, const DCoordinate3 &x)
+{
+    GLuint i;
+
+    if (!_knot_vector.EvaluateNonZeroBSplineFunctions(1, &u, &i, _values.data()))
+    {
+        _skipped_sample_count++;
+        return GL_FALSE;
+    }
+
+    _AccumulateRow(i, _values.data(), x, 1.0, _lagged_product_sums, _FT_X);
+    _sample_count++;
+
+    return GL_TRUE;
+}
+
+GLboolean CurveNormalEquationAccumulator::RemoveSample(GLdouble u, const DCoordinate3 &x)
+{
+    GLuint i;
+
+    if (!_knot_vector.EvaluateNonZeroBSplineFunctions(1, &u, &i, _values.data()))
+    {
+        if (_skipped_sample_count)
+        {
+            _skipped_sample_count--;
+        }
+
+        return GL_FALSE;
+    }
+
+    _AccumulateRow(i, _values.data(), x, -1.0, _lagged_product_sums, _FT_X);
+
+    if (_sample_count)
+    {
+        _sample_count--;
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean CurveNormalEquationAccumulator::AddSamples(GLuint count, const GLdouble *u, const DCoordinate3 *x)
+{
+    GLuint k = _knot_vector.GetOrder();
+
+    // the basis functions are evaluated chunk by chunk, i.e., the memory usage does not depend on the number of samples
+    const GLuint chunk_size = 4096;
+
+    GLuint skipped_count = 0;
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(count) * k * (k + 4), count);
+
+    // each thread processes a contiguous part of the samples (e.g., a piece of a scan line with sorted parameter values),
+    // the partial sums of the team are reduced at the end
+#pragma omp parallel reduction(+:skipped_count) if (thread_count > 1) num_threads(thread_count)
+    {
+#ifdef _OPENMP
+        GLuint team_size    = static_cast<GLuint>(omp_get_num_threads());
+        GLuint thread_index = static_cast<GLuint>(omp_get_thread_num());
+#else
+        GLuint team_size    = 1;
+        GLuint thread_index = 0;
+#endif
+        GLuint first = static_cast<GLuint>(static_cast<unsigned long long>(count) * thread_index / team_size);
+        GLuint last  = static_cast<GLuint>(static_cast<unsigned long long>(count) * (thread_index + 1) / team_size);
+
+        RealMatrix                 local_lagged_product_sums(team_size > 1 ? _column_count : 0, team_size > 1 ? k : 0);
+        ColumnMatrix<DCoordinate3> local_FT_X(team_size > 1 ? _column_count : 0);
+
+        RealMatrix                 &lagged_product_sums = (team_size > 1) ? local_lagged_product_sums : _lagged_product_sums;
+        ColumnMatrix<DCoordinate3> &FT_X                = (team_size > 1) ? local_FT_X : _FT_X;
+
+        vector<GLuint>   spans(min(last - first, chunk_size));
+        vector<GLdouble> values(spans.size() * k);
+
+        for (GLuint begin = first; begin < last; begin += chunk_size)
+        {
+            GLuint end = min(begin + chunk_size, last);
+
+            GLboolean sorted = is_sorted(u + begin, u + end);
+
+            if (!_knot_vector.EvaluateNonZeroBSplineFunctions(end - begin, u + begin, spans.data(), values.data(), sorted))
+            {
+                skipped_count += static_cast<GLuint>(std::count(spans.begin(), spans.begin() + (end - begin), KnotVector::INVALID_SPAN));
+            }
+
+            for (GLuint s = begin; s < end; s++)
+            {
+                GLuint span = spans[s - begin];
+
+                if (span != KnotVector::INVALID_SPAN)
+                {
+                    _AccumulateRow(span, values.data() + static_cast<size_t>(s - begin) * k, x[s], 1.0, lagged_product_sums, FT_X);
+                }
+            }
+        }
+
+        if (team_size > 1)
+        {
+#pragma omp critical
+            {
+                for (GLuint c = 0; c < _column_count; c++)
+                {
+                    GLdouble       *b = _lagged_product_sums.GetRowPointer(c);
+                    const GLdouble *l = local_lagged_product_sums.GetRowPointer(c);
+
+                    for (GLuint d = 0; d < k; d++)
+                    {
+                        b[d] += l[d];
+                    }
+
+                    _FT_X[c] += local_FT_X[c];
+                }
+            }
+        }
+    }
+
+    _sample_count         += count - skipped_count;
+    _skipped_sample_count += skipped_count;
+
+    return !skipped_count;
+}
+
+CurveNormalEquationAccumulator& CurveNormalEquationAccumulator::operator +=(const CurveNormalEquationAccumulator &rhs)
+{
+    if (_knot_vector.GetType() != rhs._knot_vector.GetType() ||
+        _knot_vector.GetOrder() != rhs._knot_vector.GetOrder() ||
+        _column_count != rhs._column_count ||
+        _knot_vector.GetMin() != rhs._knot_vector.GetMin() ||
+        _knot_vector.GetMax() != rhs._knot_vector.GetMax())
+    {
+        throw Exception("The settings of the accumulators are different.");
+    }
+
+    GLuint k = _knot_vector.GetOrder();
+
+    for (GLuint c = 0; c < _column_count; c++)
+    {
+        GLdouble       *b = _lagged_product_sums.GetRowPointer(c);
+        const GLdouble *r = rhs._lagged_product_sums.GetRowPointer(c);
+
+        for (GLuint d = 0; d < k; d++)
+        {
+            b[d] += r[d];
+        }
+
+        _FT_X[c] += rhs._FT_X[c];
+    }
+
+    _sample_count         += rhs._sample_count;
+    _skipped_sample_count += rhs._skipped_sample_count;
+
+    return *this;
+}
+
+GLvoid CurveNormalEquationAccumulator::Clear()
+{
+    _lagged_product_sums = RealMatrix(_column_count, _knot_vector.GetOrder());
+    _FT_X                = ColumnMatrix<DCoordinate3>(_column_count);
+
+    _sample_count         = 0;
+    _skipped_sample_count = 0;
+}
+
+unsigned long long CurveNormalEquationAccumulator::GetSampleCount() const
+{
+    return _sample_count;
+}
+
+unsigned long long CurveNormalEquationAccumulator::GetSkippedSampleCount() const
+{
+    return _skipped_sample_count;
+}
+
+const KnotVector& CurveNormalEquationAccumulator::GetKnotVector() const
+{
+    return _knot_vector;
+}
+
+BandedSPDMatrix CurveNormalEquationAccumulator::GramMatrix() const
+{
+    return BandedGramMatrix(_lagged_product_sums, _cyclic);
+}
+
+const ColumnMatrix<DCoordinate3>& CurveNormalEquationAccumulator::GetRightHandSide() const
+{
+    return _FT_X;
+}
+
+BSplineCurve3* CurveNormalEquationAccumulator::GenerateRegressionCurve(const RowMatrix<GLdouble> &weight,
+                                                                       GLuint div_point_count,
+                                                                       GLenum data_usage_flag) const
+{
+    BandedSPDMatrix FT_F = GramMatrix();
+    FT_F += _knot_vector.LookUpTableForCurveOptimizatioin(weight, div_point_count);
+
+    // if the samples do not determine a regular system, we fall back to the pivoted LU decomposition
+    LUFactorization            LU;
+    ColumnMatrix<DCoordinate3> P;
+
+    if (!PerformCholeskyOrLUDecomposition(FT_F, LU) || !SolveLinearSystemByCholeskyOrLUFactors(FT_F, LU, _FT_X, P))
+    {
+        return nullptr;
+    }
+
+    BSplineCurve3 *result = new (nothrow) BSplineCurve3(_knot_vector.GetType(), _knot_vector.GetOrder(), _knot_vector.GetN(),
+                                                        _knot_vector.GetMin(), _knot_vector.GetMax(), data_usage_flag);
+
+    if (!result)
+    {
+        return nullptr;
+    }
+
+    for (GLuint i = 0; i < P.GetRowCount(); i++)
+    {
+        (*result)[i] = P[i];
+    }
+
+    return result;
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "Core/DCoordinates3.h"
+#include "Core/Matrices.h"
+#include "Core/RealMatrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "B-spline/KnotVectors.h"
+#include "B-spline/BSplineCurves3.h"
+#include <vector>
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // Streaming assembly of the normal equations F' * F * P = F' * X of B-spline
+    // regression curves, where the row i of the collocation matrix F stores the
+    // values of the B-spline functions at the parameter value u_i of the i-th
+    // sample point x_i.
+    //
+    // The samples are added one by one or in chunks, while only the band of
+    // F' * F and the (n + 1)-vector F' * X are kept, i.e., neither F nor X is
+    // stored and the memory usage is O(n * k) independently of the number of
+    // samples. A sample updates a k x k block of the band in O(k^2) operations.
+    //
+    // The chunks are processed by per-thread partial sums that are reduced at
+    // the end of the chunk. Accumulators of the same curve settings can also
+    // be merged, e.g., if independent streams of scan lines are processed by
+    // separate accumulators.
+    //
+    // Samples the parameter values of which lie outside the definition domain
+    // are skipped and counted. Since the sums are linear in the samples,
+    // samples can also be removed (see also IncrementalCurveRegressor).
+    //--------------------------------------------------------------------------
+    class CurveNormalEquationAccumulator
+    {
+    protected:
+        KnotVector                  _knot_vector;
+        GLuint                      _column_count;          // n + 1
+        GLboolean                   _cyclic;
+
+        // the sums _lagged_product_sums(c, d) of the products of the basis function values that belong to
+        // the columns c and c - d of the same rows (see the free function BandedGramMatrix in CollocationMatrices.h)
+        RealMatrix                  _lagged_product_sums;   // (n + 1) x k
+        ColumnMatrix<DCoordinate3>  _FT_X;
+
+        unsigned long long          _sample_count;
+        unsigned long long          _skipped_sample_count;
+
+        // basis function values of AddSample
+        std::vector<GLdouble>       _values;
+
+        // adds the products of the k non-vanishing basis function values N of the span i and the position x
+        // multiplied by weight to the given sums
+        GLvoid _AccumulateRow(GLuint i, const GLdouble *N, const DCoordinate3 &x, GLdouble weight,
+                              RealMatrix &lagged_product_sums, ColumnMatrix<DCoordinate3> &FT_X) const;
+
+    public:
+        // the settings correspond to the constructor of BSplineCurve3
+        CurveNormalEquationAccumulator(KnotVector::Type type, GLuint k, GLuint n, GLdouble u_min = 0.0, GLdouble u_max = 1.0);
+
+        // adds a single sample point,
+        // returns GL_FALSE if the parameter value lies outside the definition domain
+        GLboolean AddSample(GLdouble u, const DCoordinate3 &x);
+
+        // adds a chunk of sample points, the parameter values do not have to be sorted,
+        // returns GL_FALSE if at least one parameter value lies outside the definition domain
+        GLboolean AddSamples(GLuint count, const GLdouble *u, const DCoordinate3 *x);
+
+        // subtracts the terms of a sample point that has been added before,
+        // returns GL_FALSE if the parameter value lies outside the definition domain
+        GLboolean RemoveSample(GLdouble u, const DCoordinate3 &x);
+
+        // merges the sums of another accumulator of the same settings
+        CurveNormalEquationAccumulator& operator +=(const CurveNormalEquationAccumulator &rhs);
+
+        // forgets all samples
+        GLvoid Clear();
+
+        // number of the accumulated and skipped samples
+        unsigned long long GetSampleCount() const;
+        unsigned long long GetSkippedSampleCount() const;
+
+        const KnotVector& GetKnotVector() const;
+
+        // F' * F in banded form (cyclic in case of periodic knot vectors)
+        BandedSPDMatrix GramMatrix() const;
+
+        // F' * X
+        const ColumnMatrix<DCoordinate3>& GetRightHandSide() const;
+
+        // solves the normal equations extended by the energy terms of the given weights
+        // (see KnotVector::LookUpTableForCurveOptimizatioin), returns a null pointer if the system is singular
+        BSplineCurve3* GenerateRegressionCurve(const RowMatrix<GLdouble> &weight,
+                                               GLuint div_point_count = 500,
+                                               GLenum data_usage_flag = GL_STATIC_DRAW) const;
+    };
+}
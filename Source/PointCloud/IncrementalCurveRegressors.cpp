@@ -0,0 +1,162 @@
+#include "PointCloud/IncrementalCurveRegressors.h"
+
+using namespace std;
+
+namespace cagd
+{
+IncrementalCurveRegressor::IncrementalCurveRegressor(KnotVector::Type type, GLuint k, GLuint n,
+                                                     const RowMatrix<GLdouble> &weight,
+                                                     GLdouble u_min, GLdouble u_max,
+                                                     GLuint div_point_count):
+    _accumulator(type, k, n, u_min, u_max),
+    _energy(_accumulator.GetKnotVector().LookUpTableForCurveOptimizatioin(weight, div_point_count)),
+    _factor_is_valid(GL_FALSE),
+    _control_points_are_valid(GL_FALSE),
+    _control_points(n + 1),
+    _values(k)
+{
+}
+
+GLvoid IncrementalCurveRegressor::_ModifyFactor(GLdouble u, GLboolean downdate)
+{
+    if (!_factor_is_valid)
+        return;
+
+    const KnotVector &knot_vector = _accumulator.GetKnotVector();
+
+    // neither the LU factors nor the cyclic banded factors can be modified in place
+    if (_LU.IsDone() || knot_vector.GetType() == KnotVector::PERIODIC)
+    {
+        _factor_is_valid = GL_FALSE;
+        return;
+    }
+
+    GLuint i;
+
+    if (!knot_vector.EvaluateNonZeroBSplineFunctions(1, &u, &i, _values.data()))
+        return;
+
+    GLuint k     = knot_vector.GetOrder();
+    GLuint first = i - k + 1;
+
+    _factor_is_valid = downdate ? _factor.DowndateCholeskyDecomposition(first, k, _values.data())
+                                : _factor.UpdateCholeskyDecomposition(first, k, _values.data());
+}
+
+GLboolean IncrementalCurveRegressor::AddSample(GLdouble u, const DCoordinate3 &x)
+{
+    if (!_accumulator.AddSample(u, x))
+        return GL_FALSE;
+
+    _ModifyFactor(u, GL_FALSE);
+    _control_points_are_valid = GL_FALSE;
+
+    return GL_TRUE;
+}
+
+GLboolean IncrementalCurveRegressor::RemoveSample(GLdouble u, const DCoordinate3 &x)
+{
+    if (!_accumulator.RemoveSample(u, x))
+        return GL_FALSE;
+
+    _ModifyFactor(u, GL_TRUE);
+    _control_points_are_valid = GL_FALSE;
+
+    return GL_TRUE;
+}
+
+GLboolean IncrementalCurveRegressor::UpdateSample(GLdouble old_u, const DCoordinate3 &old_x, GLdouble new_u, const DCoordinate3 &new_x)
+{
+    // only the right-hand side depends on the positions
+    if (old_u == new_u)
+    {
+        GLboolean result = _accumulator.RemoveSample(old_u, old_x);
+
+        _accumulator.AddSample(new_u, new_x);
+        _control_points_are_valid = GL_FALSE;
+
+        return result;
+    }
+
+    // the update precedes the downdate, since the latter is more likely to succeed in case of a larger matrix
+    GLboolean result = AddSample(new_u, new_x);
+
+    return RemoveSample(old_u, old_x) && result;
+}
+
+GLboolean IncrementalCurveRegressor::AddSamples(GLuint count, const GLdouble *u, const DCoordinate3 *x)
+{
+    if (!count)
+        return GL_TRUE;
+
+    GLboolean result = _accumulator.AddSamples(count, u, x);
+
+    _factor_is_valid          = GL_FALSE;
+    _control_points_are_valid = GL_FALSE;
+
+    return result;
+}
+
+GLboolean IncrementalCurveRegressor::Refactorize()
+{
+    _control_points_are_valid = GL_FALSE;
+
+    _factor  = _accumulator.GramMatrix();
+    _factor += _energy;
+
+    // if the sample points do not determine a regular system, we fall back to the pivoted LU decomposition
+    _factor_is_valid = PerformCholeskyOrLUDecomposition(_factor, _LU);
+
+    return _factor_is_valid;
+}
+
+GLboolean IncrementalCurveRegressor::GetControlPoints(ColumnMatrix<DCoordinate3> &P)
+{
+    if (!_control_points_are_valid)
+    {
+        if (!_factor_is_valid && !Refactorize())
+            return GL_FALSE;
+
+        const ColumnMatrix<DCoordinate3> &FT_X = _accumulator.GetRightHandSide();
+
+        if (!SolveLinearSystemByCholeskyOrLUFactors(_factor, _LU, FT_X, _control_points))
+            return GL_FALSE;
+
+        _control_points_are_valid = GL_TRUE;
+    }
+
+    P = _control_points;
+
+    return GL_TRUE;
+}
+
+BSplineCurve3* IncrementalCurveRegressor::GenerateRegressionCurve(GLenum data_usage_flag)
+{
+    ColumnMatrix<DCoordinate3> P;
+
+    if (!GetControlPoints(P))
+        return nullptr;
+
+    const KnotVector &knot_vector = _accumulator.GetKnotVector();
+
+    BSplineCurve3 *result = new (nothrow) BSplineCurve3(knot_vector.GetType(), knot_vector.GetOrder(), knot_vector.GetN(),
+                                                        knot_vector.GetMin(), knot_vector.GetMax(), data_usage_flag);
+
+    if (!result)
+    {
+        return nullptr;
+    }
+
+    for (GLuint i = 0; i < P.GetRowCount(); i++)
+    {
+        (*result)[i] = P[i];
+    }
+
+    return result;
+}
+
+const CurveNormalEquationAccumulator& IncrementalCurveRegressor::GetAccumulator() const
+{
+    return _accumulator;
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "Core/DCoordinates3.h"
+#include "Core/Matrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "Core/LUFactorizations.h"
+#include "B-spline/BSplineCurves3.h"
+#include "PointCloud/CurveNormalEquationAccumulators.h"
+#include <vector>
+
+namespace cagd
+{
+    //--------------------------------------------------------------------------
+    // B-spline regression curve that is refitted after the insertion, removal
+    // or modification of a few sample points without assembling and factorizing
+    // the normal equations (F' * F + E) * P = F' * X again, where E denotes the
+    // weighted energy terms.
+    //
+    // A sample point of the parameter value u contributes the rank-one term
+    // N * N' to F' * F, where N consists of the k non-vanishing B-spline function
+    // values over the span of u. Therefore the banded Cholesky factor of the
+    // coefficient matrix is kept and modified by rank-one updates and downdates
+    // (see BandedSPDMatrix::UpdateCholeskyDecomposition) in O(n * k) operations,
+    // while the right-hand side is maintained by a CurveNormalEquationAccumulator
+    // in O(k^2) ones. The control points are refreshed on demand by O(n * k)
+    // substitutions.
+    //
+    // The factor is determined again in O(n * k^2) operations from the sums of
+    // the accumulator if it does not exist yet, if a downdate fails, after bulk
+    // insertions (AddSamples) and in case of periodic knot vectors, the cyclic
+    // factors of which cannot be modified in place. If the samples do not
+    // determine a regular system, the pivoted LU decomposition of the dense
+    // coefficient matrix is used (see PerformCholeskyOrLUDecomposition).
+    //
+    // The removed or modified samples have to be passed with the same parameter
+    // values and positions with which they have been added.
+    //--------------------------------------------------------------------------
+    class IncrementalCurveRegressor
+    {
+    protected:
+        CurveNormalEquationAccumulator  _accumulator;
+        BandedSPDMatrix                 _energy;                // E
+
+        GLboolean                       _factor_is_valid;
+        BandedSPDMatrix                 _factor;                // banded Cholesky factor of F' * F + E
+        LUFactorization                 _LU;                    // fallback, if the banded factor does not exist
+
+        GLboolean                       _control_points_are_valid;
+        ColumnMatrix<DCoordinate3>      _control_points;
+
+        // non-vanishing basis function values of a sample point
+        std::vector<GLdouble>           _values;
+
+        // rank-one modification of the banded factor by the basis function values of u,
+        // invalidates the factor if the modification cannot be performed in place
+        GLvoid _ModifyFactor(GLdouble u, GLboolean downdate);
+
+    public:
+        // the settings correspond to the ones of PointCloudAroundCurve3::GenerateRegressionCurve
+        IncrementalCurveRegressor(KnotVector::Type type, GLuint k, GLuint n,
+                                  const RowMatrix<GLdouble> &weight,
+                                  GLdouble u_min = 0.0, GLdouble u_max = 1.0,
+                                  GLuint div_point_count = 500);
+
+        // the following methods return GL_FALSE if the parameter value lies outside the definition domain,
+        // in which case the sample does not influence the curve
+        GLboolean AddSample(GLdouble u, const DCoordinate3 &x);
+        GLboolean RemoveSample(GLdouble u, const DCoordinate3 &x);
+
+        // replaces a sample point, if only its position changes, the factor is not modified
+        GLboolean UpdateSample(GLdouble old_u, const DCoordinate3 &old_x, GLdouble new_u, const DCoordinate3 &new_x);
+
+        // adds many sample points at once, the factor is determined again by the next refit
+        GLboolean AddSamples(GLuint count, const GLdouble *u, const DCoordinate3 *x);
+
+        // determines the factor from the accumulated sums, e.g., in order to discard the rounding errors of
+        // a long sequence of rank-one modifications; returns GL_FALSE if the coefficient matrix is singular
+        GLboolean Refactorize();
+
+        // solves the normal equations if the samples have changed since the last call,
+        // returns GL_FALSE if the coefficient matrix is singular
+        GLboolean GetControlPoints(ColumnMatrix<DCoordinate3> &P);
+
+        // a new curve of the current control points, or a null pointer if the coefficient matrix is singular
+        BSplineCurve3* GenerateRegressionCurve(GLenum data_usage_flag = GL_STATIC_DRAW);
+
+        const CurveNormalEquationAccumulator& GetAccumulator() const;
+    };
+}
@@ -2,9 +2,13 @@
 #include "Core/Exceptions.h"
 #include "Core/RealMatrices.h"
 #include "Core/RealSquareMatrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "Core/CollocationMatrices.h"
 #include "Core/Materials.h"
 #include "Core/Constants.h"
+#include "Core/ParallelExecutionPolicies.h"
 
+#include <algorithm>
 #include <limits>
 #include <random>
 #include <math.h>
@@ -65,27 +69,31 @@ bool PointCloudAroundCurve3::GeneratePointCloudAroundParametricCurve(
         normrnd[j] = new NormalRNG(0, sigma[j]);
     }
 
-    ///  X = c(U) + epsilon
-#pragma omp parallel for
-    for (GLint i = 0; i < static_cast<GLint> (sample_size); i++)
+    // the random number generators cannot be shared by threads, therefore the random values are drawn serially
+    // in advance and only the evaluation of the curve is parallelised
+    for (GLuint i = 0; i < sample_size; i++)
     {
         // generating random value in range of parametric curve
-        GLdouble u = dist(rng);
+        _cloud[i].parameter_value = dist(rng);
+    }
 
-        _cloud[i].parameter_value = u;
+    // noise for each coordinate axis, the j-th normal rng gives all values of the j-th axis in a row matrix
+    RowMatrix< RowMatrix<GLdouble> > epsilon(sigma.GetColumnCount());
 
-        // calculating epsilon value
-        // noise for each coordinate axis
-        RowMatrix<GLdouble> epsilon(sigma.GetColumnCount());
-        for (GLuint j = 0; j < sigma.GetColumnCount(); j++)
-        {
-            // the j -th normal rng give 1 value in a row matrix
-            epsilon[j] = (*normrnd[j])(1)[0];
-        }
+    for (GLuint j = 0; j < sigma.GetColumnCount(); j++)
+    {
+        epsilon[j] = (*normrnd[j])(sample_size);
+    }
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(64.0 * sample_size, sample_size);
 
+    ///  X = c(U) + epsilon
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint> (sample_size); i++)
+    {
         // the value of function c(u)
         DCoordinate3 c_u = pc(0, _cloud[i].parameter_value);
-        _cloud[i].position = DCoordinate3(c_u.x() + epsilon[0], c_u.y() + epsilon[1], c_u.z() + epsilon[2]);
+        _cloud[i].position = DCoordinate3(c_u.x() + epsilon[0][i], c_u.y() + epsilon[1][i], c_u.z() + epsilon[2][i]);
     }
 
     return true;
@@ -130,55 +138,65 @@ BSplineCurve3* PointCloudAroundCurve3::GenerateRegressionCurve(KnotVector::Type
                                                                GLuint div_point_count,
                                                                GLenum data_usage_flag) const
 {
-    BSplineCurve3* result = new BSplineCurve3(type, k, n, u_min, u_max, data_usage_flag);
+    BSplineCurve3* result = new (nothrow) BSplineCurve3(type, k, n, u_min, u_max, data_usage_flag);
 
     if (!result)
     {
         return nullptr;
     }
 
-    // non-square collocation matrix:
-    RealMatrix F(_cloud.GetColumnCount(), n + 1);
+    // sparse non-square collocation matrix:
+    RowMatrix<GLdouble> parameter_values(_cloud.GetColumnCount());
     ColumnMatrix<DCoordinate3> X(_cloud.GetColumnCount());
 
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(4.0 * _cloud.GetColumnCount(), _cloud.GetColumnCount());
 
-#pragma omp parallel for
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i = 0; i < static_cast<GLint> (_cloud.GetColumnCount()); i++)
     {
-        RowMatrix<GLdouble> values(1);
-        switch(type)
-        {
-        case KnotVector::CLAMPED:
-            result->BlendingFunctionValues(_cloud[i].parameter_value, values);
-            break;
-        case KnotVector::UNCLAMPED:
-            result->BlendingFunctionValues(_cloud[i].parameter_value, values);
-            break;
-        case KnotVector::PERIODIC:
-            result->BlendingFunctionValuesForPeriodicRegressionCurve(_cloud[i].parameter_value, values);
-            break;
-        }
-
-        // set row of F
-        F.SetRow(i, values);
+        parameter_values[i] = _cloud[i].parameter_value;
         X[i] = _cloud[i].position;
     }
 
-    // FT = F'; FT_F = FT * F;
-    RealMatrix FT_F = F.Transpose() * F;
+    lock_guard<mutex> lock(_normal_equations_mutex);
 
-    RealMatrix A = result->GetKnotVector()->LookUpTableForCurveOptimizatioin(weight, div_point_count);
+    NormalEquations &equations = _normal_equations;
 
-    FT_F = FT_F + A;
+    if (!equations.Matches(type, k, n, weight, u_min, u_max, div_point_count, parameter_values))
+    {
+        equations.is_valid = GL_FALSE;
+
+        result->GetKnotVector()->GenerateCollocationMatrix(parameter_values, equations.F);
+
+        // FT_F = F' * F + energy terms is symmetric positive definite with half-bandwidth k - 1, in case of periodic
+        // knot vectors the folded basis functions also couple the first and last k - 1 control points,
+        // in both cases the system is assembled in O(n * k) memory and it can be solved in O(n * k^2) operations
+        equations.banded_FT_F = equations.F.BandedGramMatrix();
+        equations.banded_FT_F += result->GetKnotVector()->LookUpTableForCurveOptimizatioin(weight, div_point_count);
+
+        // if the sample points do not determine a regular system, we fall back to the pivoted LU decomposition
+        PerformCholeskyOrLUDecomposition(equations.banded_FT_F, equations.FT_F);
+
+        equations.type = type;
+        equations.k = k;
+        equations.n = n;
+        equations.weight.assign(weight.GetRowPointer(0), weight.GetRowPointer(0) + weight.GetColumnCount());
+        equations.u_min = u_min;
+        equations.u_max = u_max;
+        equations.div_point_count = div_point_count;
+        equations.parameter_values.assign(parameter_values.GetRowPointer(0), parameter_values.GetRowPointer(0) + parameter_values.GetColumnCount());
+        equations.is_valid = GL_TRUE;
+    }
 
-    RealSquareMatrix FT_F2(FT_F);
-    ColumnMatrix<DCoordinate3> FT_X;
-    FT_X = F.Transpose() * X;
+    ColumnMatrix<DCoordinate3> FT_X = equations.F.TransposeTimes(X);
     // P = inv(FT_F) * FT_X;
     ColumnMatrix<DCoordinate3> P;
-    FT_F2.SolveLinearSystem(FT_X, P);
 
-#pragma omp parallel for
+    SolveLinearSystemByCholeskyOrLUFactors(equations.banded_FT_F, equations.FT_F, FT_X, P);
+
+    thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * P.GetRowCount(), P.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i = 0; i < static_cast<GLint> (P.GetRowCount()); i++)
     {
         (*result)[i] = P[i];
@@ -187,6 +205,27 @@ BSplineCurve3* PointCloudAroundCurve3::GenerateRegressionCurve(KnotVector::Type
     return result;
 }
 
+PointCloudAroundCurve3::NormalEquations::NormalEquations():
+    is_valid(GL_FALSE),
+    type(KnotVector::CLAMPED), k(0), n(0),
+    u_min(0.0), u_max(0.0),
+    div_point_count(0)
+{
+}
+
+GLboolean PointCloudAroundCurve3::NormalEquations::Matches(KnotVector::Type type, GLuint k, GLuint n,
+                                                           const RowMatrix<GLdouble> &weight,
+                                                           GLdouble u_min, GLdouble u_max, GLuint div_point_count,
+                                                           const RowMatrix<GLdouble> &parameter_values) const
+{
+    return is_valid &&
+           this->type == type && this->k == k && this->n == n &&
+           this->u_min == u_min && this->u_max == u_max && this->div_point_count == div_point_count &&
+           this->weight.size() == weight.GetColumnCount() &&
+           equal(this->weight.begin(), this->weight.end(), weight.GetRowPointer(0)) &&
+           this->parameter_values.size() == parameter_values.GetColumnCount() &&
+           equal(this->parameter_values.begin(), this->parameter_values.end(), parameter_values.GetRowPointer(0));
+}
 
 void PointCloudAroundCurve3::FindTheInterval(GLdouble &u_min, GLdouble &u_max)
 {
@@ -2,12 +2,17 @@
 
 #include "Core/DCoordinates3.h"
 #include "Core/Matrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "Core/CollocationMatrices.h"
+#include "Core/LUFactorizations.h"
 #include "Core/TriangulatedMeshes3.h"
 #include "Parametric/ParametricCurves3.h"
 #include "RandomNumberGenerator/NormalRNG.h"
 #include "B-spline/BSplineCurves3.h"
 
 #include <QTextStream>
+#include <mutex>
+#include <vector>
 
 using namespace std;
 
@@ -30,7 +35,40 @@ namespace cagd
         };
 
     private:
-        RowMatrix<SamplePoint> _cloud;
+        // The factorized normal equations of the latest regression. The coefficient matrix depends only
+        // on the fitting settings and on the parameter values of the samples, therefore its factorization
+        // is reused as long as these do not change (e.g., if only the positions of the sample points are
+        // updated between consecutive frames). In this case a new fit requires only O(N * k) operations
+        // for the right-hand side and O(n * k) ones for the substitutions.
+        class NormalEquations
+        {
+        public:
+            GLboolean               is_valid;
+
+            // fitting settings and parameter values that determine the coefficient matrix
+            KnotVector::Type        type;
+            GLuint                  k, n;
+            std::vector<GLdouble>   weight;
+            GLdouble                u_min, u_max;
+            GLuint                  div_point_count;
+            std::vector<GLdouble>   parameter_values;
+
+            CollocationMatrix       F;
+            BandedSPDMatrix         banded_FT_F;    // banded Cholesky factor of F'F + energy terms
+            LUFactorization         FT_F;           // fallback, if the banded factor does not exist
+
+            NormalEquations();
+
+            GLboolean Matches(KnotVector::Type type, GLuint k, GLuint n,
+                              const RowMatrix<GLdouble> &weight,
+                              GLdouble u_min, GLdouble u_max, GLuint div_point_count,
+                              const RowMatrix<GLdouble> &parameter_values) const;
+        };
+
+        RowMatrix<SamplePoint>      _cloud;
+
+        mutable NormalEquations     _normal_equations;
+        mutable std::mutex          _normal_equations_mutex;
 
     public:
         PointCloudAroundCurve3();
@@ -48,7 +86,8 @@ namespace cagd
         // Render the points of cloud
         bool RenderPointCloud(TriangulatedMesh3 *sphere, double point_size, bool dark_mode = true, bool default_color = true);
 
-        // Setting BSpline curve from cloud
+        // Setting BSpline curve from cloud,
+        // the factorized normal equations are reused by consecutive calls (see NormalEquations)
         BSplineCurve3* GenerateRegressionCurve(KnotVector::Type type, GLuint k, GLuint n,
                                                const RowMatrix<GLdouble> &weight,
                                                GLdouble u_min = 0.0, GLdouble u_max = 1.0,
@@ -1,9 +1,14 @@
 #include "PointCloudAroundSurface3.h"
 
 #include "Core/RealSquareMatrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "Core/CollocationMatrices.h"
+#include "Core/KroneckerProductSums.h"
 #include "Core/Materials.h"
 #include "Core/Constants.h"
+#include "Core/ParallelExecutionPolicies.h"
 
+#include <algorithm>
 #include <limits>
 #include <random>
 #include <cmath>
@@ -12,6 +17,65 @@ using namespace std;
 
 namespace cagd
 {
+// coordinate-wise Frobenius inner products of two control nets
+static DCoordinate3 CoordinatewiseInnerProduct(const Matrix<DCoordinate3>& A, const Matrix<DCoordinate3>& B)
+{
+    GLdouble x = 0.0, y = 0.0, z = 0.0;
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * A.GetRowCount() * A.GetColumnCount(), A.GetRowCount());
+
+#pragma omp parallel for reduction(+:x, y, z) if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(A.GetRowCount()); i++)
+    {
+        const DCoordinate3 *a = A.GetRowPointer(i);
+        const DCoordinate3 *b = B.GetRowPointer(i);
+
+        for (GLuint j = 0; j < A.GetColumnCount(); j++)
+        {
+            x += a[j].x() * b[j].x();
+            y += a[j].y() * b[j].y();
+            z += a[j].z() * b[j].z();
+        }
+    }
+
+    return DCoordinate3(x, y, z);
+}
+
+// Y = Y + alpha * X, where the coordinates are scaled independently
+static GLvoid CoordinatewiseAddScaled(Matrix<DCoordinate3>& Y, const DCoordinate3& alpha, const Matrix<DCoordinate3>& X)
+{
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * Y.GetRowCount() * Y.GetColumnCount(), Y.GetRowCount());
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+    for (GLint i = 0; i < static_cast<GLint>(Y.GetRowCount()); i++)
+    {
+        DCoordinate3       *y = Y.GetRowPointer(i);
+        const DCoordinate3 *x = X.GetRowPointer(i);
+
+        for (GLuint j = 0; j < Y.GetColumnCount(); j++)
+        {
+            for (GLuint c = 0; c < 3; c++)
+            {
+                y[j][c] += alpha[c] * x[j][c];
+            }
+        }
+    }
+}
+
+PointCloudAroundSurface3::IterativeSolverSettings::IterativeSolverSettings(
+        GLdouble tolerance, GLuint maximum_iteration_count, const Matrix<DCoordinate3> *initial_control_net):
+    tolerance(tolerance),
+    maximum_iteration_count(maximum_iteration_count),
+    initial_control_net(initial_control_net)
+{
+}
+
+PointCloudAroundSurface3::KroneckerSolverSettings::KroneckerSolverSettings(GLdouble tolerance, GLuint maximum_iteration_count):
+    tolerance(tolerance),
+    maximum_iteration_count(maximum_iteration_count)
+{
+}
+
 PointCloudAroundSurface3::PointCloudAroundSurface3()
 {
     _cloud.ResizeRows(1);
@@ -65,29 +129,41 @@ bool PointCloudAroundSurface3::GeneratePointCloudAroundParametricSurface(
 
     RowMatrix<NormalRNG*> normrnd(3);
 
-#pragma omp parallel for
     for (GLint j = 0; j < static_cast<GLint> (sigma.GetColumnCount()); j++)
     {
         normrnd[j] = new NormalRNG(0, sigma[j]);
     }
 
+    // the random number generators cannot be shared by threads, therefore the random values are drawn serially
+    // in advance and only the evaluation of the surface is parallelised
+
     // generating random value in range of parametric surface
     RowMatrix<GLdouble> U(u_sample_size);
-#pragma omp parallel for
+
     for (GLint j = 0; j < static_cast<GLint> (u_sample_size); j++)
     {
         U[j] = dist_u(rng);
     }
 
     RowMatrix<GLdouble> V(v_sample_size);
-#pragma omp parallel for
+
     for (GLint j = 0; j < static_cast<GLint> (v_sample_size); j++)
     {
         V[j] = dist_v(rng);
     }
 
+    // noise for each coordinate axis, the k-th normal rng gives all values of the k-th axis in a row matrix
+    RowMatrix< RowMatrix<GLdouble> > epsilon(3);
+
+    for (GLuint k = 0; k < 3; k++)
+    {
+        epsilon[k] = (*normrnd[k])(u_sample_size * v_sample_size);
+    }
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(64.0 * u_sample_size * v_sample_size, u_sample_size * v_sample_size);
+
     ///  X = c(U, V) + epsilon
-#pragma omp parallel for
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i_j = 0; i_j < static_cast<GLint> (u_sample_size * v_sample_size); i_j++)
     {
         GLint i = i_j / v_sample_size;
@@ -96,18 +172,9 @@ bool PointCloudAroundSurface3::GeneratePointCloudAroundParametricSurface(
         _cloud(i, j).parameter_value_u = U[i];
         _cloud(i, j).parameter_value_v = V[j];
 
-        // calculating epsilon value
-        // noise for each coordinate axis
-        RowMatrix<GLdouble> epsilon(3);
-        for (GLuint k = 0; k < 3; k++)
-        {
-            // the k -th normal rng give 1 value in a row matrix
-            epsilon[k] = (*normrnd[k])(1)[0];
-        }
-
         // the value of function c(u, v)
         DCoordinate3 c_u_v = ps(U[i], V[j]);
-        _cloud(i, j).position = DCoordinate3(c_u_v.x() + epsilon[0], c_u_v.y() + epsilon[1], c_u_v.z() + epsilon[2]);
+        _cloud(i, j).position = DCoordinate3(c_u_v.x() + epsilon[0][i_j], c_u_v.y() + epsilon[1][i_j], c_u_v.z() + epsilon[2][i_j]);
 
     }
     return true;
@@ -156,7 +223,10 @@ BSplinePatch3* PointCloudAroundSurface3::GenerateRegressionSurface(const RowMatr
                                                                    GLuint u_n, GLuint v_n,
                                                                    GLdouble u_min, GLdouble u_max,
                                                                    GLdouble v_min, GLdouble v_max,
-                                                                   GLuint div_point_count) const
+                                                                   GLuint div_point_count,
+                                                                   const IterativeSolverSettings *iterative_solver,
+                                                                   IterativeSolverReport *report,
+                                                                   const KroneckerSolverSettings *kronecker_solver) const
 {
     BSplinePatch3* result = new (nothrow) BSplinePatch3(u_type, v_type, u_k, v_k, u_n, v_n, u_min, u_max, v_min, v_max);
 
@@ -167,55 +237,26 @@ BSplinePatch3* PointCloudAroundSurface3::GenerateRegressionSurface(const RowMatr
 
     GLuint u_cloud_size = _cloud.GetRowCount();
     GLuint v_cloud_size = _cloud.GetColumnCount();
-    RealMatrix F(u_cloud_size, u_n + 1);
-    RealMatrix G(v_cloud_size, v_n + 1);
     GLuint rho = weight.GetColumnCount();
 
-#pragma omp parallel for
-    for (GLint i = 0; i < static_cast<GLint> (u_cloud_size); i++)    // setting F matrix
-    {
-        RowMatrix<GLdouble> u_blending_values(u_n + 1);
-        switch(u_type)
-        {
-        case KnotVector::CLAMPED:
-            result->UBlendingFunctionValues(_cloud(i, 0).parameter_value_u, u_blending_values);
-            break;
-        case KnotVector::UNCLAMPED:
-            result->UBlendingFunctionValues(_cloud(i, 0).parameter_value_u, u_blending_values);
-            break;
-        case KnotVector::PERIODIC:
-            result->UBlendingFunctionValuesForPeriodicRegressionSurface(_cloud(i, 0).parameter_value_u, u_blending_values);
-            break;
-        }
+    // sparse collocation matrices F and G of the two directions
+    RowMatrix<GLdouble> u_parameter_values(u_cloud_size), v_parameter_values(v_cloud_size);
 
-        // set row of F
-        F.SetRow(i, u_blending_values);
+    for (GLuint i = 0; i < u_cloud_size; i++)
+    {
+        u_parameter_values[i] = _cloud(i, 0).parameter_value_u;
     }
 
-#pragma omp parallel for
-    for (GLint i = 0; i < static_cast<GLint> (v_cloud_size); i++)    // setting G matrix
+    for (GLuint j = 0; j < v_cloud_size; j++)
     {
-        RowMatrix<GLdouble> v_blending_values(1);
-        GLdouble v = _cloud(0, i).parameter_value_v;
-        switch(v_type)
-        {
-        case KnotVector::CLAMPED:
-            result->VBlendingFunctionValues(v, v_blending_values);
-            break;
-        case KnotVector::UNCLAMPED:
-            result->VBlendingFunctionValues(v, v_blending_values);
-            break;
-        case KnotVector::PERIODIC:
-            result->VBlendingFunctionValuesForPeriodicRegressionSurface(v, v_blending_values);
-            break;
-        }
-
-        // set row of G
-        G.SetRow(i, v_blending_values);
+        v_parameter_values[j] = _cloud(0, j).parameter_value_v;
     }
 
     Matrix<DCoordinate3> D(u_cloud_size, v_cloud_size);
-#pragma omp parallel for
+
+    CAGD_OPENMP_ONLY GLint thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * u_cloud_size * v_cloud_size, u_cloud_size * v_cloud_size);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i_j = 0; i_j < static_cast<GLint> (u_cloud_size * v_cloud_size); i_j++)      // setting D matrix
     {
         GLint i = i_j / v_cloud_size;
@@ -223,83 +264,418 @@ BSplinePatch3* PointCloudAroundSurface3::GenerateRegressionSurface(const RowMatr
         D(i, j) = _cloud(i, j).position;
     }
 
-    // Y = F' * D * G
-    Matrix<DCoordinate3> Y = F.Transpose() * D * G;
+    lock_guard<mutex> lock(_normal_equations_mutex);
 
-    GLuint size = (u_n + 1) * (v_n + 1);
-    ColumnMatrix<DCoordinate3> b(size);
-    for (GLuint i = 0; i < u_n + 1; i++)
+    NormalEquations &equations = _normal_equations;
+
+    if (!equations.Matches(u_type, v_type, u_k, v_k, u_n, v_n, u_min, u_max, v_min, v_max,
+                           div_point_count, u_parameter_values, v_parameter_values))
     {
-        for (GLuint j = 0;  j < v_n + 1; j++)
+        equations.is_valid = GL_FALSE;
+        equations.energy_terms_are_valid = GL_FALSE;
+
+        result->GetKnotVectorU()->GenerateCollocationMatrix(u_parameter_values, equations.F);
+        result->GetKnotVectorV()->GenerateCollocationMatrix(v_parameter_values, equations.G);
+
+        // both directional Gram matrices are symmetric positive definite with half-bandwidths u_k - 1 and v_k - 1,
+        // respectively (cyclic in case of periodic directions), unless the sample points do not determine them
+        equations.banded_FT_F = equations.F.BandedGramMatrix();
+        equations.banded_GT_G = equations.G.BandedGramMatrix();
+
+        // dense copies for the Kronecker product solvers
+        equations.FT_F = equations.banded_FT_F.ToRealMatrix();
+        equations.GT_G = equations.banded_GT_G.ToRealMatrix();
+
+        equations.banded_factors_exist = equations.banded_FT_F.PerformCholeskyDecomposition() &&
+                                         equations.banded_GT_G.PerformCholeskyDecomposition();
+
+        equations.u_type = u_type;
+        equations.v_type = v_type;
+        equations.u_k = u_k;
+        equations.v_k = v_k;
+        equations.u_n = u_n;
+        equations.v_n = v_n;
+        equations.u_min = u_min;
+        equations.u_max = u_max;
+        equations.v_min = v_min;
+        equations.v_max = v_max;
+        equations.div_point_count = div_point_count;
+        equations.u_parameter_values.assign(u_parameter_values.GetRowPointer(0), u_parameter_values.GetRowPointer(0) + u_cloud_size);
+        equations.v_parameter_values.assign(v_parameter_values.GetRowPointer(0), v_parameter_values.GetRowPointer(0) + v_cloud_size);
+        equations.is_valid = GL_TRUE;
+    }
+
+    // if only the weights have changed, merely the weighted energy terms and the objects that depend on them are
+    // determined again, the unweighted look-up tables of the knot vectors are not integrated again either
+    if (!equations.MatchesWeights(weight))
+    {
+        equations.energy_terms_are_valid = GL_FALSE;
+
+        equations.has_energy_terms = GL_FALSE;
+        equations.fi = TriangularMatrix<BandedSPDMatrix>(rho + 1);
+        equations.gamma = TriangularMatrix<BandedSPDMatrix>(rho + 1);
+
+        for (GLuint r = 1; r <= rho; r++)
         {
-            b[i * (v_n + 1) + j] = Y(i, j);
+            if (weight[r - 1] != 0.0)
+            {
+                equations.has_energy_terms = GL_TRUE;
+
+                RowMatrix<BandedSPDMatrix*> derivatives_fi = result->GetKnotVectorU()->LookUpTablesForSurfaceOptimizatioin(weight[r - 1], r, div_point_count);
+                RowMatrix<BandedSPDMatrix*> derivatives_gamma = result->GetKnotVectorV()->LookUpTablesForSurfaceOptimizatioin(weight[r - 1], r, div_point_count);
+                for (GLuint zeta = 0; zeta <= r; zeta ++)
+                {
+                    equations.fi(r, zeta) = std::move(*derivatives_fi(zeta));
+                    equations.gamma(r, zeta) = std::move(*derivatives_gamma(zeta));
+
+                    delete derivatives_fi[zeta];
+                    derivatives_fi[zeta] = nullptr;
+                    delete derivatives_gamma[zeta];
+                    derivatives_gamma[zeta] = nullptr;
+                }
+            }
         }
+
+        equations.kronecker_product_sum_is_assembled = GL_FALSE;
+        equations.A.Clear();
+
+        equations.weight.assign(weight.GetRowPointer(0), weight.GetRowPointer(0) + rho);
+        equations.energy_terms_are_valid = GL_TRUE;
     }
 
-    TriangularMatrix<RealMatrix> fi(rho + 1);
-    TriangularMatrix<RealMatrix> gamma(rho + 1);
+    const CollocationMatrix                 &F = equations.F, &G = equations.G;
+    const RealMatrix                        &FT_F = equations.FT_F, &GT_G = equations.GT_G;
+    const TriangularMatrix<BandedSPDMatrix> &fi = equations.fi, &gamma = equations.gamma;
+    BandedSPDMatrix                         &banded_FT_F = equations.banded_FT_F, &banded_GT_G = equations.banded_GT_G;
+
+    // Y = F' * D * G
+    Matrix<DCoordinate3> Y = F.TransposeTimes(D * G);
 
-    for (GLuint r = 1; r <= rho; r++)
+    // Without energy terms the normal equations (F'F (x) G'G) vec(P) = vec(Y) are separable:
+    // (F'F) Z = Y and P (G'G) = Z.
+    if (!equations.has_energy_terms && !iterative_solver && equations.banded_factors_exist)
     {
-        if (weight[r - 1] != 0.0)
+        Matrix<DCoordinate3> Z, P;
+        if (banded_FT_F.SolveLinearSystem(Y, Z) && banded_GT_G.SolveLinearSystem(Z, P, GL_FALSE))
         {
-            RowMatrix<RealMatrix*> derivatives_fi = result->GetKnotVectorU()->LookUpTablesForSurfaceOptimizatioin(weight[r - 1], r, div_point_count);
-            RowMatrix<RealMatrix*> derivatives_gamma = result->GetKnotVectorV()->LookUpTablesForSurfaceOptimizatioin(weight[r - 1], r, div_point_count);
-            for (GLuint zeta = 0; zeta <= r; zeta ++)
+            thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * (u_n + 1) * (v_n + 1), (u_n + 1) * (v_n + 1));
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+            for (GLint i_j = 0; i_j < static_cast<GLint>((u_n + 1) * (v_n + 1)); i_j++)
             {
-                fi(r, zeta) = (*derivatives_fi(zeta));
-                gamma(r, zeta) = (*derivatives_gamma(zeta));
+                GLint i = i_j / (v_n + 1);
+                GLint j = i_j % (v_n + 1);
 
-                delete derivatives_fi[zeta];
-                derivatives_fi[zeta] = nullptr;
-                delete derivatives_gamma[zeta];
-                derivatives_gamma[zeta] = nullptr;
+                (*result)(i, j) = P(i, j);
             }
+
+            return result;
         }
     }
 
-    RealSquareMatrix A(size);
-    for (GLuint s = 0; s <= u_n; s++)
+    if (iterative_solver)
     {
-        for (GLuint t = 0; t <= v_n; t++)
+        GLuint u_size = u_n + 1;
+        GLuint v_size = v_n + 1;
+
+        // P -> F'(F P G')G + sum_{r} sum_{zeta} fi(r, r - zeta) P gamma(r, zeta)
+        auto apply_operator = [&](const Matrix<DCoordinate3>& P) -> Matrix<DCoordinate3>
         {
-            for (GLuint k = 0; k <= u_n; k++)
+            Matrix<DCoordinate3> Q = F.TransposeTimes(MultiplyByTranspose(F * P, G) * G);
+
+            CAGD_OPENMP_ONLY GLint addition_thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * u_size * v_size, u_size);
+
+            for (GLuint r = 1; r <= rho; r++)
             {
-                for (GLuint l = 0; l <= v_n; l++)
+                if (weight[r - 1] != 0.0)
                 {
-                    GLdouble aux = 0.0;
-                    for (GLuint i = 0; i < u_cloud_size; i++)
+                    for (GLuint zeta = 0; zeta <= r; zeta++)
                     {
-                        for (GLuint j = 0; j < v_cloud_size; j++)
+                        Matrix<DCoordinate3> E = fi(r, r - zeta) * P * gamma(r, zeta);
+
+#pragma omp parallel for if (addition_thread_count > 1) num_threads(addition_thread_count)
+                        for (GLint i = 0; i < static_cast<GLint>(u_size); i++)
                         {
-                            aux += F(i, s) * F(i, k) * G(j, t) * G(j, l);
+                            DCoordinate3       *q = Q.GetRowPointer(i);
+                            const DCoordinate3 *e = E.GetRowPointer(i);
+
+                            for (GLuint j = 0; j < v_size; j++)
+                            {
+                                q[j] += e[j];
+                            }
                         }
                     }
+                }
+            }
+
+            return Q;
+        };
+
+        // Z = inv(F'F) R inv(G'G) by means of the banded Cholesky factors,
+        // if one of the directional matrices is singular, the iterations are not preconditioned
+        GLboolean preconditioned = equations.banded_factors_exist;
+
+        auto apply_preconditioner = [&](const Matrix<DCoordinate3>& R, Matrix<DCoordinate3>& Z)
+        {
+            Matrix<DCoordinate3> T;
+            if (!preconditioned ||
+                !banded_FT_F.SolveLinearSystem(R, T) || !banded_GT_G.SolveLinearSystem(T, Z, GL_FALSE))
+            {
+                Z = R;
+            }
+        };
+
+        GLuint maximum_iteration_count = iterative_solver->maximum_iteration_count;
+        if (!maximum_iteration_count)
+        {
+            maximum_iteration_count = u_size * v_size;
+        }
+
+        // initial control net
+        Matrix<DCoordinate3> P(u_size, v_size), R(Y);
+
+        const Matrix<DCoordinate3> *initial_control_net = iterative_solver->initial_control_net;
+        if (initial_control_net &&
+            initial_control_net->GetRowCount() == u_size && initial_control_net->GetColumnCount() == v_size)
+        {
+            P = *initial_control_net;
+            CoordinatewiseAddScaled(R, DCoordinate3(-1.0, -1.0, -1.0), apply_operator(P));
+        }
+
+        DCoordinate3 Y_Y = CoordinatewiseInnerProduct(Y, Y);
+        GLdouble     Y_norm = sqrt(Y_Y.x() + Y_Y.y() + Y_Y.z());
+        if (Y_norm == 0.0)
+        {
+            Y_norm = 1.0;
+        }
+
+        DCoordinate3 R_R = CoordinatewiseInnerProduct(R, R);
+        GLdouble     relative_residual = sqrt(R_R.x() + R_R.y() + R_R.z()) / Y_norm;
+
+        GLuint    iteration_count = 0;
+        GLboolean converged = (relative_residual <= iterative_solver->tolerance);
 
-                    GLdouble aux2 = 0.0;
-                    for (GLuint r = 1; r <= rho; r++)
+        if (report)
+        {
+            report->residual_history.clear();
+            report->residual_history.push_back(relative_residual);
+        }
+
+        // preconditioned conjugate gradient method, the three coordinates are solved simultaneously,
+        // but with their own step sizes
+        Matrix<DCoordinate3> Z, D;
+        apply_preconditioner(R, Z);
+        D = Z;
+
+        DCoordinate3 R_Z = CoordinatewiseInnerProduct(R, Z);
+
+        while (!converged && iteration_count < maximum_iteration_count)
+        {
+            Matrix<DCoordinate3> Q = apply_operator(D);
+
+            DCoordinate3 D_Q = CoordinatewiseInnerProduct(D, Q);
+            DCoordinate3 alpha, minus_alpha;
+            for (GLuint c = 0; c < 3; c++)
+            {
+                alpha[c] = (D_Q[c] != 0.0) ? R_Z[c] / D_Q[c] : 0.0;
+                minus_alpha[c] = -alpha[c];
+            }
+
+            CoordinatewiseAddScaled(P, alpha, D);
+            CoordinatewiseAddScaled(R, minus_alpha, Q);
+
+            iteration_count++;
+
+            R_R = CoordinatewiseInnerProduct(R, R);
+            relative_residual = sqrt(R_R.x() + R_R.y() + R_R.z()) / Y_norm;
+            converged = (relative_residual <= iterative_solver->tolerance);
+
+            if (report)
+            {
+                report->residual_history.push_back(relative_residual);
+            }
+
+            if (converged)
+            {
+                break;
+            }
+
+            apply_preconditioner(R, Z);
+
+            DCoordinate3 R_Z_new = CoordinatewiseInnerProduct(R, Z);
+            DCoordinate3 beta;
+            for (GLuint c = 0; c < 3; c++)
+            {
+                beta[c] = (R_Z[c] != 0.0) ? R_Z_new[c] / R_Z[c] : 0.0;
+            }
+            R_Z = R_Z_new;
+
+            // D = Z + beta * D
+            CoordinatewiseAddScaled(Z, beta, D);
+            // the old search direction is recycled as the storage of the next preconditioned residual
+            swap(D, Z);
+        }
+
+        if (report)
+        {
+            report->iteration_count = iteration_count;
+            report->converged = converged;
+        }
+
+        thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * u_size * v_size, u_size * v_size);
+
+        // Set polygon
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i_j = 0; i_j < static_cast<GLint>(u_size * v_size); i_j++)
+        {
+            GLint i = i_j / v_size;
+            GLint j = i_j % v_size;
+
+            (*result)(i, j) = P(i, j);
+        }
+
+        return result;
+    }
+
+    // The normal equations are solved in the matrix form F'F * P * G'G + sum_{r} sum_{zeta} fi(r, r - zeta) * P * gamma(r, zeta) = Y,
+    // i.e., without assembling the (u_n + 1)(v_n + 1) x (u_n + 1)(v_n + 1) coefficient matrix.
+    // The terms and the simultaneous diagonalization of the two-term (pre)conditioner are kept for the next fits.
+    KroneckerProductSum &K = equations.K;
+
+    if (!equations.kronecker_product_sum_is_assembled)
+    {
+        K = KroneckerProductSum(u_n + 1, v_n + 1);
+        K.AddTerm(FT_F, GT_G);
+
+        for (GLuint r = 1; r <= rho; r++)
+        {
+            if (weight[r - 1] != 0.0)
+            {
+                for (GLuint zeta = 0; zeta <= r; zeta++)
+                {
+                    K.AddTerm(fi(r, r - zeta).ToRealMatrix(), gamma(r, zeta).ToRealMatrix());
+                }
+            }
+        }
+
+        equations.kronecker_product_sum_is_assembled = GL_TRUE;
+    }
+
+    KroneckerSolverSettings default_kronecker_solver;
+    if (!kronecker_solver)
+    {
+        kronecker_solver = &default_kronecker_solver;
+    }
+
+    Matrix<DCoordinate3> P_K;
+    if (K.SolveLinearSystem(Y, P_K, kronecker_solver->tolerance, kronecker_solver->maximum_iteration_count))
+    {
+        thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * (u_n + 1) * (v_n + 1), (u_n + 1) * (v_n + 1));
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint i_j = 0; i_j < static_cast<GLint>((u_n + 1) * (v_n + 1)); i_j++)
+        {
+            GLint i = i_j / (v_n + 1);
+            GLint j = i_j % (v_n + 1);
+
+            (*result)(i, j) = P_K(i, j);
+        }
+
+        return result;
+    }
+
+    // fallback, if the conjugate gradient iterations of the Kronecker product solver do not converge:
+    // dense assembly and LU decomposition
+    GLuint size = (u_n + 1) * (v_n + 1);
+    ColumnMatrix<DCoordinate3> b(size);
+    for (GLuint i = 0; i < u_n + 1; i++)
+    {
+        for (GLuint j = 0;  j < v_n + 1; j++)
+        {
+            b[i * (v_n + 1) + j] = Y(i, j);
+        }
+    }
+
+    // the LU factors of the coefficient matrix are determined only once
+    if (!equations.A.IsDone())
+    {
+        // Since sum_i sum_j F(i, s) F(i, k) G(j, t) G(j, l) = F'F(s, k) * G'G(t, l), the coefficient matrix is the sum of Kronecker products
+        //
+        //      A = F'F (x) G'G + sum_{r} sum_{zeta} fi(r, r - zeta) (x) gamma(r, zeta),
+        //
+        // i.e., its (s, k)-th block of size (v_n + 1) x (v_n + 1) is a linear combination of the v-directional tables,
+        // the coefficients of which are the (s, k)-th entries of the u-directional tables.
+        RealMatrix A(size, size);
+
+        GLuint u_size = u_n + 1;
+        GLuint v_size = v_n + 1;
+
+        // dense copies of the tables, the rows of the v-directional ones are combined below, while the entries of
+        // the u-directional ones are also read outside their bands
+        TriangularMatrix<RealMatrix> dense_fi(rho + 1), dense_gamma(rho + 1);
+
+        for (GLuint r = 1; r <= rho; r++)
+        {
+            if (weight[r - 1] != 0.0)
+            {
+                for (GLuint zeta = 0; zeta <= r; zeta++)
+                {
+                    dense_fi(r, zeta) = fi(r, zeta).ToRealMatrix();
+                    dense_gamma(r, zeta) = gamma(r, zeta).ToRealMatrix();
+                }
+            }
+        }
+
+        thread_count = ParallelExecutionPolicy::ThreadCount(static_cast<GLdouble>(size) * size, u_size * u_size);
+
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
+        for (GLint s_k = 0; s_k < static_cast<GLint>(u_size * u_size); s_k++)
+        {
+            GLuint s = s_k / u_size;
+            GLuint k = s_k % u_size;
+
+            GLdouble FT_F_sk = FT_F(s, k);
+
+            for (GLuint t = 0; t < v_size; t++)
+            {
+                GLdouble       *a    = A.GetRowPointer(s * v_size + t) + k * v_size;
+                const GLdouble *gt_g = GT_G.GetRowPointer(t);
+
+                for (GLuint l = 0; l < v_size; l++)
+                {
+                    a[l] = FT_F_sk * gt_g[l];
+                }
+
+                for (GLuint r = 1; r <= rho; r++)
+                {
+                    if (weight[r - 1] != 0.0)
                     {
-                        if (weight[r - 1] != 0.0)
+                        for (GLuint zeta = 0; zeta <= r; zeta++)
                         {
-                            for (GLuint zeta = 0; zeta <= r; zeta++)
+                            GLdouble        fi_sk = dense_fi(r, r - zeta)(s, k);
+                            const GLdouble *gamma_t = dense_gamma(r, zeta).GetRowPointer(t);
+
+                            for (GLuint l = 0; l < v_size; l++)
                             {
-                                aux2 += fi(r, r - zeta)(s, k) * gamma(r, zeta) (t, l);
+                                a[l] += fi_sk * gamma_t[l];
                             }
                         }
                     }
-
-                    A(s * (v_n + 1) + t, k * (v_n + 1) + l) = aux + aux2;
                 }
             }
         }
+
+        equations.A.Factorize(std::move(A));
     }
 
     ColumnMatrix<DCoordinate3> P(size);
 
-    A.SolveLinearSystem(b, P);
+    equations.A.SolveLinearSystem(b, P);
+
+    thread_count = ParallelExecutionPolicy::ThreadCount(3.0 * size, size);
 
     // Set polygon
-#pragma omp parallel for
+#pragma omp parallel for if (thread_count > 1) num_threads(thread_count)
     for (GLint i_j = 0; i_j < static_cast<GLint>(size); i_j++)
     {
         GLint i = i_j / (v_n + 1);
@@ -311,6 +687,45 @@ BSplinePatch3* PointCloudAroundSurface3::GenerateRegressionSurface(const RowMatr
     return result;
 }
 
+PointCloudAroundSurface3::NormalEquations::NormalEquations():
+    is_valid(GL_FALSE),
+    u_type(KnotVector::CLAMPED), v_type(KnotVector::CLAMPED),
+    u_k(0), v_k(0), u_n(0), v_n(0),
+    u_min(0.0), u_max(0.0), v_min(0.0), v_max(0.0),
+    div_point_count(0),
+    banded_factors_exist(GL_FALSE),
+    energy_terms_are_valid(GL_FALSE),
+    has_energy_terms(GL_FALSE),
+    kronecker_product_sum_is_assembled(GL_FALSE)
+{
+}
+
+GLboolean PointCloudAroundSurface3::NormalEquations::Matches(
+        KnotVector::Type u_type, KnotVector::Type v_type,
+        GLuint u_k, GLuint v_k, GLuint u_n, GLuint v_n,
+        GLdouble u_min, GLdouble u_max, GLdouble v_min, GLdouble v_max,
+        GLuint div_point_count,
+        const RowMatrix<GLdouble> &u_parameter_values,
+        const RowMatrix<GLdouble> &v_parameter_values) const
+{
+    return is_valid &&
+           this->u_type == u_type && this->v_type == v_type &&
+           this->u_k == u_k && this->v_k == v_k && this->u_n == u_n && this->v_n == v_n &&
+           this->u_min == u_min && this->u_max == u_max && this->v_min == v_min && this->v_max == v_max &&
+           this->div_point_count == div_point_count &&
+           this->u_parameter_values.size() == u_parameter_values.GetColumnCount() &&
+           equal(this->u_parameter_values.begin(), this->u_parameter_values.end(), u_parameter_values.GetRowPointer(0)) &&
+           this->v_parameter_values.size() == v_parameter_values.GetColumnCount() &&
+           equal(this->v_parameter_values.begin(), this->v_parameter_values.end(), v_parameter_values.GetRowPointer(0));
+}
+
+GLboolean PointCloudAroundSurface3::NormalEquations::MatchesWeights(const RowMatrix<GLdouble> &weight) const
+{
+    return is_valid && energy_terms_are_valid &&
+           this->weight.size() == weight.GetColumnCount() &&
+           equal(this->weight.begin(), this->weight.end(), weight.GetRowPointer(0));
+}
+
 void PointCloudAroundSurface3::FindTheInterval(GLdouble &u_min, GLdouble &u_max, GLdouble &v_min, GLdouble &v_max)
 {
     u_min = _cloud(0, 0).parameter_value_u;
@@ -7,6 +7,12 @@
 #include "Core/Exceptions.h"
 #include "B-spline/BSplinePatches3.h"
 #include "Core/RealMatrices.h"
+#include "Core/BandedSPDMatrices.h"
+#include "Core/CollocationMatrices.h"
+#include "Core/KroneckerProductSums.h"
+#include "Core/LUFactorizations.h"
+#include <mutex>
+#include <vector>
 
 namespace cagd
 {
@@ -26,8 +32,100 @@ namespace cagd
             GLdouble parameter_value_v; // v
             DCoordinate3 position;      // x
         };
+
+        // controls of the matrix-free preconditioned conjugate gradient mode of GenerateRegressionSurface
+        class IterativeSolverSettings
+        {
+        public:
+            GLdouble                    tolerance;                  // bound of the relative residual ||Y - A(P)|| / ||Y||
+            GLuint                      maximum_iteration_count;    // 0 means (u_n + 1) * (v_n + 1)
+            const Matrix<DCoordinate3>  *initial_control_net;       // warm start, nullptr means the zero net
+
+            IterativeSolverSettings(GLdouble tolerance = 1.0e-8, GLuint maximum_iteration_count = 0,
+                                    const Matrix<DCoordinate3> *initial_control_net = nullptr);
+        };
+
+        // controls of the conjugate gradient iterations of the Kronecker product solver of the direct mode of
+        // GenerateRegressionSurface, which iterates if there are more than two terms or if F'F or G'G is not
+        // positive definite (see KroneckerProductSum); the relative error of the control net is bounded by the
+        // condition number of the normal equations times the tolerance
+        class KroneckerSolverSettings
+        {
+        public:
+            GLdouble                    tolerance;                  // bound of the relative residual ||Y - A(P)|| / ||Y||
+            GLuint                      maximum_iteration_count;    // 0 means (u_n + 1) * (v_n + 1)
+
+            KroneckerSolverSettings(GLdouble tolerance = 1.0e-13, GLuint maximum_iteration_count = 0);
+        };
+
+        class IterativeSolverReport
+        {
+        public:
+            GLuint                  iteration_count;
+            GLboolean               converged;
+            std::vector<GLdouble>   residual_history;   // relative residuals, the first one belongs to the initial net
+        };
     private:
-        Matrix<SamplePoint> _cloud;
+        // The normal equations of the latest regression and their (lazily determined) factorizations.
+        // The collocation matrices, the directional Gram matrices and the banded Cholesky factors of the
+        // latter depend only on the knot vectors, on the division of the integrals and on the parameter
+        // values of the samples, therefore these objects are reused as long as the latter do not change
+        // (e.g., if only the positions of the sample points are updated between consecutive frames).
+        // The weighted energy terms, the sum of Kronecker products and the dense factors are determined
+        // again if also the weights change (e.g., while a weight slider is moved). If nothing changes, a
+        // new fit requires only the evaluation of the right-hand side F' * D * G and the substitutions.
+        class NormalEquations
+        {
+        public:
+            GLboolean                       is_valid;
+
+            // fitting settings and parameter values that determine the collocation and Gram matrices
+            KnotVector::Type                u_type, v_type;
+            GLuint                          u_k, v_k;
+            GLuint                          u_n, v_n;
+            GLdouble                        u_min, u_max;
+            GLdouble                        v_min, v_max;
+            GLuint                          div_point_count;
+            std::vector<GLdouble>           u_parameter_values, v_parameter_values;
+
+            CollocationMatrix               F, G;
+            RealMatrix                      FT_F, GT_G;
+
+            // banded Cholesky factors of the directional Gram matrices
+            GLboolean                       banded_factors_exist;
+            BandedSPDMatrix                 banded_FT_F, banded_GT_G;
+
+            // weights of the energy terms and the objects that depend on them
+            GLboolean                       energy_terms_are_valid;
+            std::vector<GLdouble>           weight;
+            GLboolean                       has_energy_terms;
+            TriangularMatrix<BandedSPDMatrix> fi, gamma;      // banded energy look-up tables
+
+            // sum of Kronecker products (assembled on demand)
+            GLboolean                       kronecker_product_sum_is_assembled;
+            KroneckerProductSum             K;
+
+            // factors of the dense coefficient matrix (determined on demand)
+            LUFactorization                 A;
+
+            NormalEquations();
+
+            // whether the collocation and Gram matrices belong to the given settings and parameter values
+            GLboolean Matches(KnotVector::Type u_type, KnotVector::Type v_type,
+                              GLuint u_k, GLuint v_k, GLuint u_n, GLuint v_n,
+                              GLdouble u_min, GLdouble u_max, GLdouble v_min, GLdouble v_max,
+                              GLuint div_point_count,
+                              const RowMatrix<GLdouble> &u_parameter_values,
+                              const RowMatrix<GLdouble> &v_parameter_values) const;
+
+            // whether also the energy terms belong to the given weights
+            GLboolean MatchesWeights(const RowMatrix<GLdouble> &weight) const;
+        };
+
+        Matrix<SamplePoint>         _cloud;
+
+        mutable NormalEquations     _normal_equations;
+        mutable std::mutex          _normal_equations_mutex;
     public:
         PointCloudAroundSurface3();
 
@@ -50,13 +148,23 @@ namespace cagd
         // Render the points of cloud
         bool RenderPointCloud(TriangulatedMesh3 *sphere, double point_size, bool dark_mode = true, bool default_color = true);
 
-        // Setting BSpline surface from cloud
+        // Setting BSpline surface from cloud.
+        // By default the normal equations are solved directly. If iterative_solver is given, the
+        // coefficient matrix is never formed: the operator P -> F'(F P G')G + sum fi P gamma is applied
+        // by means of the collocation matrices and the 1D look-up tables, while the banded Cholesky
+        // factors of F'F and G'G precondition the conjugate gradient iterations.
+        // The normal equations and their factorizations are reused by consecutive calls (see NormalEquations).
+        // The dense LU decomposition of the coefficient matrix is used only if the Kronecker product solver
+        // of the direct mode does not converge within the limits of kronecker_solver (nullptr means the defaults).
         BSplinePatch3* GenerateRegressionSurface(const RowMatrix<GLdouble> &weight, KnotVector::Type u_type, KnotVector::Type v_type,
                                                  GLuint u_k, GLuint v_k,
                                                  GLuint u_n, GLuint v_n,
                                                  GLdouble u_min = 0.0, GLdouble u_max = 1.0,
                                                  GLdouble v_min = 0.0, GLdouble v_max = 1.0,
-                                                 GLuint div_point_count = 300) const;
+                                                 GLuint div_point_count = 300,
+                                                 const IterativeSolverSettings *iterative_solver = nullptr,
+                                                 IterativeSolverReport *report = nullptr,
+                                                 const KroneckerSolverSettings *kronecker_solver = nullptr) const;
 
         void FindTheInterval(GLdouble &u_min, GLdouble &u_max, GLdouble &v_min, GLdouble &v_max);
 
@@ -71,17 +71,25 @@ FORMS += \
 HEADERS += \
     B-spline/BSplineCurves3.h \
     B-spline/BSplinePatches3.h \
+    B-spline/EnergyLookUpTableCaches.h \
     B-spline/KnotVectors.h \
+    Core/BandedSPDMatrices.h \
+    Core/CollocationMatrices.h \
     Core/Colors4.h \
     Core/Constants.h \
     Core/DCoordinates3.h \
     Core/Exceptions.h \
     Core/GenericCurves3.h \
     Core/HCoordinates3.h \
+    Core/IterativeRefinements.h \
+    Core/KroneckerProductSums.h \
     Core/Lights.h \
     Core/LinearCombination3.h \
+    Core/LUFactorizations.h \
     Core/Materials.h \
     Core/Matrices.h \
+    Core/MatrixProducts.h \
+    Core/ParallelExecutionPolicies.h \
     Core/RealMatrices.h \
     Core/RealSquareMatrices.h \
     Core/ShaderPrograms.h \
@@ -100,6 +108,8 @@ HEADERS += \
     Modelling/PointCloudsAndModels.h \
     Parametric/ParametricCurves3.h \
     Parametric/ParametricSurfaces3.h \
+    PointCloud/CurveNormalEquationAccumulators.h \
+    PointCloud/IncrementalCurveRegressors.h \
     PointCloud/PointCloudAroundCurve3.h \
     PointCloud/PointCloudAroundSurface3.h \
     RandomNumberGenerator/NormalRNG.h \
@@ -109,11 +119,18 @@ HEADERS += \
 SOURCES += \
     B-spline/BSplineCurves3.cpp \
     B-spline/BSplinePatches3.cpp \
+    B-spline/EnergyLookUpTableCaches.cpp \
     B-spline/KnotVectors.cpp \
+    Core/BandedSPDMatrices.cpp \
+    Core/CollocationMatrices.cpp \
     Core/GenericCurves3.cpp \
+    Core/KroneckerProductSums.cpp \
     Core/Lights.cpp \
     Core/LinearCombination3.cpp \
+    Core/LUFactorizations.cpp \
     Core/Materials.cpp \
+    Core/MatrixProducts.cpp \
+    Core/ParallelExecutionPolicies.cpp \
     Core/RealMatrices.cpp \
     Core/RealSquareMatrices.cpp \
     Core/ShaderPrograms.cpp \
@@ -130,6 +147,8 @@ SOURCES += \
     Modelling/PointCloudsAndModels.cpp \
     Parametric/ParametricCurves3.cpp \
     Parametric/ParametricSurfaces3.cpp \
+    PointCloud/CurveNormalEquationAccumulators.cpp \
+    PointCloud/IncrementalCurveRegressors.cpp \
     PointCloud/PointCloudAroundCurve3.cpp \
     PointCloud/PointCloudAroundSurface3.cpp \
     RandomNumberGenerator/NormalRNG.cpp \
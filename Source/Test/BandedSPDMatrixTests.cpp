@@ -0,0 +1,407 @@
+#include "../Core/BandedSPDMatrices.h"
+#include "../Core/DCoordinates3.h"
+#include "../Core/RealSquareMatrices.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace cagd;
+
+// regression tests of BandedSPDMatrix, the solutions of the banded Cholesky decomposition (and of its rank-one
+// updates and downdates) are compared with the solutions of the pivoted LU decomposition of the equivalent dense
+// matrices, both for ordinary and cyclic bands
+
+static GLuint failure_count = 0;
+
+static GLvoid Check(GLboolean condition, const char *description, GLuint size, GLuint half_bandwidth)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << description << " (n = " << size << ", b = " << half_bandwidth << ")" << endl;
+        failure_count++;
+    }
+}
+
+static mt19937 generator(20241017);
+
+static GLdouble Random(GLdouble a, GLdouble b)
+{
+    uniform_real_distribution<GLdouble> distribution(a, b);
+    return distribution(generator);
+}
+
+// a random symmetric and strictly diagonally dominant, i.e., positive definite matrix, the entries of which
+// vanish if the (cyclic) distance of i and j is greater than b
+static RealSquareMatrix RandomSPDBandMatrix(GLuint size, GLuint half_bandwidth, GLboolean cyclic)
+{
+    RealSquareMatrix A(size);
+
+    for (GLuint i = 0; i < size; i++)
+    {
+        for (GLuint j = 0; j < i; j++)
+        {
+            GLuint distance = cyclic ? min(i - j, size - i + j) : i - j;
+
+            if (distance <= half_bandwidth)
+            {
+                A(i, j) = A(j, i) = Random(-1.0, 1.0);
+            }
+        }
+    }
+
+    for (GLuint i = 0; i < size; i++)
+    {
+        GLdouble sum = 0.0;
+        for (GLuint j = 0; j < size; j++)
+        {
+            if (j != i)
+            {
+                sum += fabs(A(i, j));
+            }
+        }
+        A(i, i) = sum + Random(0.1, 1.0);
+    }
+
+    return A;
+}
+
+static GLdouble Distance(const GLdouble &a, const GLdouble &b)
+{
+    return fabs(a - b);
+}
+
+static GLdouble Distance(const DCoordinate3 &a, const DCoordinate3 &b)
+{
+    return max(fabs(a[0] - b[0]), max(fabs(a[1] - b[1]), fabs(a[2] - b[2])));
+}
+
+// the largest difference of the components of x and y relative to the largest component of y
+template <class T>
+static GLdouble RelativeDifference(const ColumnMatrix<T> &x, const ColumnMatrix<T> &y)
+{
+    T zero = T();
+
+    GLdouble difference = 0.0, norm = 0.0;
+    for (GLuint i = 0; i < y.GetRowCount(); i++)
+    {
+        difference = max(difference, Distance(x[i], y[i]));
+        norm       = max(norm, Distance(y[i], zero));
+    }
+
+    return difference / norm;
+}
+
+static GLvoid RandomVector(ColumnMatrix<GLdouble> &b)
+{
+    for (GLuint i = 0; i < b.GetRowCount(); i++)
+    {
+        b[i] = Random(-1.0, 1.0);
+    }
+}
+
+static GLvoid RandomVector(ColumnMatrix<DCoordinate3> &b)
+{
+    for (GLuint i = 0; i < b.GetRowCount(); i++)
+    {
+        b[i] = DCoordinate3(Random(-1.0, 1.0), Random(-1.0, 1.0), Random(-1.0, 1.0));
+    }
+}
+
+// solves A * x = b by means of the banded Cholesky decomposition and compares the result with the solution
+// of the pivoted LU decomposition of the dense matrix
+template <class T>
+static GLvoid CheckSolution(BandedSPDMatrix &A, const RealSquareMatrix &dense_A)
+{
+    GLuint size = A.GetSize(), half_bandwidth = A.GetHalfBandwidth();
+
+    ColumnMatrix<T> b(size), x, reference;
+    RandomVector(b);
+
+    RealSquareMatrix LU(dense_A);
+
+    Check(A.SolveLinearSystem(b, x), "the banded system is not solved", size, half_bandwidth);
+    Check(LU.SolveLinearSystem(b, reference), "the dense system is not solved", size, half_bandwidth);
+    Check(x.GetRowCount() == size, "the solution has a wrong size", size, half_bandwidth);
+
+    if (x.GetRowCount() == size && reference.GetRowCount() == size)
+    {
+        Check(RelativeDifference(x, reference) < 1.0e-10, "the banded and dense solutions differ", size, half_bandwidth);
+    }
+
+    // the same right-hand side represented as a row
+    RowMatrix<T> b_row(size), x_row;
+    for (GLuint i = 0; i < size; i++)
+    {
+        b_row[i] = b[i];
+    }
+
+    Check(A.SolveLinearSystem(b_row, x_row, GL_FALSE), "the banded system of the row is not solved", size, half_bandwidth);
+    Check(x_row.GetColumnCount() == size, "the row solution has a wrong size", size, half_bandwidth);
+
+    if (x_row.GetColumnCount() == size && reference.GetRowCount() == size)
+    {
+        ColumnMatrix<T> x_column(size);
+        for (GLuint i = 0; i < size; i++)
+        {
+            x_column[i] = x_row[i];
+        }
+
+        Check(RelativeDifference(x_column, reference) < 1.0e-10, "the banded row and dense solutions differ", size, half_bandwidth);
+    }
+}
+
+static GLvoid CheckBandMatrix(GLuint size, GLuint half_bandwidth, GLboolean cyclic)
+{
+    RealSquareMatrix dense_A = RandomSPDBandMatrix(size, half_bandwidth, cyclic);
+
+    // copy of the (cyclic) band of the dense matrix
+    BandedSPDMatrix A(dense_A, half_bandwidth, cyclic);
+
+    // entry-wise assembly of the same matrix
+    BandedSPDMatrix B(size, half_bandwidth, cyclic);
+
+    for (GLuint i = 0; i < size; i++)
+    {
+        for (GLuint j = 0; j < size; j++)
+        {
+            if (B.IsInBand(i, j))
+            {
+                B(i, j) = dense_A(i, j);
+            }
+        }
+    }
+
+    GLboolean entries_agree = GL_TRUE;
+    for (GLuint i = 0; i < size; i++)
+    {
+        for (GLuint j = 0; j < size; j++)
+        {
+            const BandedSPDMatrix &const_A = A, &const_B = B;
+            entries_agree = entries_agree && const_A(i, j) == dense_A(i, j) && const_B(i, j) == dense_A(i, j);
+        }
+    }
+
+    Check(entries_agree, "the band does not represent the dense matrix", size, half_bandwidth);
+
+    CheckSolution<GLdouble>(A, dense_A);
+    CheckSolution<DCoordinate3>(B, dense_A);
+
+    // the factors are reused by consecutive solutions
+    CheckSolution<DCoordinate3>(A, dense_A);
+}
+
+// matrices that are not positive definite have to be rejected, such that the caller can fall back to the
+// LU decomposition, which is also checked by means of PerformCholeskyOrLUDecomposition
+static GLvoid CheckFallback(GLuint size, GLuint half_bandwidth, GLboolean cyclic)
+{
+    ColumnMatrix<DCoordinate3> b(size), x, reference;
+    RandomVector(b);
+
+    LUFactorization fallback;
+
+    // the positive definite matrices are decomposed by the banded Cholesky decomposition
+    RealSquareMatrix dense_P = RandomSPDBandMatrix(size, half_bandwidth, cyclic);
+    BandedSPDMatrix  P(dense_P, half_bandwidth, cyclic);
+
+    RealSquareMatrix LU_P(dense_P);
+    Check(LU_P.SolveLinearSystem(b, reference), "the dense system is not solved", size, half_bandwidth);
+
+    Check(PerformCholeskyOrLUDecomposition(P, fallback) && !fallback.IsDone(),
+          "the positive definite matrix is not decomposed by the Cholesky decomposition", size, half_bandwidth);
+    Check(SolveLinearSystemByCholeskyOrLUFactors(P, fallback, b, x) && RelativeDifference(x, reference) < 1.0e-10,
+          "the Cholesky factors do not solve the system", size, half_bandwidth);
+
+    // a pivot of the interior and one of the last row, which belongs to the border in the cyclic case
+    GLuint rows[2] = {size / 3, size - 1};
+
+    for (GLuint r = 0; r < 2; r++)
+    {
+        GLuint i = rows[r];
+
+        // symmetric and regular, but indefinite
+        RealSquareMatrix dense_A = RandomSPDBandMatrix(size, half_bandwidth, cyclic);
+        dense_A(i, i) = -dense_A(i, i);
+
+        BandedSPDMatrix A(dense_A, half_bandwidth, cyclic);
+
+        Check(!A.PerformCholeskyDecomposition(), "the indefinite matrix is decomposed", size, half_bandwidth);
+        Check(!A.SolveLinearSystem(b, x), "the indefinite system is solved", size, half_bandwidth);
+
+        RealSquareMatrix LU(dense_A);
+        Check(LU.SolveLinearSystem(b, reference), "the fallback does not solve the indefinite system", size, half_bandwidth);
+
+        BandedSPDMatrix C(dense_A, half_bandwidth, cyclic);
+
+        Check(PerformCholeskyOrLUDecomposition(C, fallback) && fallback.IsDone(),
+              "the indefinite matrix is not decomposed by the LU decomposition", size, half_bandwidth);
+        Check(SolveLinearSystemByCholeskyOrLUFactors(C, fallback, b, x) && RelativeDifference(x, reference) < 1.0e-10,
+              "the LU factors do not solve the indefinite system", size, half_bandwidth);
+
+        // singular, e.g., the normal matrix of a curve the control point i of which does not influence any sample
+        RealSquareMatrix dense_S = RandomSPDBandMatrix(size, half_bandwidth, cyclic);
+        for (GLuint j = 0; j < size; j++)
+        {
+            dense_S(i, j) = dense_S(j, i) = 0.0;
+        }
+
+        BandedSPDMatrix S(dense_S, half_bandwidth, cyclic);
+
+        Check(!S.PerformCholeskyDecomposition(), "the singular matrix is decomposed", size, half_bandwidth);
+        Check(!S.SolveLinearSystem(b, x), "the singular system is solved", size, half_bandwidth);
+
+        BandedSPDMatrix T(dense_S, half_bandwidth, cyclic);
+
+        Check(!PerformCholeskyOrLUDecomposition(T, fallback), "the singular matrix is decomposed by the LU decomposition",
+              size, half_bandwidth);
+    }
+}
+
+// the rank-one updates and downdates of the Cholesky factor are compared with the solutions of the dense matrices
+// A + x * x' and A - x * x', where the non-zero components of x belong to at most b + 1 consecutive rows
+static GLvoid CheckRankOneModifications(GLuint size, GLuint half_bandwidth)
+{
+    ColumnMatrix<DCoordinate3> b(size), x, reference;
+    RandomVector(b);
+
+    RealSquareMatrix dense_A = RandomSPDBandMatrix(size, half_bandwidth, GL_FALSE);
+    RealSquareMatrix dense_B(dense_A);
+
+    BandedSPDMatrix A(dense_A, half_bandwidth, GL_FALSE);
+
+    Check(A.PerformCholeskyDecomposition(), "the matrix is not decomposed", size, half_bandwidth);
+
+    // a random sequence of updates and downdates at the first, last and interior rows, where the downdates
+    // remove earlier updates, such that the modified matrices remain positive definite
+    vector< vector<GLdouble> > terms;
+    vector<GLuint>             firsts;
+
+    for (GLuint step = 0; step < 24; step++)
+    {
+        GLboolean downdate = (step % 3 == 2);
+
+        GLuint           first;
+        vector<GLdouble> term;
+
+        if (downdate)
+        {
+            GLuint t = static_cast<GLuint>(Random(0.0, terms.size() - 0.5));
+
+            first = firsts[t];
+            term  = terms[t];
+
+            firsts.erase(firsts.begin() + t);
+            terms.erase(terms.begin() + t);
+        }
+        else
+        {
+            GLuint count = 1 + static_cast<GLuint>(Random(0.0, half_bandwidth + 0.99));
+            count        = min(count, size);
+
+            GLuint candidates[3] = {0, size - count, static_cast<GLuint>(Random(0.0, size - count + 0.99))};
+
+            first = candidates[step % 3];
+            term.resize(count);
+
+            for (GLuint j = 0; j < count; j++)
+            {
+                term[j] = Random(-1.0, 1.0);
+            }
+
+            firsts.push_back(first);
+            terms.push_back(term);
+        }
+
+        GLdouble sign = downdate ? -1.0 : 1.0;
+
+        for (GLuint i = 0; i < term.size(); i++)
+        {
+            for (GLuint j = 0; j < term.size(); j++)
+            {
+                dense_B(first + i, first + j) += sign * term[i] * term[j];
+            }
+        }
+
+        GLuint count = static_cast<GLuint>(term.size());
+
+        Check(downdate ? A.DowndateCholeskyDecomposition(first, count, term.data())
+                       : A.UpdateCholeskyDecomposition(first, count, term.data()),
+              "the factor is not modified", size, half_bandwidth);
+
+        RealSquareMatrix LU(dense_B);
+
+        Check(LU.SolveLinearSystem(b, reference), "the dense system is not solved", size, half_bandwidth);
+        Check(A.SolveLinearSystem(b, x) && RelativeDifference(x, reference) < 1.0e-10,
+              "the modified factor and the dense solutions differ", size, half_bandwidth);
+    }
+
+    // a downdate that leaves the positive definite matrices has to fail, such that the caller can assemble the matrix again
+    BandedSPDMatrix C(dense_A, half_bandwidth, GL_FALSE);
+
+    Check(C.PerformCholeskyDecomposition(), "the matrix is not decomposed", size, half_bandwidth);
+
+    GLuint           count = min(half_bandwidth + 1, size);
+    vector<GLdouble> large_term(count, 10.0 * (2 * half_bandwidth + 1));
+
+    Check(!C.DowndateCholeskyDecomposition(0, count, large_term.data()), "the indefinite downdate is accepted",
+          size, half_bandwidth);
+
+    // not yet decomposed matrices and the bordered factors of cyclic bands cannot be modified
+    BandedSPDMatrix undecomposed(dense_A, half_bandwidth, GL_FALSE);
+
+    Check(!undecomposed.UpdateCholeskyDecomposition(0, 1, large_term.data()), "the not decomposed matrix is modified",
+          size, half_bandwidth);
+
+    if (size >= 3 && half_bandwidth >= 1)
+    {
+        GLuint          cyclic_half_bandwidth = min(half_bandwidth, size / 2);
+        BandedSPDMatrix cyclic(RandomSPDBandMatrix(size, cyclic_half_bandwidth, GL_TRUE), cyclic_half_bandwidth, GL_TRUE);
+
+        Check(cyclic.PerformCholeskyDecomposition() && !cyclic.UpdateCholeskyDecomposition(0, 1, large_term.data()),
+              "the factor of the cyclic matrix is modified", size, cyclic_half_bandwidth);
+    }
+}
+
+int main()
+{
+    GLuint sizes[] = {2, 3, 5, 8, 13, 40, 101};
+
+    for (GLuint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        for (GLuint half_bandwidth = 0; half_bandwidth <= 6; half_bandwidth++)
+        {
+            CheckBandMatrix(sizes[s], min(half_bandwidth, sizes[s] - 1), GL_FALSE);
+            CheckRankOneModifications(sizes[s], min(half_bandwidth, sizes[s] - 1));
+
+            if (sizes[s] >= 3)
+            {
+                CheckFallback(sizes[s], min(half_bandwidth, sizes[s] - 1), GL_FALSE);
+            }
+
+            // the cyclic band of periodic regression systems, the last b unknowns form the border of the solver
+            if (half_bandwidth >= 1)
+            {
+                CheckBandMatrix(sizes[s], min(half_bandwidth, sizes[s] / 2), GL_TRUE);
+
+                if (sizes[s] >= 3)
+                {
+                    CheckFallback(sizes[s], min(half_bandwidth, sizes[s] / 2), GL_TRUE);
+                }
+            }
+        }
+    }
+
+    if (failure_count)
+    {
+        cerr << failure_count << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "all checks passed" << endl;
+
+    return EXIT_SUCCESS;
+}
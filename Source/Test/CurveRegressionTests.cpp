@@ -0,0 +1,361 @@
+#include "../PointCloud/CurveNormalEquationAccumulators.h"
+#include "../PointCloud/IncrementalCurveRegressors.h"
+#include "../PointCloud/PointCloudAroundCurve3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace cagd;
+
+// regression tests of the streaming and incremental normal equations of B-spline curves, the control polygons of the
+// curves of CurveNormalEquationAccumulator and IncrementalCurveRegressor have to reproduce those of
+// PointCloudAroundCurve3::GenerateRegressionCurve
+
+static GLuint failure_count = 0;
+
+static GLvoid Check(GLboolean condition, const char *description, KnotVector::Type type, GLuint k, GLuint sample_count)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << description << " (type = " << type << ", k = " << k
+             << ", samples = " << sample_count << ")" << endl;
+        failure_count++;
+    }
+}
+
+// noisy samples of a helix over random parameter values of [u_min, u_max]
+static GLvoid HelixSamples(GLuint sample_count, GLdouble u_min, GLdouble u_max,
+                           vector<GLdouble> &u, vector<DCoordinate3> &x)
+{
+    mt19937 generator(20241017);
+    uniform_real_distribution<GLdouble> parameter(u_min, u_max);
+    normal_distribution<GLdouble>       noise(0.0, 0.02);
+
+    u.resize(sample_count);
+    x.resize(sample_count);
+
+    for (GLuint s = 0; s < sample_count; s++)
+    {
+        u[s] = parameter(generator);
+
+        GLdouble angle = 2.0 * M_PI * (u[s] - u_min) / (u_max - u_min);
+
+        x[s] = DCoordinate3(cos(angle) + noise(generator), sin(angle) + noise(generator), u[s] + noise(generator));
+    }
+}
+
+static PointCloudAroundCurve3 Cloud(const vector<GLdouble> &u, const vector<DCoordinate3> &x)
+{
+    ostringstream os;
+    os.precision(17);
+    os << 1 << " " << u.size() << "\n";
+
+    for (GLuint s = 0; s < u.size(); s++)
+    {
+        os << u[s] << " " << x[s] << "\n";
+    }
+
+    PointCloudAroundCurve3 cloud;
+
+    istringstream is(os.str());
+    is >> cloud;
+
+    return cloud;
+}
+
+// the largest distance of the corresponding control points relative to the largest control point
+static GLdouble RelativeDistance(const BSplineCurve3 &lhs, const BSplineCurve3 &rhs, GLuint n)
+{
+    GLdouble distance = 0.0, norm = 0.0;
+
+    for (GLuint i = 0; i <= n; i++)
+    {
+        distance = max(distance, (lhs[i] - rhs[i]).length());
+        norm     = max(norm, rhs[i].length());
+    }
+
+    return distance / norm;
+}
+
+static GLdouble RelativeDistance(const ColumnMatrix<DCoordinate3> &lhs, const BSplineCurve3 &rhs, GLuint n)
+{
+    GLdouble distance = 0.0, norm = 0.0;
+
+    for (GLuint i = 0; i <= n; i++)
+    {
+        distance = max(distance, (lhs[i] - rhs[i]).length());
+        norm     = max(norm, rhs[i].length());
+    }
+
+    return distance / norm;
+}
+
+static GLvoid CheckCurve(const CurveNormalEquationAccumulator &accumulator, const BSplineCurve3 *reference,
+                         const RowMatrix<GLdouble> &weight, const char *description, GLuint sample_count)
+{
+    const KnotVector &knot_vector = accumulator.GetKnotVector();
+
+    KnotVector::Type type = knot_vector.GetType();
+    GLuint           k    = knot_vector.GetOrder(), n = knot_vector.GetN();
+
+    Check(accumulator.GetSampleCount() == sample_count, "the number of the accumulated samples differs", type, k, sample_count);
+
+    BSplineCurve3 *curve = accumulator.GenerateRegressionCurve(weight, 100);
+
+    Check(curve != nullptr, "the streamed curve is not generated", type, k, sample_count);
+
+    if (curve)
+    {
+        Check(RelativeDistance(*curve, *reference, n) < 1.0e-8, description, type, k, sample_count);
+    }
+
+    delete curve;
+}
+
+// the samples are streamed by means of chunks and single samples (some of which are removed again), by merged
+// accumulators and after clearing an accumulator, while a few parameter values that lie outside the definition
+// domain have to be skipped
+static GLvoid CheckAccumulators(KnotVector::Type type, GLuint k, GLuint n, GLuint sample_count)
+{
+    GLdouble u_min = -1.0, u_max = 2.0;
+
+    vector<GLdouble>     u;
+    vector<DCoordinate3> x;
+
+    HelixSamples(sample_count, u_min, u_max, u, x);
+
+    RowMatrix<GLdouble> weight(2);
+    weight[0] = 1.0e-4;
+    weight[1] = 1.0e-6;
+
+    PointCloudAroundCurve3 cloud     = Cloud(u, x);
+    BSplineCurve3          *reference = cloud.GenerateRegressionCurve(type, k, n, weight, u_min, u_max, 100);
+
+    Check(reference != nullptr, "the reference curve is not generated", type, k, sample_count);
+
+    if (!reference)
+    {
+        return;
+    }
+
+    GLuint chunk_size = sample_count / 2;
+
+    // chunks, interrupted by single samples and by values outside the definition domain
+    CurveNormalEquationAccumulator streamed(type, k, n, u_min, u_max);
+
+    Check(streamed.AddSamples(chunk_size, u.data(), x.data()), "the chunk is not accumulated", type, k, sample_count);
+
+    GLdouble     outside_u[3] = {u_min - 0.5, u[chunk_size], u_max + 0.25};
+    DCoordinate3 outside_x[3] = {x[0], x[chunk_size], x[0]};
+
+    Check(!streamed.AddSamples(3, outside_u, outside_x), "the chunk with values outside the definition domain is accepted",
+          type, k, sample_count);
+    Check(!streamed.AddSample(nextafter(u_max, u_max + 1.0), x[0]), "the value outside the definition domain is accepted",
+          type, k, sample_count);
+
+    for (GLuint s = chunk_size + 1; s < sample_count; s++)
+    {
+        Check(streamed.AddSample(u[s], x[s]), "the sample is not accumulated", type, k, sample_count);
+    }
+
+    // samples that are added and removed again do not influence the curve
+    for (GLuint s = 0; s < 5; s++)
+    {
+        streamed.AddSample(u_min + (u_max - u_min) * (s + 0.5) / 5.0, DCoordinate3(10.0 * s, -3.0, 7.0));
+    }
+
+    for (GLuint s = 0; s < 5; s++)
+    {
+        Check(streamed.RemoveSample(u_min + (u_max - u_min) * (s + 0.5) / 5.0, DCoordinate3(10.0 * s, -3.0, 7.0)),
+              "the sample is not removed", type, k, sample_count);
+    }
+
+    Check(streamed.GetSkippedSampleCount() == 3, "the number of the skipped samples differs", type, k, sample_count);
+
+    CheckCurve(streamed, reference, weight, "the streamed and reference curves differ", sample_count);
+
+    // three partial accumulators merged into the first one
+    CurveNormalEquationAccumulator merged(type, k, n, u_min, u_max), second(type, k, n, u_min, u_max),
+                                   third(type, k, n, u_min, u_max);
+
+    GLuint third_size = sample_count / 3;
+
+    merged.AddSamples(third_size, u.data(), x.data());
+    second.AddSamples(third_size, u.data() + third_size, x.data() + third_size);
+    third.AddSamples(sample_count - 2 * third_size, u.data() + 2 * third_size, x.data() + 2 * third_size);
+
+    merged += second;
+    merged += third;
+
+    CheckCurve(merged, reference, weight, "the merged and reference curves differ", sample_count);
+
+    // the cleared accumulator forgets the samples of the previous stream
+    streamed.Clear();
+
+    Check(streamed.GetSampleCount() == 0 && streamed.GetSkippedSampleCount() == 0, "the accumulator is not cleared",
+          type, k, sample_count);
+
+    streamed.AddSamples(sample_count, u.data(), x.data());
+
+    CheckCurve(streamed, reference, weight, "the curve of the cleared accumulator differs", sample_count);
+
+    delete reference;
+}
+
+static GLvoid CheckControlPoints(IncrementalCurveRegressor &regressor, const vector<GLdouble> &u, const vector<DCoordinate3> &x,
+                                 const RowMatrix<GLdouble> &weight, const char *description)
+{
+    const KnotVector &knot_vector = regressor.GetAccumulator().GetKnotVector();
+
+    KnotVector::Type type = knot_vector.GetType();
+    GLuint           k    = knot_vector.GetOrder(), n = knot_vector.GetN();
+    GLuint           sample_count = static_cast<GLuint>(u.size());
+
+    Check(regressor.GetAccumulator().GetSampleCount() == sample_count, "the number of the samples differs", type, k, sample_count);
+
+    PointCloudAroundCurve3 cloud      = Cloud(u, x);
+    BSplineCurve3          *reference = cloud.GenerateRegressionCurve(type, k, n, weight, knot_vector.GetMin(),
+                                                                      knot_vector.GetMax(), 100);
+
+    ColumnMatrix<DCoordinate3> P;
+
+    Check(regressor.GetControlPoints(P), "the control points are not determined", type, k, sample_count);
+
+    if (reference && P.GetRowCount() == n + 1)
+    {
+        Check(RelativeDistance(P, *reference, n) < 1.0e-8, description, type, k, sample_count);
+    }
+
+    delete reference;
+}
+
+// insertions, removals and modifications of samples, the control points of which are refreshed after each change,
+// i.e., the banded factor is modified by rank-one updates and downdates (or it is rebuilt in case of periodic curves)
+static GLvoid CheckIncrementalRegressor(KnotVector::Type type, GLuint k, GLuint n, GLuint sample_count)
+{
+    GLdouble u_min = -1.0, u_max = 2.0;
+
+    vector<GLdouble>     u;
+    vector<DCoordinate3> x;
+
+    HelixSamples(sample_count, u_min, u_max, u, x);
+
+    RowMatrix<GLdouble> weight(2);
+    weight[0] = 1.0e-4;
+    weight[1] = 1.0e-6;
+
+    IncrementalCurveRegressor regressor(type, k, n, weight, u_min, u_max, 100);
+
+    ColumnMatrix<DCoordinate3> P;
+
+    // bulk insertion of the first half, single insertions of the rest
+    GLuint half = sample_count / 2;
+
+    Check(regressor.AddSamples(half, u.data(), x.data()), "the samples are not added", type, k, sample_count);
+
+    vector<GLdouble>     current_u(u.begin(), u.begin() + half);
+    vector<DCoordinate3> current_x(x.begin(), x.begin() + half);
+
+    CheckControlPoints(regressor, current_u, current_x, weight, "the curve of the bulk insertion differs");
+
+    for (GLuint s = half; s < sample_count; s++)
+    {
+        Check(regressor.AddSample(u[s], x[s]), "the sample is not added", type, k, sample_count);
+        Check(regressor.GetControlPoints(P), "the control points are not determined", type, k, sample_count);
+
+        current_u.push_back(u[s]);
+        current_x.push_back(x[s]);
+    }
+
+    Check(!regressor.AddSample(u_max + 1.0, x[0]) && !regressor.RemoveSample(u_min - 1.0, x[0]),
+          "a value outside the definition domain is accepted", type, k, sample_count);
+
+    CheckControlPoints(regressor, current_u, current_x, weight, "the curve of the insertions differs");
+
+    // every fifth sample is removed, every seventh one is moved and every eleventh one changes only its position
+    for (GLuint s = static_cast<GLuint>(current_u.size()); s-- > 0; )
+    {
+        if (s % 5 == 0)
+        {
+            Check(regressor.RemoveSample(current_u[s], current_x[s]), "the sample is not removed", type, k, sample_count);
+
+            current_u.erase(current_u.begin() + s);
+            current_x.erase(current_x.begin() + s);
+        }
+        else if (s % 7 == 0 || s % 11 == 0)
+        {
+            GLdouble     new_u = (s % 7 == 0) ? u_min + (u_max - u_min) * ((s * 0.618034) - floor(s * 0.618034)) : current_u[s];
+            DCoordinate3 new_x = current_x[s] + DCoordinate3(0.1, -0.2, 0.05);
+
+            Check(regressor.UpdateSample(current_u[s], current_x[s], new_u, new_x), "the sample is not updated",
+                  type, k, sample_count);
+
+            current_u[s] = new_u;
+            current_x[s] = new_x;
+        }
+        else
+        {
+            continue;
+        }
+
+        Check(regressor.GetControlPoints(P), "the control points are not determined", type, k, sample_count);
+    }
+
+    CheckControlPoints(regressor, current_u, current_x, weight, "the curve of the removals and updates differs");
+
+    // the factor is determined again from the accumulated sums
+    Check(regressor.Refactorize(), "the factor is not determined", type, k, sample_count);
+
+    CheckControlPoints(regressor, current_u, current_x, weight, "the curve of the new factor differs");
+
+    BSplineCurve3 *curve = regressor.GenerateRegressionCurve();
+
+    Check(curve != nullptr, "the incremental curve is not generated", type, k, sample_count);
+
+    if (curve && regressor.GetControlPoints(P))
+    {
+        Check(RelativeDistance(P, *curve, n) == 0.0, "the curve and the control points differ", type, k, sample_count);
+    }
+
+    delete curve;
+}
+
+int main()
+{
+    KnotVector::Type types[3] = {KnotVector::CLAMPED, KnotVector::UNCLAMPED, KnotVector::PERIODIC};
+
+    for (GLuint t = 0; t < 3; t++)
+    {
+        for (GLuint k = 1; k <= 8; k++)
+        {
+            // the larger sample set exceeds the chunks of the basis function evaluations of AddSamples
+            CheckAccumulators(types[t], k, k + 12, 500);
+            CheckAccumulators(types[t], k, k + 12, 10007);
+
+            // fewer samples than control points, i.e., only the energy terms make the normal equations regular
+            // (the derivatives of the B-spline functions of order 1 vanish)
+            if (k > 1)
+            {
+                CheckAccumulators(types[t], k, k + 12, 7);
+            }
+
+            CheckIncrementalRegressor(types[t], k, k + 12, 300);
+        }
+    }
+
+    if (failure_count)
+    {
+        cerr << failure_count << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "all checks passed" << endl;
+
+    return EXIT_SUCCESS;
+}
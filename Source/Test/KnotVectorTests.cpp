@@ -0,0 +1,734 @@
+#include "../B-spline/KnotVectors.h"
+#include "../Core/MatrixProducts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace cagd;
+
+// regression tests of the class KnotVector, the basis functions and the energy look-up tables are compared with
+// the Cox-de Boor recursion and its exact integration; a failing test is reported, while a regression of the
+// binary search of FindSpan typically manifests itself as a test program that does not terminate
+
+static GLuint failure_count = 0;
+
+static GLvoid Check(GLboolean condition, const char *description, GLdouble u)
+{
+    if (!condition)
+    {
+        cerr.precision(17);
+        cerr << "FAILED: " << description << " (u = " << u << ")" << endl;
+        failure_count++;
+    }
+}
+
+static GLvoid Check(GLboolean condition, const char *description, const KnotVector &knot_vector, GLuint r)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << description << " (type = " << knot_vector.GetType() << ", k = " << knot_vector.GetOrder()
+             << ", n = " << knot_vector.GetN() << ", r = " << r << ")" << endl;
+        failure_count++;
+    }
+}
+
+// the index of the last span of the definition domain
+static GLuint LastSpan(const KnotVector &knot_vector)
+{
+    return knot_vector.GetType() == KnotVector::PERIODIC ? knot_vector.GetN() + knot_vector.GetOrder() - 1
+                                                         : knot_vector.GetN();
+}
+
+// the span of u has to be one of the spans of the definition domain that contains u, where the values that
+// lie outside [u_{k-1}, u_{last + 1}) due to rounding errors belong to the first or last span
+static GLvoid CheckSpan(const KnotVector &knot_vector, GLdouble u)
+{
+    GLuint k    = knot_vector.GetOrder();
+    GLuint last = LastSpan(knot_vector);
+    GLuint i    = 0;
+
+    Check(knot_vector.FindSpan(u, i), "the value of the definition domain is not found", u);
+    Check(i >= k - 1 && i <= last, "the span lies outside the definition domain", u);
+
+    if (i < k - 1 || i > last)
+        return;
+
+    Check(u < knot_vector[i + 1] || i == last, "the value lies above the span", u);
+    Check(knot_vector[i] <= u || i == k - 1, "the value lies below the span", u);
+
+    TriangularMatrix<GLdouble> N;
+
+    Check(knot_vector.EvaluateNonZeroBSplineFunctions(u, i, N), "the basis functions are not evaluated", u);
+
+    GLdouble sum = 0.0;
+
+    for (GLuint j = 0; j < k; j++)
+    {
+        sum += N(k - 1, j);
+    }
+
+    Check(fabs(sum - 1.0) < 1.0e-12, "the basis functions do not form a partition of unity", u);
+}
+
+static GLvoid CheckDefinitionDomain(const KnotVector &knot_vector, GLuint sample_count)
+{
+    GLdouble u_min = knot_vector.GetMin(), u_max = knot_vector.GetMax();
+
+    for (GLuint s = 0; s <= sample_count; s++)
+    {
+        CheckSpan(knot_vector, u_min + (u_max - u_min) * s / sample_count);
+    }
+
+    // the knots themselves and their neighbouring values
+    for (GLuint r = knot_vector.GetOrder() - 1; r <= LastSpan(knot_vector) + 1; r++)
+    {
+        GLdouble knot = knot_vector[r];
+
+        GLdouble values[3] = {nextafter(knot, u_min), knot, nextafter(knot, u_max)};
+
+        for (GLuint j = 0; j < 3; j++)
+        {
+            if (values[j] >= u_min && values[j] <= u_max)
+            {
+                CheckSpan(knot_vector, values[j]);
+            }
+        }
+    }
+
+    GLuint i;
+
+    Check(!knot_vector.FindSpan(nextafter(u_min, u_min - 1.0), i), "a value below the definition domain is found", u_min);
+    Check(!knot_vector.FindSpan(nextafter(u_max, u_max + 1.0), i), "a value above the definition domain is found", u_max);
+}
+
+// the number of B-spline functions, the last k - 1 ones of periodic knot vectors coincide with the first ones
+static GLuint FunctionCount(const KnotVector &knot_vector)
+{
+    return knot_vector.GetType() == KnotVector::PERIODIC ? knot_vector.GetN() + knot_vector.GetOrder()
+                                                         : knot_vector.GetN() + 1;
+}
+
+// reference: the r-th derivative of N_{j}^{k}(u) by means of the Cox-de Boor recursion, where u is expected to lie
+// in the interior of a knot span
+static GLdouble CoxDeBoor(const KnotVector &knot_vector, GLuint j, GLuint k, GLuint r, GLdouble u)
+{
+    if (k == 1)
+    {
+        return (r == 0 && knot_vector[j] <= u && u < knot_vector[j + 1]) ? 1.0 : 0.0;
+    }
+
+    GLdouble left  = knot_vector[j + k - 1] - knot_vector[j];
+    GLdouble right = knot_vector[j + k] - knot_vector[j + 1];
+
+    GLdouble result = 0.0;
+
+    if (r == 0)
+    {
+        if (left > 0.0)
+            result += (u - knot_vector[j]) / left * CoxDeBoor(knot_vector, j, k - 1, 0, u);
+
+        if (right > 0.0)
+            result += (knot_vector[j + k] - u) / right * CoxDeBoor(knot_vector, j + 1, k - 1, 0, u);
+    }
+    else
+    {
+        if (left > 0.0)
+            result += (k - 1) / left * CoxDeBoor(knot_vector, j, k - 1, r - 1, u);
+
+        if (right > 0.0)
+            result -= (k - 1) / right * CoxDeBoor(knot_vector, j + 1, k - 1, r - 1, u);
+    }
+
+    return result;
+}
+
+// nodes and weights of the m-point Gauss-Legendre rule on [-1, 1] by Newton's method
+static GLvoid ReferenceGaussLegendreRule(GLuint m, vector<GLdouble> &nodes, vector<GLdouble> &weights)
+{
+    nodes.resize(m);
+    weights.resize(m);
+
+    for (GLuint g = 0; g < m; g++)
+    {
+        GLdouble x = cos(M_PI * (g + 0.75) / (m + 0.5)), derivative = 1.0;
+
+        for (GLuint iteration = 0; iteration < 100; iteration++)
+        {
+            // P_m(x) and its derivative by the three-term recurrence
+            GLdouble p0 = 1.0, p1 = x;
+            for (GLuint l = 2; l <= m; l++)
+            {
+                GLdouble p2 = ((2.0 * l - 1.0) * x * p1 - (l - 1.0) * p0) / l;
+                p0 = p1;
+                p1 = p2;
+            }
+
+            derivative = m * (x * p1 - p0) / (x * x - 1.0);
+
+            GLdouble step = p1 / derivative;
+            x -= step;
+
+            if (fabs(step) < 1.0e-16)
+                break;
+        }
+
+        nodes[g]   = x;
+        weights[g] = 2.0 / ((1.0 - x * x) * derivative * derivative);
+    }
+}
+
+// reference: the r-th table integrates d^r/du^r N_{i}^{k}(u) * d^r/du^r N_{j}^{k}(u) over the definition domain
+// with an 8-point Gauss-Legendre rule per knot span, which is exact for the integrands of degree at most 10
+static RealMatrix ReferenceLookUpTable(const KnotVector &knot_vector, GLuint r)
+{
+    GLuint k = knot_vector.GetOrder(), n = knot_vector.GetN(), count = FunctionCount(knot_vector);
+
+    vector<GLdouble> nodes, weights;
+    ReferenceGaussLegendreRule(8, nodes, weights);
+
+    RealMatrix table(n + 1, n + 1);
+
+    for (GLuint s = k - 1; s < count; s++)
+    {
+        GLdouble a = max(knot_vector[s], knot_vector.GetMin());
+        GLdouble b = min(knot_vector[s + 1], knot_vector.GetMax());
+
+        if (b <= a)
+            continue;
+
+        for (GLuint g = 0; g < nodes.size(); g++)
+        {
+            GLdouble u = 0.5 * (a + b) + 0.5 * (b - a) * nodes[g];
+            GLdouble w = 0.5 * (b - a) * weights[g];
+
+            for (GLuint i = s + 1 - k; i <= s; i++)
+            {
+                for (GLuint j = s + 1 - k; j <= s; j++)
+                {
+                    table(i % (n + 1), j % (n + 1)) += w * CoxDeBoor(knot_vector, i, k, r, u) * CoxDeBoor(knot_vector, j, k, r, u);
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+// the largest difference of the entries relative to the largest entry of the reference
+static GLdouble RelativeDifference(const RealMatrix &table, const RealMatrix &reference)
+{
+    GLdouble difference = 0.0, norm = 0.0;
+
+    for (GLuint i = 0; i < reference.GetRowCount(); i++)
+    {
+        for (GLuint j = 0; j < reference.GetColumnCount(); j++)
+        {
+            difference = max(difference, fabs(table(i, j) - reference(i, j)));
+            norm       = max(norm, fabs(reference(i, j)));
+        }
+    }
+
+    return norm > 0.0 ? difference / norm : difference;
+}
+
+// the banded Gauss-Legendre tables have to be exact, the entries outside their bands included, while the
+// composite Simpson rule only converges to them
+static GLvoid CheckLookUpTables(const KnotVector &knot_vector)
+{
+    GLuint k = knot_vector.GetOrder(), n = knot_vector.GetN();
+    GLuint maximum_order = k;
+
+    RowMatrix<BandedSPDMatrix*> tables  = knot_vector.GenerateAllLookUpTablesUpToADifferentiationOrder(maximum_order, 100);
+    RowMatrix<BandedSPDMatrix*> simpson = knot_vector.GenerateAllLookUpTablesUpToADifferentiationOrder(maximum_order, 2000,
+                                                                                                        KnotVector::COMPOSITE_SIMPSON);
+
+    RowMatrix<GLdouble> weight(maximum_order);
+    RealMatrix          weighted_reference(n + 1, n + 1);
+
+    for (GLuint r = 0; r <= maximum_order; r++)
+    {
+        RealMatrix reference = ReferenceLookUpTable(knot_vector, r);
+
+        Check(tables[r]->GetSize() == n + 1, "the look-up table has a wrong size", knot_vector, r);
+        Check(RelativeDifference(tables[r]->ToRealMatrix(), reference) < 1.0e-12,
+              "the Gauss-Legendre table differs from the exact integrals", knot_vector, r);
+
+        // the integrands of order k - 1 are piecewise constant and the Simpson rule cannot resolve their jumps
+        if (r + 1 < k)
+        {
+            Check(RelativeDifference(simpson[r]->ToRealMatrix(), reference) < 1.0e-3,
+                  "the Simpson table does not approximate the exact integrals", knot_vector, r);
+        }
+
+        if (r >= 1)
+        {
+            weight[r - 1] = pow(0.1, r);
+            weighted_reference.AddScaled(weight[r - 1], reference);
+        }
+
+        delete tables[r];
+        delete simpson[r];
+    }
+
+    Check(RelativeDifference(knot_vector.LookUpTableForCurveOptimizatioin(weight, 100).ToRealMatrix(), weighted_reference) < 1.0e-12,
+          "the weighted table of the curve regression differs from the exact integrals", knot_vector, maximum_order);
+}
+
+// samples of the definition domain that lie in the interior of the knot spans
+static GLvoid CheckBasisFunctions(const KnotVector &knot_vector)
+{
+    GLuint k = knot_vector.GetOrder(), count = FunctionCount(knot_vector);
+
+    for (GLuint s = 0; s <= 200; s++)
+    {
+        GLdouble u = knot_vector.GetMin() + (knot_vector.GetMax() - knot_vector.GetMin()) * (s + 0.37) / 201.0;
+
+        GLuint           i;
+        Matrix<GLdouble> dN;
+
+        Check(knot_vector.NonZeroDerivatives(k - 1, u, i, dN), "the non-vanishing derivatives are not evaluated", u);
+
+        if (dN.GetRowCount() != k || dN.GetColumnCount() != k)
+        {
+            Check(GL_FALSE, "the non-vanishing derivatives have a wrong size", u);
+            continue;
+        }
+
+        Matrix<GLdouble> all_dN;
+        Check(knot_vector.ZerothAndHigherOrderDerivative(k - 1, u, all_dN), "the derivatives are not evaluated", u);
+
+        GLdouble difference = 0.0;
+
+        for (GLuint r = 0; r < k; r++)
+        {
+            GLdouble scale = pow(knot_vector[i + 1] - knot_vector[i], r);
+
+            for (GLuint jj = 0; jj < k; jj++)
+            {
+                difference = max(difference, scale * fabs(dN(r, jj) - CoxDeBoor(knot_vector, i + 1 - k + jj, k, r, u)));
+            }
+
+            for (GLuint j = 0; j < count; j++)
+            {
+                GLdouble reference = (j + k > i && j <= i) ? CoxDeBoor(knot_vector, j, k, r, u) : 0.0;
+                difference = max(difference, scale * fabs(all_dN(r, j) - reference));
+            }
+        }
+
+        Check(difference < 1.0e-12, "the derivatives differ from the Cox-de Boor recursion", u);
+    }
+}
+
+// all levels of the Cox-de Boor triangle, evaluated by the fixed-order kernels (orders 2, ..., 6) or by the generic
+// code path, both into a triangular matrix and into a packed array
+static GLvoid CheckBasisTriangle(const KnotVector &knot_vector)
+{
+    GLuint k = knot_vector.GetOrder();
+
+    for (GLuint s = 0; s <= 200; s++)
+    {
+        GLdouble u = knot_vector.GetMin() + (knot_vector.GetMax() - knot_vector.GetMin()) * (s + 0.37) / 201.0;
+
+        GLuint                     i, packed_i;
+        TriangularMatrix<GLdouble> N;
+        vector<GLdouble>           packed_N(k * (k + 1) / 2);
+
+        Check(knot_vector.EvaluateNonZeroBSplineFunctions(u, i, N), "the basis functions are not evaluated", u);
+        Check(knot_vector.EvaluateNonZeroBSplineFunctions(u, packed_i, packed_N.data()),
+              "the packed basis functions are not evaluated", u);
+        Check(i == packed_i, "the spans of the triangular and packed evaluations differ", u);
+
+        GLdouble difference = 0.0;
+
+        for (GLuint row = 1; row <= k; row++)
+        {
+            for (GLuint column = 0; column < row; column++)
+            {
+                GLdouble reference = CoxDeBoor(knot_vector, i - row + column + 1, row, 0, u);
+
+                difference = max(difference, fabs(N(row - 1, column) - reference));
+                difference = max(difference, fabs(packed_N[(row - 1) * row / 2 + column] - reference));
+            }
+        }
+
+        Check(difference < 1.0e-14, "the basis functions differ from the Cox-de Boor recursion", u);
+    }
+}
+
+// the batch evaluation has to reproduce the span search and the last row of the Cox-de Boor triangle of the single
+// parameter values, both for sorted parameter values (walk along the knot vector) and for shuffled ones
+static GLvoid CheckBatch(const KnotVector &knot_vector)
+{
+    GLuint   k     = knot_vector.GetOrder();
+    GLdouble u_min = knot_vector.GetMin(), u_max = knot_vector.GetMax();
+
+    // values below the definition domain, repeated values, the knots and their neighbours, the ends of the definition
+    // domain and values above it
+    vector<GLdouble> u;
+
+    u.push_back(u_min - 1.0);
+    u.push_back(nextafter(u_min, u_min - 1.0));
+
+    for (GLuint s = 0; s <= 150; s++)
+    {
+        u.push_back(u_min + (u_max - u_min) * s / 150.0);
+    }
+
+    u.push_back(u_min + 0.5 * (u_max - u_min));
+
+    for (GLuint r = k - 1; r <= LastSpan(knot_vector) + 1; r++)
+    {
+        u.push_back(knot_vector[r]);
+        u.push_back(nextafter(knot_vector[r], u_min - 1.0));
+        u.push_back(nextafter(knot_vector[r], u_max + 1.0));
+    }
+
+    u.push_back(nextafter(u_max, u_max + 1.0));
+    u.push_back(u_max + 1.0);
+
+    // the last group of lanes is partial
+    if (u.size() % 8 == 0)
+    {
+        u.push_back(u_min + 0.25 * (u_max - u_min));
+    }
+
+    sort(u.begin(), u.end());
+
+    for (GLuint order = 0; order < 2; order++)
+    {
+        // the second pass evaluates the same values in a scrambled order
+        if (order == 1)
+        {
+            for (GLuint r = 0; r < u.size(); r++)
+            {
+                swap(u[r], u[(r * 7919) % u.size()]);
+            }
+        }
+
+        GLuint           count = static_cast<GLuint>(u.size());
+        vector<GLuint>   spans(count), derivative_spans(count);
+        vector<GLdouble> values(static_cast<size_t>(count) * k, -1.0);
+        vector<GLdouble> derivatives(static_cast<size_t>(count) * (k + 1) * k, -1.0);
+
+        GLboolean sorted     = order == 0 ? GL_TRUE : GL_FALSE;
+        GLboolean all_inside = GL_TRUE;
+        GLboolean result     = knot_vector.EvaluateNonZeroBSplineFunctions(count, u.data(), spans.data(), values.data(), sorted);
+
+        // the derivatives of order k vanish
+        GLboolean derivative_result = knot_vector.NonZeroDerivatives(k, count, u.data(), derivative_spans.data(),
+                                                                     derivatives.data(), sorted);
+
+        for (GLuint r = 0; r < count; r++)
+        {
+            GLuint                     i;
+            TriangularMatrix<GLdouble> N;
+
+            const GLdouble *derivatives_r = derivatives.data() + static_cast<size_t>(r) * (k + 1) * k;
+
+            if (!knot_vector.EvaluateNonZeroBSplineFunctions(u[r], i, N))
+            {
+                all_inside = GL_FALSE;
+
+                Check(spans[r] == KnotVector::INVALID_SPAN && derivative_spans[r] == KnotVector::INVALID_SPAN,
+                      "the value outside the definition domain has a span", u[r]);
+
+                for (GLuint jj = 0; jj < k; jj++)
+                {
+                    Check(values[r * k + jj] == 0.0, "the value outside the definition domain is not zero", u[r]);
+                }
+
+                for (GLuint jj = 0; jj < (k + 1) * k; jj++)
+                {
+                    Check(derivatives_r[jj] == 0.0, "the derivative outside the definition domain is not zero", u[r]);
+                }
+
+                continue;
+            }
+
+            Check(spans[r] == i && derivative_spans[r] == i, "the batch and single spans differ", u[r]);
+
+            GLdouble difference = 0.0;
+
+            for (GLuint jj = 0; jj < k; jj++)
+            {
+                difference = max(difference, fabs(values[r * k + jj] - N(k - 1, jj)));
+
+                // the half-open spans of the recursion do not contain the right end of the definition domain
+                if (u[r] < u_max)
+                {
+                    difference = max(difference, fabs(values[r * k + jj] - CoxDeBoor(knot_vector, i - k + 1 + jj, k, 0, u[r])));
+                }
+            }
+
+            Check(difference < 1.0e-14, "the batch values differ from the single ones", u[r]);
+
+            Matrix<GLdouble> dN;
+
+            Check(knot_vector.NonZeroDerivatives(k, u[r], i, dN), "the single derivatives are not evaluated", u[r]);
+
+            difference = 0.0;
+
+            // the high order derivatives of the clamped vectors with knots of multiplicity k - 1 are large, hence the
+            // differences are relative to them
+            for (GLuint d = 0; d <= k; d++)
+            {
+                GLdouble scale = pow(knot_vector[i + 1] - knot_vector[i], d);
+
+                for (GLuint jj = 0; jj < k; jj++)
+                {
+                    GLdouble derivative = derivatives_r[d * k + jj];
+
+                    difference = max(difference, scale * fabs(derivative - dN(d, jj)) / max(1.0, scale * fabs(dN(d, jj))));
+
+                    if (u[r] < u_max)
+                    {
+                        GLdouble reference = CoxDeBoor(knot_vector, i - k + 1 + jj, k, d, u[r]);
+
+                        difference = max(difference, scale * fabs(derivative - reference) / max(1.0, scale * fabs(reference)));
+                    }
+                }
+            }
+
+            Check(difference < 1.0e-12, "the batch derivatives differ from the single ones", u[r]);
+        }
+
+        Check(result == all_inside, "the batch evaluation does not report the values outside the definition domain", u_min);
+        Check(derivative_result == all_inside, "the batch derivatives do not report the values outside the definition domain", u_min);
+    }
+}
+
+// the compact derivatives of the orders 0, 1, ..., k + 1 (the last two vanish) at the knots, between them and at the ends
+// of the definition domain, a guard entry detects writes beyond the (k + 2) x k array; since the knots of multiplicity
+// k - 1 yield large derivatives, the differences are relative to the largest derivative of the same order
+static GLvoid CheckCompactDerivatives(const KnotVector &knot_vector)
+{
+    GLuint   k     = knot_vector.GetOrder();
+    GLdouble u_min = knot_vector.GetMin(), u_max = knot_vector.GetMax();
+
+    vector<GLdouble> u;
+
+    for (GLuint s = 0; s <= 100; s++)
+    {
+        u.push_back(u_min + (u_max - u_min) * s / 100.0);
+    }
+
+    for (GLuint r = k - 1; r <= knot_vector.GetN() + 1; r++)
+    {
+        u.push_back(knot_vector[r]);
+    }
+
+    const GLdouble guard = 12345.0;
+
+    for (GLuint s = 0; s < u.size(); s++)
+    {
+        GLuint           i, matrix_i;
+        vector<GLdouble> dN((k + 2) * k + 1, -1.0);
+        Matrix<GLdouble> matrix_dN;
+
+        dN.back() = guard;
+
+        if (!knot_vector.NonZeroDerivatives(k + 1, u[s], i, dN.data()))
+        {
+            Check(GL_FALSE, "the compact derivatives are not evaluated", u[s]);
+            continue;
+        }
+
+        Check(dN.back() == guard, "the compact derivatives are written beyond their array", u[s]);
+        Check(knot_vector.NonZeroDerivatives(k + 1, u[s], matrix_i, matrix_dN) && matrix_i == i,
+              "the compact and matrix spans differ", u[s]);
+
+        GLdouble difference = 0.0;
+
+        for (GLuint r = 0; r < k + 2; r++)
+        {
+            GLdouble scale = pow(knot_vector[i + 1] - knot_vector[i], r), norm = 1.0;
+
+            for (GLuint jj = 0; jj < k; jj++)
+            {
+                norm = max(norm, scale * fabs(matrix_dN(r, jj)));
+            }
+
+            for (GLuint jj = 0; jj < k; jj++)
+            {
+                GLdouble derivative = dN[r * k + jj];
+
+                difference = max(difference, scale * fabs(derivative - matrix_dN(r, jj)) / norm);
+
+                // the half-open spans of the Cox-de Boor recursion do not contain u_max
+                if (u[s] < u_max)
+                {
+                    difference = max(difference, scale * fabs(derivative - CoxDeBoor(knot_vector, i + 1 - k + jj, k, r, u[s])) / norm);
+                }
+            }
+        }
+
+        Check(difference < 1.0e-12, "the compact derivatives differ from the Cox-de Boor recursion", u[s]);
+    }
+
+    GLuint   i;
+    GLdouble dN[1] = {guard};
+
+    Check(!knot_vector.NonZeroDerivatives(0, u_min - 1.0, i, dN) && !knot_vector.NonZeroDerivatives(0, u_max + 1.0, i, dN),
+          "the compact derivatives are evaluated outside the definition domain", u_min);
+}
+
+// the batch evaluations are checked with every instruction set that the processor supports: complete groups of
+// valid parameter values are evaluated by the vectorised kernels, while partial groups and groups that contain
+// values outside the definition domain fall back to the scalar code path
+static GLvoid CheckBatchWithAllKernels(const KnotVector &knot_vector)
+{
+    MatrixProductKernel active_kernel = ActiveMatrixProductKernel();
+    MatrixProductKernel kernels[3]    = {SCALAR_MATRIX_PRODUCT_KERNEL, AVX2_MATRIX_PRODUCT_KERNEL, AVX512_MATRIX_PRODUCT_KERNEL};
+
+    for (GLuint kernel = 0; kernel < 3; kernel++)
+    {
+        if (SelectMatrixProductKernel(kernels[kernel]))
+        {
+            CheckBatch(knot_vector);
+        }
+    }
+
+    SelectMatrixProductKernel(active_kernel);
+}
+
+int main()
+{
+    KnotVector::Type types[3] = {KnotVector::CLAMPED, KnotVector::UNCLAMPED, KnotVector::PERIODIC};
+
+    for (GLuint t = 0; t < 3; t++)
+    {
+        for (GLuint k = 2; k <= 6; k++)
+        {
+            for (GLuint n = k; n <= k + 60; n += 3)
+            {
+                CheckDefinitionDomain(KnotVector(types[t], k, n, 0.0, 1.0), 97);
+                CheckDefinitionDomain(KnotVector(types[t], k, n, -1.0, 1.0), 97);
+                CheckDefinitionDomain(KnotVector(types[t], k, n, -2.5, 0.9), 97);
+            }
+        }
+    }
+
+    // the rounding errors of the equally spaced knots leave u_{n+1} = 1 - 2^{-53} slightly below u_max = 1,
+    // the binary search never terminated for the values of (u_{n+1}, u_max]
+    for (GLuint k = 2; k <= 5; k++)
+    {
+        KnotVector knot_vector(KnotVector::UNCLAMPED, k, k + 47, 0.0, 1.0);
+
+        Check(knot_vector[knot_vector.GetN() + 1] < knot_vector.GetMax(), "the test case does not reproduce u_{n+1} < u_max",
+              knot_vector[knot_vector.GetN() + 1]);
+
+        CheckSpan(knot_vector, knot_vector.GetMax());
+        CheckDefinitionDomain(knot_vector, 1000);
+    }
+
+    // if the knot u_{k-1} is modified slightly above u_min, the values of [u_min, u_{k-1}) belong to the first span
+    for (GLuint k = 2; k <= 5; k++)
+    {
+        KnotVector knot_vector(KnotVector::UNCLAMPED, k, k + 10, 0.0, 1.0);
+
+        knot_vector[k - 1] = nextafter(knot_vector.GetMin(), knot_vector.GetMax());
+
+        CheckSpan(knot_vector, knot_vector.GetMin());
+    }
+
+    // the fixed-order kernels, the generic code path of the higher orders and knots of multiplicity k - 1, evaluated
+    // both at single parameter values (basis functions and compact derivatives) and in batches
+    for (GLuint t = 0; t < 3; t++)
+    {
+        for (GLuint k = 2; k <= KnotVector::MAXIMUM_FIXED_ORDER + 2; k++)
+        {
+            KnotVector knot_vector(types[t], k, k + 9, -1.0, 2.0);
+
+            CheckBasisTriangle(knot_vector);
+            CheckCompactDerivatives(knot_vector);
+            CheckBatchWithAllKernels(knot_vector);
+
+            if (types[t] == KnotVector::CLAMPED)
+            {
+                for (GLuint r = k + 1; r < 2 * k - 1; r++)
+                {
+                    knot_vector[r] = knot_vector[k];
+                }
+
+                CheckBasisTriangle(knot_vector);
+                CheckCompactDerivatives(knot_vector);
+                CheckBatchWithAllKernels(knot_vector);
+            }
+        }
+    }
+
+    // FindSpan computes the spans of uniform knot vectors directly from the step of the knots, and the basis functions
+    // of the uniform spans are evaluated by means of the uniform basis matrices (up to order MAXIMUM_FIXED_ORDER);
+    // a single knot, displaced by means of the subscript operator, makes the spans that depend on it general, thus
+    // the lane groups of the batch evaluations mix uniform and general spans
+    for (GLuint t = 0; t < 3; t++)
+    {
+        for (GLuint k = 2; k <= KnotVector::MAXIMUM_FIXED_ORDER + 1; k++)
+        {
+            for (GLuint n = k + 1; n <= k + 37; n += 12)
+            {
+                KnotVector knot_vector(types[t], k, n, -1.0, 2.0);
+
+                CheckDefinitionDomain(knot_vector, 997);
+                CheckCompactDerivatives(knot_vector);
+                CheckBatchWithAllKernels(knot_vector);
+
+                GLuint m = (k + LastSpan(knot_vector)) / 2;
+
+                knot_vector[m] += 0.25 * (knot_vector[m + 1] - knot_vector[m]);
+
+                CheckDefinitionDomain(knot_vector, 997);
+                CheckBasisTriangle(knot_vector);
+                CheckCompactDerivatives(knot_vector);
+                CheckBatchWithAllKernels(knot_vector);
+            }
+        }
+
+        // the rounding errors of the quotients of long uniform knot vectors may shift the spans by one
+        for (GLuint k = 2; k <= 4; k++)
+        {
+            CheckDefinitionDomain(KnotVector(types[t], k, 3000, -1.0, 2.0), 100003);
+            CheckDefinitionDomain(KnotVector(types[t], k, 2047, 0.1, 0.7), 100003);
+        }
+    }
+
+    // non-uniform knot vectors are obtained by moving the interior knots of the definition domain
+    for (GLuint t = 0; t < 3; t++)
+    {
+        for (GLuint k = 2; k <= 6; k++)
+        {
+            for (GLuint n = k; n <= k + 12; n += 4)
+            {
+                KnotVector knot_vector(types[t], k, n, -1.0, 2.0);
+
+                CheckBasisFunctions(knot_vector);
+                CheckLookUpTables(knot_vector);
+
+                if (types[t] != KnotVector::PERIODIC)
+                {
+                    for (GLuint r = k; r <= n; r++)
+                    {
+                        knot_vector[r] += 0.3 * (knot_vector[r + 1] - knot_vector[r]) * sin(3.0 * r);
+                    }
+
+                    CheckBasisFunctions(knot_vector);
+                    CheckLookUpTables(knot_vector);
+                }
+            }
+        }
+    }
+
+    if (failure_count)
+    {
+        cerr << failure_count << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "all checks passed" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+# Console regression tests of the class KnotVector, 'make check' builds and runs them.
+QT       += core gui
+
+CONFIG   += console testcase
+CONFIG   -= app_bundle
+
+TEMPLATE  = app
+TARGET    = KnotVectorTests
+
+# We assume that the compiler is compatible with the C++ 11 standard.
+# The widgets are needed by the message boxes of Core/Exceptions.h.
+greaterThan(QT_MAJOR_VERSION, 4){
+    CONFIG         += c++11
+    QT             += widgets
+} else {
+    QMAKE_CXXFLAGS += -std=c++0x
+}
+
+INCLUDEPATH += $$PWD/..
+
+win32 {
+    INCLUDEPATH += $$PWD/../Dependencies/Include
+    DEPENDPATH += $$PWD/../Dependencies/Include
+
+    msvc {
+      QMAKE_CXXFLAGS += -openmp  -arch:AVX -D "_CRT_SECURE_NO_WARNINGS"
+    }
+}
+
+mac {
+    # IMPORTANT: change the letters x, y, z to the version number of the GLEW library (see RegressionBSplineCurvesAndSurfaces.pro)
+    INCLUDEPATH += "/usr/local/Cellar/glew/x.y.z/include/"
+}
+
+HEADERS += \
+    ../B-spline/EnergyLookUpTableCaches.h \
+    ../B-spline/KnotVectors.h \
+    ../Core/BandedSPDMatrices.h \
+    ../Core/CollocationMatrices.h \
+    ../Core/LUFactorizations.h \
+    ../Core/Matrices.h \
+    ../Core/MatrixProducts.h \
+    ../Core/ParallelExecutionPolicies.h \
+    ../Core/RealMatrices.h
+
+SOURCES += \
+    ../B-spline/EnergyLookUpTableCaches.cpp \
+    ../B-spline/KnotVectors.cpp \
+    ../Core/BandedSPDMatrices.cpp \
+    ../Core/CollocationMatrices.cpp \
+    ../Core/LUFactorizations.cpp \
+    ../Core/MatrixProducts.cpp \
+    ../Core/ParallelExecutionPolicies.cpp \
+    ../Core/RealMatrices.cpp \
+    KnotVectorTests.cpp
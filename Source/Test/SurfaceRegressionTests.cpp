@@ -0,0 +1,157 @@
+#include "../PointCloud/PointCloudAroundSurface3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace std;
+using namespace cagd;
+
+// regression tests of PointCloudAroundSurface3::GenerateRegressionSurface, the control nets of the direct
+// (Kronecker product) mode, of the matrix-free iterative mode and of the dense LU fallback have to agree
+
+static GLuint failure_count = 0;
+
+static GLvoid Check(GLboolean condition, const char *description, GLuint u_type, GLuint v_type, GLuint term_count)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << description << " (u type = " << u_type << ", v type = " << v_type
+             << ", energy terms = " << term_count << ")" << endl;
+        failure_count++;
+    }
+}
+
+// noisy samples of a torus over a grid of parameter values of [0, 2 pi] x [0, 2 pi]
+static PointCloudAroundSurface3 GridCloud(GLuint u_sample_count, GLuint v_sample_count)
+{
+    mt19937 generator(20241017);
+    normal_distribution<GLdouble> noise(0.0, 0.02);
+
+    ostringstream os;
+    os.precision(17);
+    os << u_sample_count << " " << v_sample_count << "\n";
+
+    for (GLuint i = 0; i < u_sample_count; i++)
+    {
+        for (GLuint j = 0; j < v_sample_count; j++)
+        {
+            GLdouble u = 2.0 * M_PI * (i + 0.5) / u_sample_count;
+            GLdouble v = 2.0 * M_PI * (j + 0.3) / v_sample_count;
+
+            os << u << " " << v << " "
+               << (2.0 + cos(v)) * cos(u) + noise(generator) << " "
+               << (2.0 + cos(v)) * sin(u) + noise(generator) << " "
+               << sin(v) + noise(generator) << "\n";
+        }
+    }
+
+    PointCloudAroundSurface3 cloud;
+
+    istringstream is(os.str());
+    is >> cloud;
+
+    return cloud;
+}
+
+// the largest distance of the corresponding control points relative to the largest control point
+static GLdouble RelativeDistance(const BSplinePatch3 &lhs, const BSplinePatch3 &rhs, GLuint u_n, GLuint v_n)
+{
+    GLdouble distance = 0.0, norm = 0.0;
+
+    for (GLuint i = 0; i <= u_n; i++)
+    {
+        for (GLuint j = 0; j <= v_n; j++)
+        {
+            distance = max(distance, (lhs(i, j) - rhs(i, j)).length());
+            norm     = max(norm, rhs(i, j).length());
+        }
+    }
+
+    return distance / norm;
+}
+
+// the control nets have to agree up to the given relative distance, which depends on the condition number of
+// the normal equations
+static GLvoid CheckSolvers(const PointCloudAroundSurface3 &cloud, KnotVector::Type u_type, KnotVector::Type v_type,
+                           GLuint u_n, GLuint v_n, GLuint term_count, GLdouble relative_distance)
+{
+    RowMatrix<GLdouble> weight(term_count);
+    for (GLuint r = 0; r < term_count; r++)
+    {
+        weight[r] = 1.0e-3 / pow(10.0, r);
+    }
+
+    GLuint u_k = 4, v_k = 3;
+
+    // separate copies, such that every solver starts from scratch
+    PointCloudAroundSurface3 direct_cloud(cloud), iterative_cloud(cloud), dense_cloud(cloud);
+
+    // the iterations are not preconditioned if F'F or G'G is singular, therefore the default cap of
+    // (u_n + 1) * (v_n + 1) iterations is raised
+    PointCloudAroundSurface3::IterativeSolverSettings iterative_solver(1.0e-13, 1000);
+    PointCloudAroundSurface3::IterativeSolverReport   report;
+
+    // a single conjugate gradient iteration cannot satisfy a zero tolerance, i.e., the fallback is forced
+    PointCloudAroundSurface3::KroneckerSolverSettings dense_fallback(0.0, 1);
+
+    BSplinePatch3 *direct    = direct_cloud.GenerateRegressionSurface(weight, u_type, v_type, u_k, v_k, u_n, v_n,
+                                                                      0.0, 2.0 * M_PI, 0.0, 2.0 * M_PI, 100);
+    BSplinePatch3 *iterative = iterative_cloud.GenerateRegressionSurface(weight, u_type, v_type, u_k, v_k, u_n, v_n,
+                                                                         0.0, 2.0 * M_PI, 0.0, 2.0 * M_PI, 100,
+                                                                         &iterative_solver, &report);
+    BSplinePatch3 *dense     = dense_cloud.GenerateRegressionSurface(weight, u_type, v_type, u_k, v_k, u_n, v_n,
+                                                                     0.0, 2.0 * M_PI, 0.0, 2.0 * M_PI, 100,
+                                                                     nullptr, nullptr, &dense_fallback);
+
+    Check(direct && iterative && dense, "the surface is not generated", u_type, v_type, term_count);
+
+    if (direct && iterative && dense)
+    {
+        Check(report.converged, "the iterative mode does not converge", u_type, v_type, term_count);
+        Check(RelativeDistance(*direct, *dense, u_n, v_n) < relative_distance, "the direct and dense solutions differ",
+              u_type, v_type, term_count);
+        Check(RelativeDistance(*iterative, *dense, u_n, v_n) < relative_distance, "the iterative and dense solutions differ",
+              u_type, v_type, term_count);
+    }
+
+    delete direct;
+    delete iterative;
+    delete dense;
+}
+
+int main()
+{
+    KnotVector::Type types[3] = {KnotVector::CLAMPED, KnotVector::UNCLAMPED, KnotVector::PERIODIC};
+
+    PointCloudAroundSurface3 cloud = GridCloud(30, 25);
+
+    // fewer u parameter values than control points, i.e., F'F is singular and only the energy terms
+    // make the normal equations regular
+    PointCloudAroundSurface3 sparse_cloud = GridCloud(5, 25);
+
+    for (GLuint u = 0; u < 3; u++)
+    {
+        for (GLuint v = 0; v < 3; v++)
+        {
+            for (GLuint term_count = 1; term_count <= 2; term_count++)
+            {
+                CheckSolvers(cloud, types[u], types[v], 9, 6, term_count, 1.0e-9);
+                CheckSolvers(sparse_cloud, types[u], types[v], 9, 6, term_count, 1.0e-7);
+            }
+        }
+    }
+
+    if (failure_count)
+    {
+        cerr << failure_count << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "all checks passed" << endl;
+
+    return EXIT_SUCCESS;
+}
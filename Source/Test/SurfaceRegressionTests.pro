@@ -0,0 +1,102 @@
+# Console regression tests of the surface regression solvers, 'make check' builds and runs them.
+QT       += core gui
+
+CONFIG   += console testcase
+CONFIG   -= app_bundle
+
+TEMPLATE  = app
+TARGET    = SurfaceRegressionTests
+
+# We assume that the compiler is compatible with the C++ 11 standard.
+# The widgets are needed by the message boxes of Core/Exceptions.h.
+greaterThan(QT_MAJOR_VERSION, 4){
+    CONFIG         += c++11
+    QT             += widgets
+} else {
+    QMAKE_CXXFLAGS += -std=c++0x
+}
+
+INCLUDEPATH += $$PWD/..
+
+win32 {
+    INCLUDEPATH += $$PWD/../Dependencies/Include
+    DEPENDPATH += $$PWD/../Dependencies/Include
+
+    LIBS += -lopengl32 -lglu32
+
+    contains(QT_ARCH, i386) {
+        LIBS += -L"$$PWD/../Dependencies/Lib/GL/x86/" -lglew32
+    } else {
+        LIBS += -L"$$PWD/../Dependencies/Lib/GL/x64/" -lglew32
+    }
+
+    msvc {
+      QMAKE_CXXFLAGS += -openmp  -arch:AVX -D "_CRT_SECURE_NO_WARNINGS"
+    }
+}
+
+unix: !mac {
+    LIBS += -lGLEW -lGLU
+}
+
+mac {
+    # IMPORTANT: change the letters x, y, z to the version number of the GLEW library (see RegressionBSplineCurvesAndSurfaces.pro)
+    INCLUDEPATH += "/usr/local/Cellar/glew/x.y.z/include/"
+    LIBS += -L"/usr/local/Cellar/glew/x.y.z/lib/" -lGLEW
+    LIBS += -framework OpenGL
+}
+
+HEADERS += \
+    ../B-spline/BSplineCurves3.h \
+    ../B-spline/BSplinePatches3.h \
+    ../B-spline/EnergyLookUpTableCaches.h \
+    ../B-spline/KnotVectors.h \
+    ../Core/BandedSPDMatrices.h \
+    ../Core/CollocationMatrices.h \
+    ../Core/Colors4.h \
+    ../Core/Constants.h \
+    ../Core/DCoordinates3.h \
+    ../Core/Exceptions.h \
+    ../Core/GenericCurves3.h \
+    ../Core/HCoordinates3.h \
+    ../Core/IterativeRefinements.h \
+    ../Core/KroneckerProductSums.h \
+    ../Core/LUFactorizations.h \
+    ../Core/LinearCombination3.h \
+    ../Core/Materials.h \
+    ../Core/Matrices.h \
+    ../Core/MatrixProducts.h \
+    ../Core/ParallelExecutionPolicies.h \
+    ../Core/RealMatrices.h \
+    ../Core/RealSquareMatrices.h \
+    ../Core/TCoordinates4.h \
+    ../Core/TensorProductSurfaces3.h \
+    ../Core/TriangularFaces.h \
+    ../Core/TriangulatedMeshes3.h \
+    ../Parametric/ParametricSurfaces3.h \
+    ../PointCloud/PointCloudAroundSurface3.h \
+    ../RandomNumberGenerator/NormalRNG.h \
+    ../RandomNumberGenerator/RandomNumberGenerator.h
+
+SOURCES += \
+    ../B-spline/BSplineCurves3.cpp \
+    ../B-spline/BSplinePatches3.cpp \
+    ../B-spline/EnergyLookUpTableCaches.cpp \
+    ../B-spline/KnotVectors.cpp \
+    ../Core/BandedSPDMatrices.cpp \
+    ../Core/CollocationMatrices.cpp \
+    ../Core/GenericCurves3.cpp \
+    ../Core/KroneckerProductSums.cpp \
+    ../Core/LUFactorizations.cpp \
+    ../Core/LinearCombination3.cpp \
+    ../Core/Materials.cpp \
+    ../Core/MatrixProducts.cpp \
+    ../Core/ParallelExecutionPolicies.cpp \
+    ../Core/RealMatrices.cpp \
+    ../Core/RealSquareMatrices.cpp \
+    ../Core/TensorProductSurfaces3.cpp \
+    ../Core/TriangulatedMeshes3.cpp \
+    ../Parametric/ParametricSurfaces3.cpp \
+    ../PointCloud/PointCloudAroundSurface3.cpp \
+    ../RandomNumberGenerator/NormalRNG.cpp \
+    SurfaceRegressionTests.cpp
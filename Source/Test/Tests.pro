@@ -0,0 +1,8 @@
+# The console regression tests of the library, 'make check' builds and runs all of them.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    BandedSPDMatrixTests.pro \
+    CurveRegressionTests.pro \
+    KnotVectorTests.pro \
+    SurfaceRegressionTests.pro